@@ -0,0 +1,87 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_BOOTPROFILER
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_BOOTPROFILER
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+
+// espidf includes
+#include <esp_timer.h>
+
+// freeRTOS includes
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <freertos/task.h>
+
+/* --- Defines & Macros --- */
+
+// Phases of one boot, every phase is a bit of the event group
+#define BOOT_PROFILER_MAX_PHASES 16
+
+// Milestones after the phases, e.g. the first frame on the displays
+#define BOOT_PROFILER_MAX_MARKS 4
+
+// Dependency mask of a phase, by its index in the table
+#define BOOT_PHASE(index) (1UL << (index))
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief Initializes a subsystem
+//! \retval Boolean indicating if it worked
+typedef bool (*BootPhaseFunction)(void);
+
+//! \brief A phase of the boot. It runs on its own task as soon as its dependencies are done
+typedef struct {
+    const char *name;
+    BootPhaseFunction function;
+    uint32_t dependencies;// BOOT_PHASE() of the phases it waits for, only earlier ones of the table
+    BaseType_t core;      // The core it runs on
+    uint32_t stackSize;   // Of its task [in bytes]
+    bool critical;        // If it fails, every phase depending on it is skipped
+} BootPhase;
+
+//! \brief How a phase ended
+typedef enum {
+    BOOT_PHASE_PENDING,
+    BOOT_PHASE_SUCCEEDED,
+    BOOT_PHASE_FAILED,
+    BOOT_PHASE_SKIPPED,// A critical dependency failed or was skipped
+} BOOT_PHASE_RESULT;
+
+//! \brief Timing of a phase [esp_timer time in us, it starts right after the key-on]
+typedef struct {
+    int64_t startUs;// Its task started
+    int64_t readyUs;// Its dependencies were done
+    int64_t endUs;  // It was done
+    BaseType_t core;
+    BOOT_PHASE_RESULT result;
+} BootPhaseTiming;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Runs every phase and returns once all of them are done
+//! \param phases The phases, ordered so every phase only depends on earlier ones
+//! \param count The number of phases
+//! \retval Boolean indicating if no critical phase failed and none was skipped
+bool bootProfilerRun(const BootPhase *phases, int count);
+
+//! \brief Returns the timing of a phase of the last run
+//! \param phase The index of the phase
+//! \param timing Where the timing is written to
+//! \retval Boolean indicating if there is such a phase
+bool bootProfilerGetTiming(int phase, BootPhaseTiming *timing);
+
+//! \brief Records and logs a milestone after the phases, only the first BOOT_PROFILER_MAX_MARKS are kept
+//! \param name Printable name, it isn't copied
+void bootProfilerMark(const char *name);
+
+//! \brief Writes the timing of every phase and the critical path to the log
+void bootProfilerDump(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_BOOTPROFILER
@@ -4,30 +4,85 @@
 /* --- Includes --- */
 
 // Project includes
+#include "Core/RateController.h"
+#include "Core/Scheduler.h"
+#include "Core/ThermalGovernor.h"
+#include "EventBus/EventBus.h"
 #include "GUI/GUI.h"
+#include "LatencyTracer/LatencyTracer.h"
 #include "Logger/Logger.h"
+#include "SensorManager/SensorHalHardware.h"
 #include "SensorManager/SensorManager.h"
+#include "Settings/Settings.h"
+#include "SystemMonitor/SystemMonitor.h"
+#include "Telemetry/Telemetry.h"
 
 // C includes
 #include <stdbool.h>
 
 /* --- Defines & Macros --- */
 
-// UPDATE INTERVALS
-#define OIL_PRESSURE_UPDATE_INTERVAL_MS 10 * 1000       // 10s
-#define FUEL_LEVEL_UPDATE_INTERVAL_MS 250               //12 * 1000// 120s
-#define WATER_TEMPERATURE_UPDATE_INTERVAL_MS 5 * 1000   // 5s
-#define INTERNAL_TEMPERATURE_UPDATE_INTERVAL_MS 5 * 1000// 5s
-#define SPEED_UPDATE_INTERVAL_MS 250                    // 0.25s
-#define RPM_UPDATE_INTERVAL_MS 250                      // 0.25s
-
-// TASK PRIORITIES
-#define OIL_PRESSURE_PRIORITY_LEVEL 0
-#define FUEL_LEVEL_PRIORITY_LEVEL 2
-#define WATER_TEMPERATURE_PRIORITY_LEVEL 1
-#define INTERNAL_TEMPERATURE_PRIORITY_LEVEL 2
+// The intervals and priorities below are the defaults of the settings, see Settings.h
+
+// UPDATE INTERVALS: The rate controller samples faster while the value changes by at least
+// CHANGE_PER_S per second and backs off to MAX_MS while it is steady
+#define OIL_PRESSURE_UPDATE_INTERVAL_MIN_MS 1000             // 1s
+#define OIL_PRESSURE_UPDATE_INTERVAL_MAX_MS 10 * 1000        // 10s
+#define OIL_PRESSURE_CHANGE_PER_S 1                          // Every flip
+#define FUEL_LEVEL_UPDATE_INTERVAL_MIN_MS 250                // 0.25s
+#define FUEL_LEVEL_UPDATE_INTERVAL_MAX_MS 12 * 1000          // 12s
+#define FUEL_LEVEL_CHANGE_PER_S 1                            // 1%/s
+#define WATER_TEMPERATURE_UPDATE_INTERVAL_MIN_MS 1000        // 1s
+#define WATER_TEMPERATURE_UPDATE_INTERVAL_MAX_MS 10 * 1000   // 10s
+#define WATER_TEMPERATURE_CHANGE_PER_S 5                     // 0.5 Celsius/s
+#define INTERNAL_TEMPERATURE_UPDATE_INTERVAL_MIN_MS 5 * 1000 // 5s
+#define INTERNAL_TEMPERATURE_UPDATE_INTERVAL_MAX_MS 30 * 1000// 30s
+#define INTERNAL_TEMPERATURE_CHANGE_PER_S 5                  // 0.5 Celsius/s
+#define SPEED_UPDATE_INTERVAL_MIN_MS 100                     // 0.1s
+#define SPEED_UPDATE_INTERVAL_MAX_MS 1000                    // 1s
+#define SPEED_CHANGE_PER_S 3                                 // 3km/h/s
+#define RPM_UPDATE_INTERVAL_MIN_MS 100                       // 0.1s
+#define RPM_UPDATE_INTERVAL_MAX_MS 500                       // 0.5s
+#define RPM_CHANGE_PER_S 200                                 // 200rpm/s
+#define SHIFT_LIGHT_UPDATE_INTERVAL_MS 10                    // 0.01s
+#define SYSTEM_MONITOR_SAMPLE_INTERVAL_MS 10 * 1000          // 10s
+#define STATISTICS_DUMP_INTERVAL_MS 60 * 1000                // 60s
+
+// JOB PHASES: Delay of the first run, spreads the jobs with the same interval
+#define ADC_ACQUISITION_PHASE_MS 5// Between two ADC channels
+#define SPEED_PHASE_MS 0
+#define RPM_PHASE_MS 50// Half of the fastest interval after the speed
+
+// JOB PRIORITIES: Which of the due jobs runs first on the scheduler task
+#define ADC_ACQUISITION_PRIORITY_LEVEL 2// Oil pressure, fuel level, water and internal temperature
 #define SPEED_PRIORITY_LEVEL 0
 #define RPM_PRIORITY_LEVEL 0
+#define SHIFT_LIGHT_PRIORITY_LEVEL 3// Short, but has to keep up with the engine
+#define SYSTEM_MONITOR_PRIORITY_LEVEL 0
+
+// EVENT BUS QUEUES: The displays only need the latest value of every sensor, the log and the telemetry need every sample
+#define DISPLAY_QUEUE_LENGTH 16// At least one slot per displayed sensor, so nothing but stale values is dropped
+#define LOGGING_QUEUE_LENGTH 32
+#define TELEMETRY_QUEUE_LENGTH 32// Several frames, a frame is sent at least every TELEMETRY_FLUSH_INTERVAL_MS
+
+// TASK PLACEMENT: The sensors are acquired on one core, everything that outputs them on the other. The
+// interrupts of the sensors and the CAN bus run on the core their driver was installed from, see main.c
+#define ACQUISITION_CORE 1  // Scheduler, CAN bus and digital inputs
+#define OUTPUT_CORE GUI_CORE// LVGL, the flushing, the log and the telemetry
+
+// TASK PRIORITIES: Acquisition always preempts the output, nothing runs at the priority of the idle task
+#define SCHEDULER_PRIORITY_LEVEL 6      // Runs every job above
+#define CAN_RECEIVE_PRIORITY_LEVEL 5    // Decodes the frames, the controller only buffers CAN_TWAI_RX_QUEUE_LENGTH of them
+#define DIGITAL_INPUTS_PRIORITY_LEVEL 5 // Sleeps until an input changes
+#define SAMPLE_DELIVERY_PRIORITY_LEVEL 4// Hands the samples to the displays, above GUI_LVGL_PRIORITY_LEVEL so they make the next frame
+#define TELEMETRY_PRIORITY_LEVEL 2      // Streams the samples over USB
+#define SAMPLE_LOGGING_PRIORITY_LEVEL 1 // Writes the samples to the log
+#define STATISTICS_DUMP_PRIORITY_LEVEL 1
+#define SETTINGS_CONSOLE_PRIORITY_LEVEL 1// Reads the settings the host sends
+
+// CONSOLE: "trim <analog input> <gain> <offset mV>" stores the board trims of an input, see SENSOR_HAL_ADC
+// and sensorHalHardwareSetTrim()
+#define CORE_TRIM_COMMAND "trim "
 
 /* --- Variables, Typedefs etc. --- */
 
@@ -39,4 +94,9 @@
 //! \retval bool Indicating if everything worked
 bool coreInit(void);
 
+//! \brief Tests that a setting changed by a console command reaches the scheduler, then restores it. Run
+//! it with the console command "test"
+//! \retval Boolean indicating if the test passed
+bool core_test(void);
+
 #endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_CORE
@@ -0,0 +1,60 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_RATECONTROLLER
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_RATECONTROLLER
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+#include "SensorManager/SensorManager.h"
+
+/* --- Defines & Macros --- */
+
+// How many samples in a row have to be steady before the interval is backed off
+#define RATE_CONTROLLER_STEADY_SAMPLES 4
+
+// Weight of a new period in the average of the effective rate, 1 / 2^SHIFT
+#define RATE_CONTROLLER_AVERAGE_SHIFT 3
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief The limits a channel is sampled within
+typedef struct {
+    uint32_t minIntervalMs;// Fastest the channel is sampled
+    uint32_t maxIntervalMs;// Slowest the channel is sampled
+    int32_t changePerSecond;// A change of at least this much per second [in the unit of the sensor] counts as fast
+} RateControllerLimits;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Configures a channel, it starts at its fastest interval
+//! \param sensorType The sensor of the channel
+//! \param limits The limits of the channel
+//! \retval Boolean indicating if the limits were valid
+bool rateControllerConfigure(SENSOR sensorType, const RateControllerLimits *limits);
+
+//! \brief Feeds the newest value of a channel and calculates the next interval. The interval is halved if the value
+//! changes quickly and grows by half once it was steady for RATE_CONTROLLER_STEADY_SAMPLES samples
+//! \param sensorType The sensor of the channel
+//! \param value The newest value
+//! \retval The interval until the next sample [in Milliseconds]
+uint32_t rateControllerFeed(SENSOR sensorType, int32_t value);
+
+//! \brief Returns the current interval of a channel
+//! \param sensorType The sensor of the channel
+//! \retval The interval [in Milliseconds] or 0 if the channel isn't configured
+uint32_t rateControllerGetIntervalMs(SENSOR sensorType);
+
+//! \brief Returns the rate a channel was actually sampled with, averaged over the last samples
+//! \param sensorType The sensor of the channel
+//! \retval The rate [in Millihertz] or 0 if there are not enough samples yet
+int32_t rateControllerGetEffectiveRate(SENSOR sensorType);
+
+//! \brief Writes the interval and effective rate of every configured channel to the log
+void rateControllerDump(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_RATECONTROLLER
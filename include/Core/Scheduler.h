@@ -0,0 +1,103 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SCHEDULER
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SCHEDULER
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+
+// espidf includes
+#include <esp_timer.h>
+
+// freeRTOS includes
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/* --- Defines & Macros --- */
+
+// Size of the job table, a slot is free again once its job is removed
+#define SCHEDULER_MAX_JOBS 12
+
+// Stack of the scheduler task, every job runs on it
+#define SCHEDULER_TASK_STACK_SIZE 8192
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief A periodic job. It must not block, every other job waits for it
+//! \param context The context it was added with
+//! \retval The time until it runs again [in Milliseconds], 0 keeps the period it was added with
+typedef uint32_t (*SchedulerJobFunction)(void *context);
+
+//! \brief Timing of a job. A run is released at its deadline and has to be done before the next release,
+//! otherwise the deadline counts as missed and the time it ran into the next period as overrun
+typedef struct {
+    uint32_t runs;           // How often it ran
+    uint32_t missedDeadlines;// Runs that weren't done before the next release
+    int64_t minLatenessUs;   // Jitter: how late a run started after its release
+    int64_t maxLatenessUs;
+    int64_t meanLatenessUs;
+    int64_t maxRunTimeUs;    // Longest run
+    int64_t maxOverrunUs;    // How far a run reached into the next period, only missed deadlines
+    int64_t sumOverrunUs;
+} SchedulerJobStats;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Starts the scheduler task. Jobs can be added before and after. The task is woken by an esp_timer
+//! at the deadline, so the jobs run with microsecond timing instead of on the next tick
+//! \param taskPriority The FreeRTOS priority of the task, every job runs with it
+//! \param core The core the task is pinned to
+//! \retval Boolean indicating if the task was created
+bool schedulerInit(UBaseType_t taskPriority, BaseType_t core);
+
+//! \brief Adds a periodic job. Of all due jobs the one with the highest priority runs first, jobs
+//! with the same priority run in the order of their deadlines
+//! \param name Printable name, it isn't copied
+//! \param function The job
+//! \param context Handed to the job on every run
+//! \param periodMs The period [in Milliseconds], at least 1
+//! \param phaseMs Delay of the first run [in Milliseconds], spreads jobs with the same period
+//! \param priority Higher runs first
+//! \retval The id of the job or -1 if the parameters are invalid or the table is full
+int schedulerAddJob(const char *name, SchedulerJobFunction function, void *context, uint32_t periodMs, uint32_t phaseMs, int priority);
+
+//! \brief Removes a job. If it is running right now, that run is finished
+//! \param jobId The id returned when it was added
+//! \retval Boolean indicating if there was such a job
+bool schedulerRemoveJob(int jobId);
+
+//! \brief Changes the priority of a job, it counts from the next pick on
+//! \param jobId The id returned when it was added
+//! \param priority Higher runs first
+//! \retval Boolean indicating if there is such a job
+bool schedulerSetJobPriority(int jobId, int priority);
+
+//! \brief Returns the priority of a job
+//! \param jobId The id returned when it was added
+//! \param priority Where the priority is written to
+//! \retval Boolean indicating if there is such a job
+bool schedulerGetJobPriority(int jobId, int *priority);
+
+//! \brief Changes the FreeRTOS priority of the scheduler task
+//! \param taskPriority The new priority
+//! \retval Boolean indicating if the task is running
+bool schedulerSetTaskPriority(UBaseType_t taskPriority);
+
+//! \brief Returns the timing of a job
+//! \param jobId The id returned when it was added
+//! \param stats Where the timing is written to
+//! \retval Boolean indicating if there is such a job
+bool schedulerGetStats(int jobId, SchedulerJobStats *stats);
+
+//! \brief Starts the timing of every job over
+void schedulerResetStats(void);
+
+//! \brief Writes the timing of every job to the log
+void schedulerDump(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SCHEDULER
@@ -0,0 +1,44 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_THERMALGOVERNOR
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_THERMALGOVERNOR
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Core/ThermalLevel.h"
+#include "GUI/GUI.h"
+#include "Logger/Logger.h"
+#include "SensorManager/SensorManager.h"
+#include "Settings/Settings.h"
+
+/* --- Defines & Macros --- */
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief What runs with which performance on a level. The configured settings are only capped by it
+typedef struct {
+    uint32_t lowPriorityRefreshMs;// Least refresh period of the temperature and fuel display
+    int spiSpeedHz;               // Highest SPI clock of the displays
+    int maxLoggingLevel;          // See LOGGING_LEVEL
+    int cpuFrequencyMHz;          // 80, 160 or 240
+} ThermalLevelConfig;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Feeds the board temperature and applies the new level if it changed
+//! \param sample Sample with the internal temperature in 0.1 degree Celsius
+//! \note Subscribed to the SensorManager
+void thermalGovernorSetTemperature(const SensorSample *sample);
+
+//! \brief Applies the current level again, e.g. after one of the settings it caps changed
+void thermalGovernorApply(void);
+
+//! \brief Returns the current level
+//! \retval The level
+THERMAL_LEVEL thermalGovernorGetLevel(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_THERMALGOVERNOR
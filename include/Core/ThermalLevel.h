@@ -0,0 +1,45 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_THERMALLEVEL
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_THERMALLEVEL
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+/* --- Defines & Macros --- */
+
+// Board temperatures [in 0.1 Celsius] a level is entered at
+#define THERMAL_LEVEL_WARM_DECI_CELSIUS 600
+#define THERMAL_LEVEL_HOT_DECI_CELSIUS 700
+#define THERMAL_LEVEL_CRITICAL_DECI_CELSIUS 800
+
+// A level is only left once the temperature is this much below where it was entered
+#define THERMAL_LEVEL_HYSTERESIS_DECI_CELSIUS 50
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief How much the workload is scaled back
+typedef enum {
+    THERMAL_LEVEL_NORMAL,
+    THERMAL_LEVEL_WARM,
+    THERMAL_LEVEL_HOT,
+    THERMAL_LEVEL_CRITICAL,
+    THERMAL_LEVEL_COUNT,
+} THERMAL_LEVEL;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Decides the level for a temperature. It moves by at most one level per call, so every
+//! transition is applied and logged on its own
+//! \param level The current level
+//! \param deciCelsius The board temperature [in 0.1 Celsius]
+//! \retval The new level
+THERMAL_LEVEL thermalLevelDecide(THERMAL_LEVEL level, int32_t deciCelsius);
+
+//! \brief Tests the level decisions with temperature ramps
+//! \retval Boolean indicating if they passed
+bool thermalLevel_test(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_THERMALLEVEL
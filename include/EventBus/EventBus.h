@@ -0,0 +1,83 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_EVENTBUS
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_EVENTBUS
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+#include "SensorManager/SensorManager.h"
+
+// freeRTOS includes
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/* --- Defines & Macros --- */
+#define EVENT_BUS_MAX_SUBSCRIBERS 8
+
+// Samples the queues of all subscribers share, every queue takes its length from it
+#define EVENT_BUS_POOL_LENGTH 96
+
+// How long a publisher waits for a EVENT_BUS_BLOCK queue before the sample is dropped anyway
+#define EVENT_BUS_BLOCK_TIMEOUT_MS 10
+
+// Topic masks, every sensor is a topic
+#define EVENT_BUS_TOPIC(sensor) (1UL << (sensor))
+#define EVENT_BUS_ALL_TOPICS ((1UL << SENSOR_COUNT) - 1)
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief What happens when a sample is published to a full queue
+typedef enum {
+    EVENT_BUS_DROP_OLDEST,// The oldest queued sample is dropped
+    EVENT_BUS_KEEP_LATEST,// A queued sample of the same sensor is replaced, otherwise like EVENT_BUS_DROP_OLDEST
+    EVENT_BUS_BLOCK,      // The publisher waits up to EVENT_BUS_BLOCK_TIMEOUT_MS, then the sample is dropped
+} EVENT_BUS_POLICY;
+
+//! \brief Counters of a subscriber. Every published sample ends up in exactly one of the counters,
+//! except the ones still queued
+typedef struct {
+    uint32_t delivered;// Samples the subscriber received
+    uint32_t replaced; // Queued samples replaced by a newer one of the same sensor (EVENT_BUS_KEEP_LATEST)
+    uint32_t dropped;  // Samples lost because the queue was full
+    uint16_t maxQueued;// Most samples that were waiting at once
+} EventBusStats;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Adds a subscriber with its own queue
+//! \param name Printable name, it isn't copied
+//! \param topics The sensors it receives, see EVENT_BUS_TOPIC()
+//! \param queueLength Length of its queue, taken from the pool
+//! \param policy What happens when its queue is full
+//! \retval The id of the subscriber or -1 if there is no room left
+//! \note Subscribe before the first sample is published
+int eventBusSubscribe(const char *name, uint32_t topics, int queueLength, EVENT_BUS_POLICY policy);
+
+//! \brief Puts a sample into the queue of every subscriber of its sensor. Only EVENT_BUS_BLOCK
+//! subscribers can make it wait
+//! \param sample The sample, it is copied
+//! \note Matches SensorSubscriber, so it can be subscribed to the SensorManager
+void eventBusPublish(const SensorSample *sample);
+
+//! \brief Takes the oldest sample from the queue of a subscriber
+//! \param subscriberId The id returned when it subscribed
+//! \param sample Where the sample is copied to
+//! \param timeout How long to wait for a sample [in ticks]
+//! \retval Boolean indicating if there was a sample
+bool eventBusReceive(int subscriberId, SensorSample *sample, TickType_t timeout);
+
+//! \brief Returns the counters of a subscriber
+//! \param subscriberId The id returned when it subscribed
+//! \param stats Where the counters are written to
+//! \retval Boolean indicating if there is such a subscriber
+bool eventBusGetStats(int subscriberId, EventBusStats *stats);
+
+//! \brief Writes the counters of every subscriber to the log
+void eventBusDump(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_EVENTBUS
@@ -25,6 +25,9 @@
 #define FILEMANAGER_GPIO_D2 GPIO_NUM_8  // The GPIO for the data2 line
 #define FILEMANAGER_GPIO_D3 GPIO_NUM_18 // The GPIO for the data3 line
 
+// Longest full path, including "/sdcard/" or "/spiffs/" and the terminator. It is built on the stack of the caller
+#define FILEMANAGER_MAX_PATH_LENGTH 128
+
 /* --- Variables, Typedefs etc. --- */
 enum {
     LOCATION_INTERNAL = 0,
@@ -38,6 +41,14 @@ enum {
 //! \retval Boolean indicating if it was successful or not
 bool fileManagerInit(void);
 
+//! \brief Mounts the SD Card. Part of fileManagerInit(), it may run in parallel to fileManagerMountSpiffs()
+//! \retval Boolean indicating if it is mounted
+bool fileManagerMountSdCard(void);
+
+//! \brief Mounts the internal spiffs partition. Part of fileManagerInit()
+//! \retval Boolean indicating if it is mounted
+bool fileManagerMountSpiffs(void);
+
 //! \brief Creates a new file at the specified location
 //! \param path The path of the file including the file name and extension without "/sdcard/" or "/spiffs/"
 //! \param location Where the file shall be created
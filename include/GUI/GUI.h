@@ -4,7 +4,11 @@
 /* --- Includes --- */
 
 // Project includes
+#include "BootProfiler/BootProfiler.h"
 #include "FileManager/FileManager.h"
+#include "LatencyTracer/LatencyTracer.h"
+#include "SensorManager/SensorManager.h"
+#include "Settings/Settings.h"
 
 // espidf includes
 #include "driver/gpio.h"
@@ -26,7 +30,18 @@
 #define GUI_LCD_RES 240
 #define GUI_LCD_Bits _PER_PIXEL(16)
 #define GUI_SPI_SPEED 60000000//10000000
-#define GUI_DELAY_BETWEEN_DRAWING_MS 1
+#define GUI_LVGL_TASK_PERIOD_MS 10
+#define GUI_LVGL_TASK_STACK_SIZE 10000// Every frame is rendered on it, the baseline renderer ran with this stack
+#define GUI_CORE 0               // Rendering and flushing, the sensors are acquired on the other core. See guiStart() before moving it
+#define GUI_LVGL_PRIORITY_LEVEL 3// Below every acquisition task, above the log and the telemetry
+#define GUI_FIRST_FRAME_PRIORITY_LEVEL 2
+#define GUI_SHIFT_LIGHT_WIDTH 120// Small, so switching it only redraws a small area
+#define GUI_SHIFT_LIGHT_HEIGHT 16
+#define GUI_SHIFT_LIGHT_COLOR 0xFF0000
+
+// The displays are switched on once they show their first frame, at the latest after the timeout
+#define GUI_FIRST_FRAME_POLL_INTERVAL_MS 10
+#define GUI_FIRST_FRAME_TIMEOUT_MS 1100
 
 #define GUI_GPIO_LCD1_CS GPIO_NUM_39
 #define GUI_GPIO_LCD2_CS GPIO_NUM_40
@@ -46,10 +61,33 @@
 //! \retval A boolean indicating if the init was successful
 bool guiInit(void);
 
+//! \brief Initializes the SPI bus and the panels. Part of guiInit(), it may run in parallel to guiInitScreens()
+//! \retval A boolean indicating if it was successful
+bool guiInitDisplays(void);
+
+//! \brief Initializes LVGL and builds the screens. Part of guiInit(), nothing is flushed yet
+//! \retval A boolean indicating if it was successful
+bool guiInitScreens(void);
+
+//! \brief Starts drawing to the displays. Part of guiInit(), call it once both steps above are done
+//! \retval A boolean indicating if it was successful
+bool guiStart(void);
+
 //! \brief De-Initializes the GUI system. Mainly used so clang does stop
 //! annoying with leaked memory.
 void guiDeInit(void);
 
+//! \brief Changes how often the temperature and fuel display is refreshed. The speed and rpm displays
+//! always keep the default LVGL refresh period
+//! \param periodMs The refresh period [in ms]
+void guiSetLowPriorityRefreshPeriod(uint32_t periodMs);
+
+//! \brief Changes the SPI clock of the displays. They are attached to the bus again with the new clock,
+//! but not reset, so they keep showing their content
+//! \param speedHz The clock [in Hz]
+//! \retval Boolean indicating if every display was attached again
+bool guiSetSpiSpeed(int speedHz);
+
 //! \brief Activates or disables the right blinker visually
 //! \param active If true the blinker is shown
 void guiSetRightBlinkerActive(const bool active);
@@ -58,34 +96,50 @@ void guiSetRightBlinkerActive(const bool active);
 //! \param active If true the blinker is shown
 void guiSetLeftBlinkerActive(const bool active);
 
+//! \brief Shows if the left blinker lamp is on
+//! \param sample Sample with the value 1 if the lamp is on, 0 if not
+//! \note Subscribed to the SensorManager
+void IRAM_ATTR guiSetLeftBlinker(const SensorSample *sample);
+
+//! \brief Shows if the right blinker lamp is on
+//! \param sample Sample with the value 1 if the lamp is on, 0 if not
+//! \note Subscribed to the SensorManager
+void IRAM_ATTR guiSetRightBlinker(const SensorSample *sample);
+
+//! \brief Switches the shift light on the rpm display. Unlike the labels it doesn't wait for the next
+//! LVGL refresh: it wakes the LVGL task, which redraws the area of the light right away
+//! \param sample Sample with the value 1 if the light is on, 0 if not
+//! \note Subscribed to the SensorManager directly, it runs on the publishing task and never calls LVGL
+void IRAM_ATTR guiSetShiftLight(const SensorSample *sample);
+
 //! \brief Updates the oil pressure
-//! \param pressure Boolean indicating if there is oil pressure or not
-//! \note Param is passed as void* as it's a cb function used by the SensorManager
-void IRAM_ATTR guiSetOilPressure(void *pressure);
+//! \param sample Sample with the value 1 if there is oil pressure, 0 if not
+//! \note Subscribed to the SensorManager
+void IRAM_ATTR guiSetOilPressure(const SensorSample *sample);
 
 //! \brief Updates the fuel level percentage
-//! \param percent 0 - 100 how much is the tank filled
-//! \note Param is passed as void* as it's a cb function used by the SensorManager
-void IRAM_ATTR guiSetFuelLevelPercent(void *percent);
+//! \param sample Sample with 0 - 100 how much is the tank filled
+//! \note Subscribed to the SensorManager
+void IRAM_ATTR guiSetFuelLevelPercent(const SensorSample *sample);
 
 //! \brief Updates the fuel level litres
-//! \param litres Float indicating how many litres there are left in the tank
-//! \note Param is passed as void* as it's a cb function used by the SensorManager
-void IRAM_ATTR guiSetFuelLevelLitre(void *litres);
+//! \param sample Sample with how many litres there are left in the tank
+//! \note Subscribed to the SensorManager
+void IRAM_ATTR guiSetFuelLevelLitre(const SensorSample *sample);
 
 //! \brief Updates the water temperature
-//! \param temp The temperature in Celsius as float
-//! \note Param is passed as void* as it's a cb function used by the SensorManager
-void IRAM_ATTR guiSetWaterTemperature(void *temp);
+//! \param sample Sample with the temperature in 0.1 degree Celsius
+//! \note Subscribed to the SensorManager
+void IRAM_ATTR guiSetWaterTemperature(const SensorSample *sample);
 
 //! \brief Updates the speed
-//! \param speed The speed as Integer
-//! \note Param is passed as void* as it's a cb function used by the SensorManager
-void IRAM_ATTR guiSetSpeed(void *speed);
+//! \param sample Sample with the speed in kmh
+//! \note Subscribed to the SensorManager
+void IRAM_ATTR guiSetSpeed(const SensorSample *sample);
 
 //! \brief Updates the RPM
-//! \param rpm The RPM as Integer
-//! \note Param is passed as void* as it's a cb function used by the SensorManager
-void IRAM_ATTR guiSetRpm(void *rpm);
+//! \param sample Sample with the RPM
+//! \note Subscribed to the SensorManager
+void IRAM_ATTR guiSetRpm(const SensorSample *sample);
 
 #endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_GUI
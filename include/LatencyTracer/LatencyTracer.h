@@ -0,0 +1,75 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_LATENCYTRACER
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_LATENCYTRACER
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+#include "SensorManager/SensorManager.h"
+
+// espidf includes
+#include <esp_timer.h>
+
+/* --- Defines & Macros --- */
+#define LATENCY_TRACER_MAX_DISPLAYS 3
+
+// Bucket i counts latencies in [2^(i + OFFSET), 2^(i + OFFSET + 1)) us. The first bucket also
+// contains everything below and the last one everything above -> 1ms ... 16s
+#define LATENCY_HISTOGRAM_BUCKETS 15
+#define LATENCY_HISTOGRAM_BUCKET_OFFSET 10
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief The points on the way from the sensor to the display a latency is measured to.
+//! Every latency starts at the capture timestamp of the sample
+typedef enum {
+    LATENCY_STAGE_PUBLISHED,// The GUI received the sample and updated its label
+    LATENCY_STAGE_RENDERED, // LVGL rendered the label and started flushing it
+    LATENCY_STAGE_FLUSHED,  // The SPI transfer of the last flushed area finished
+    LATENCY_STAGE_COUNT,
+} LATENCY_STAGE;
+
+//! \brief Latency histogram of one sensor and stage
+typedef struct {
+    uint32_t buckets[LATENCY_HISTOGRAM_BUCKETS];
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t sumUs;
+} LatencyHistogram;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Records that the GUI received a sample and put it into a label of the display
+//! \param sample The sample, its capture timestamp is the start of the trace
+//! \param display Index of the display the sample is shown on
+void latencyTracerMarkPublished(const SensorSample *sample, int display);
+
+//! \brief Records that LVGL rendered the display and started to flush it
+//! \param display Index of the display
+void latencyTracerMarkRendered(int display);
+
+//! \brief Records that the last flush of the display finished
+//! \param display Index of the display
+//! \note Can be called from an ISR
+void IRAM_ATTR latencyTracerMarkFlushed(int display);
+
+//! \brief Copies the histogram of a sensor and stage
+//! \param sensorType The sensor
+//! \param stage The stage
+//! \param histogram Where the histogram is copied to
+//! \retval Boolean indicating if sensor and stage were valid
+bool latencyTracerGetHistogram(const SENSOR sensorType, const LATENCY_STAGE stage, LatencyHistogram *histogram);
+
+//! \brief Clears all histograms
+void latencyTracerReset(void);
+
+//! \brief Writes all histograms with samples to the log
+void latencyTracerDump(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_LATENCYTRACER
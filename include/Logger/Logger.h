@@ -20,7 +20,7 @@ static const bool LOGGER_SAVE_INTERNAL = true;
 static const bool LOGGER_SAVE_ON_SDCARD = true;
 //! \brief Defines if every message should be sent to the USB-C port
 static const bool LOGGER_SEND_TO_USB = true;
-//! \brief Defines what should be logged:
+//! \brief Defines what should be logged by default, see loggerSetLevel():
 //! 0 - nothing
 //! 1 - only critical errors
 //! 2 - critical errors & errors
@@ -34,6 +34,14 @@ static const int LOGGING_LEVEL = 4;
 //! \brief Initializes the logger
 void loggerInit(void);
 
+//! \brief Changes what is logged at runtime
+//! \param level 0 - 4, see LOGGING_LEVEL
+void loggerSetLevel(int level);
+
+//! \brief Returns what is logged
+//! \retval 0 - 4, see LOGGING_LEVEL
+int loggerGetLevel(void);
+
 //! \brief Logs a message with level 'Info'
 //! \param message The message that should be logged
 //! \param ... Additional parameters
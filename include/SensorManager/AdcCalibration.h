@@ -0,0 +1,85 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_ADCCALIBRATION
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_ADCCALIBRATION
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+#include "SensorManager/FixedPoint.h"
+#include "SensorManager/PiecewiseLinear.h"
+
+// espidf includes
+#include <esp_adc/adc_cali.h>
+#include <esp_adc/adc_cali_scheme.h>
+#include <esp_adc/adc_oneshot.h>
+#include <esp_timer.h>
+#include <nvs.h>
+
+/* --- Defines & Macros --- */
+#define ADC_CALIBRATION_NVS_NAMESPACE "adc_cali"
+
+// Increase it whenever the stored data changes, older data is derived again then
+#define ADC_CALIBRATION_VERSION 1
+
+// Highest raw value of a 12 bit reading
+#define ADC_CALIBRATION_RAW_MAX 4095
+
+// Gain trim of 1.0
+#define ADC_CALIBRATION_GAIN_ONE 10000
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief Everything needed to convert raw readings of one channel to a voltage without the
+//! curve fitting scheme. It is stored in the NVS as it is
+typedef struct {
+    uint32_t version;     // ADC_CALIBRATION_VERSION
+    int32_t unit;         // ADC unit the table belongs to
+    int32_t channel;      // ADC channel the table belongs to
+    int32_t atten;        // Attenuation the table was derived with
+    PwlTable table;       // raw -> mV, sampled from the curve fitting scheme
+    int32_t gain;         // Board trim, ADC_CALIBRATION_GAIN_ONE = 1.0
+    int32_t offsetMV;     // Board trim, added after the gain
+    uint32_t deriveTimeUs;// How long creating the curve fitting scheme took
+} AdcCalibration;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Restores the calibration of a channel from the NVS. If there is none (e.g. first boot) or it
+//! doesn't match the channel, it is derived from the curve fitting scheme and stored
+//! \param key The NVS key of the channel (max. 15 characters)
+//! \param unit The ADC unit
+//! \param channel The ADC channel
+//! \param atten The attenuation of the channel
+//! \param calibration Where the calibration is written to
+//! \retval Boolean indicating if there is a usable calibration
+bool adcCalibrationInit(const char *key, adc_unit_t unit, adc_channel_t channel, adc_atten_t atten, AdcCalibration *calibration);
+
+//! \brief Converts a raw reading to a voltage including the board trims
+//! \param calibration The calibration of the channel
+//! \param raw The raw ADC value
+//! \retval The voltage [in Millivolts]
+int adcCalibrationRawToMilliVolts(const AdcCalibration *calibration, int raw);
+
+//! \brief Sets the board trims of a channel and stores them
+//! \param key The NVS key of the channel
+//! \param calibration The calibration of the channel
+//! \param gain The gain, ADC_CALIBRATION_GAIN_ONE = 1.0
+//! \param offsetMV The offset [in Millivolts]
+//! \retval Boolean indicating if they were stored
+bool adcCalibrationSetTrim(const char *key, AdcCalibration *calibration, int32_t gain, int32_t offsetMV);
+
+//! \brief Deletes all stored calibrations, they are derived again on the next boot
+//! \retval Boolean indicating if it worked
+bool adcCalibrationErase(void);
+
+//! \brief Returns how long the calibrations took during this boot
+//! \param spentUs Time spent restoring or deriving [in us]
+//! \param savedUs Time saved compared to creating the curve fitting schemes [in us]
+void adcCalibrationGetBootTime(int64_t *spentUs, int64_t *savedUs);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_ADCCALIBRATION
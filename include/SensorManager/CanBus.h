@@ -0,0 +1,108 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_CANBUS
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_CANBUS
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+#include "SensorManager/SensorHal.h"
+
+// espidf includes
+#include <sdkconfig.h>
+
+// freeRTOS includes
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/* --- Defines & Macros --- */
+
+// TWAI controller of the board, the transceiver sits on these GPIOs
+#define CAN_TWAI_GPIO_TX GPIO_NUM_47
+#define CAN_TWAI_GPIO_RX GPIO_NUM_48
+#define CAN_TWAI_TIMING TWAI_TIMING_CONFIG_500KBITS
+#define CAN_BITRATE_BPS 500000
+
+// Frames the TWAI driver buffers until they are received, about 16ms at full bus load
+#define CAN_TWAI_RX_QUEUE_LENGTH 64
+
+// Longest line of a candump log
+#define CAN_CANDUMP_MAX_LINE_LENGTH 96
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief A received frame. It is only a view of the receive buffer of the backend, nothing is copied
+typedef struct {
+    uint32_t id;
+    bool extended;      // 29 bit id
+    uint8_t length;     // Of the data [in bytes], 0 - 8
+    const uint8_t *data;// Valid until the next canBusReceive()
+    int64_t timestampUs;// When it was received [sensorHalGetTimeUs() time in us]
+} CanFrame;
+
+//! \brief Acceptance filter for the standard ids: a frame is accepted if (id & mask) == (code & mask).
+//! Extended frames are only accepted with a mask of 0
+typedef struct {
+    uint32_t code;
+    uint32_t mask;
+} CanFilter;
+
+//! \brief A source of CAN frames. The SensorManager only talks to the selected backend
+typedef struct {
+    const char *name;
+
+    //! \brief Starts receiving the frames passing the filter
+    bool (*init)(const CanFilter *filter);
+
+    //! \brief Waits for the next frame
+    bool (*receive)(CanFrame *frame, TickType_t timeout);
+} CanBusBackend;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+#if !CONFIG_IDF_TARGET_LINUX
+//! \brief The TWAI controller of the board
+extern const CanBusBackend canBusTwai;
+#endif
+
+//! \brief Replays a candump log, see canBusCandumpOpen()
+extern const CanBusBackend canBusCandump;
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Selects the backend used by the SensorManager. Has to be called before sensorManagerInit().
+//! The TWAI controller is selected by default, on a Linux host there is no default
+//! \param backend The backend
+//! \retval Boolean indicating if the backend is complete
+bool canBusSelect(const CanBusBackend *backend);
+
+//! \brief Returns the selected backend
+//! \retval The backend or NULL
+const CanBusBackend *canBusGetBackend(void);
+
+//! \brief See CanBusBackend
+bool canBusInit(const CanFilter *filter);
+
+//! \brief See CanBusBackend
+bool canBusReceive(CanFrame *frame, TickType_t timeout);
+
+//! \brief Checks a frame against a filter like the controller does
+//! \param filter The filter
+//! \param frame The frame
+//! \retval Boolean indicating if it passes
+bool canBusFilterAccepts(const CanFilter *filter, const CanFrame *frame);
+
+//! \brief Opens a candump log ("candump -l" or "candump -L") for the candump backend. Every line is one frame:
+//! "(<seconds>.<microseconds>) <interface> <id>#<data>" - 3 hex digits are a standard id, 8 an extended one
+//! The frames are delivered at their recorded offsets from the first frame, on a virtual clock once
+//! sensorHalAdvanceTo() passed them
+//! \param path The full path of the file (e.g. "/sdcard/can/drive.log")
+//! \retval Boolean indicating if the file could be opened
+bool canBusCandumpOpen(const char *path);
+
+//! \brief Closes the log of the candump backend
+void canBusCandumpClose(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_CANBUS
@@ -0,0 +1,132 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_CANSIGNALS
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_CANSIGNALS
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+#include "SensorManager/CanBus.h"
+
+// espidf includes
+#include <esp_timer.h>
+
+// freeRTOS includes
+#include <freertos/FreeRTOS.h>
+
+/* --- Defines & Macros --- */
+
+// Size of a decoding table
+#define CAN_DECODER_MAX_SIGNALS 16
+
+// Channel mask, see sensorManagerSetCanChannels()
+#define CAN_CHANNEL_BIT(channel) (1UL << (channel))
+
+// Shortest classic frame with 8 data bytes on the wire, without stuffing and with the interframe space. At
+// CAN_BITRATE_BPS back to back that is the full bus load the decoder has to keep up with
+#define CAN_FRAME_MIN_BITS 111
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief The channels of the SensorManager which can come from the CAN bus. The decoded values are in
+//! the fixed-point unit of the sensor they feed
+typedef enum {
+    CAN_CHANNEL_OIL_PRESSURE,     // 0 or 1
+    CAN_CHANNEL_FUEL_LEVEL,       // 1 %
+    CAN_CHANNEL_WATER_TEMPERATURE,// 0.1 °C
+    CAN_CHANNEL_SPEED,            // 1 km/h
+    CAN_CHANNEL_RPM,              // 1 rpm
+    CAN_CHANNEL_COUNT,
+} CAN_CHANNEL;
+
+//! \brief Bit numbering of a signal, like in a DBC file
+typedef enum {
+    CAN_BYTE_ORDER_INTEL,   // Little endian, the start bit is the least significant one
+    CAN_BYTE_ORDER_MOTOROLA,// Big endian, the start bit is the most significant one
+} CAN_BYTE_ORDER;
+
+//! \brief A signal of a frame, like a SG_ line of a DBC file: value = raw * numerator / denominator + offset
+typedef struct {
+    uint32_t frameId;
+    bool extended;
+    CAN_CHANNEL channel;
+    uint8_t startBit;// 0 - 63, DBC numbering
+    uint8_t length;  // [in bits], 1 - 32
+    CAN_BYTE_ORDER byteOrder;
+    bool isSigned;
+    int32_t factorNumerator;
+    int32_t factorDenominator;
+    int32_t offset;
+    int32_t minimum;// Values outside are clamped and flagged
+    int32_t maximum;
+} CanSignal;
+
+//! \brief The latest value of a channel
+typedef struct {
+    int32_t value;
+    int64_t timestampUs;// Of the frame [sensorHalGetTimeUs() time in us]
+    bool outOfRange;    // The decoded value was clamped
+    uint32_t updates;   // Frames it was decoded from
+} CanSignalValue;
+
+//! \brief The signals of one frame id, found by a binary search
+typedef struct {
+    uint32_t frameId;
+    bool extended;
+    uint8_t firstSignal;// In the sorted order
+    uint8_t signalCount;
+} CanDecoderFrame;
+
+//! \brief Decodes the received frames into the latest value of every channel. Decoding runs on the CAN
+//! task, the values are read by the update jobs
+typedef struct {
+    const CanSignal *signals;
+    uint8_t order[CAN_DECODER_MAX_SIGNALS];    // Signal indices sorted by frame
+    uint8_t shift[CAN_DECODER_MAX_SIGNALS];    // Of the least significant bit in the data loaded in the byte order of the signal
+    uint8_t minLength[CAN_DECODER_MAX_SIGNALS];// Data bytes the frame needs for the signal
+    CanDecoderFrame frames[CAN_DECODER_MAX_SIGNALS];
+    int frameCount;
+    CanSignalValue values[CAN_CHANNEL_COUNT];
+    uint32_t decodedFrames;// Frames with at least one signal
+    uint32_t ignoredFrames;// Frames without a signal, the filter only drops part of them
+    uint32_t shortFrames;  // Signals skipped because their frame was too short
+    portMUX_TYPE lock;
+} CanDecoder;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Checks the signals and indexes them by frame
+//! \param decoder The decoder
+//! \param signals The signals, they aren't copied
+//! \param count The number of signals, at most CAN_DECODER_MAX_SIGNALS
+//! \retval Boolean indicating if every signal is valid
+bool canDecoderInit(CanDecoder *decoder, const CanSignal *signals, int count);
+
+//! \brief Returns the acceptance filter which lets every frame of the signals through, as narrow as a
+//! single code and mask can be
+//! \param decoder The decoder
+//! \param filter Where the filter is written to
+void canDecoderGetFilter(const CanDecoder *decoder, CanFilter *filter);
+
+//! \brief Decodes every signal of a frame. The data is read where the backend received it
+//! \param decoder The decoder
+//! \param frame The frame
+//! \retval The number of signals decoded
+int canDecoderDecode(CanDecoder *decoder, const CanFrame *frame);
+
+//! \brief Returns the latest value of a channel
+//! \param decoder The decoder
+//! \param channel The channel
+//! \param value Where the value is written to
+//! \retval Boolean indicating if it was received at least once
+bool canDecoderGetValue(CanDecoder *decoder, CAN_CHANNEL channel, CanSignalValue *value);
+
+//! \brief Tests the decoding and measures it at full bus load
+//! \retval Boolean indicating if they passed
+bool canDecoder_test(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_CANSIGNALS
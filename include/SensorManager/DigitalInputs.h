@@ -0,0 +1,125 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_DIGITALINPUTS
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_DIGITALINPUTS
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+
+// freeRTOS includes
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+// espidf includes
+#include <sdkconfig.h>
+
+/* --- Defines & Macros --- */
+
+// GPIOs, all of them are active low and use the internal pull-up
+#define GPIO_BLINKER_LEFT GPIO_NUM_1
+#define GPIO_BLINKER_RIGHT GPIO_NUM_2
+#define GPIO_BUTTON_1 GPIO_NUM_9
+#define GPIO_BUTTON_2 GPIO_NUM_10
+#define GPIO_BUTTON_3 GPIO_NUM_15
+
+// Debouncing
+#define DIGITAL_INPUTS_DEBOUNCE_US 10000// The level is sampled this long after the first edge of a bounce
+#define DIGITAL_INPUTS_QUEUE_LENGTH 16  // Debounced changes waiting to be processed
+
+// Blink patterns, a turn signal flashes 60 - 120 times per minute
+#define BLINK_PERIOD_MIN_US 400000 // Shorter periods between two flashes are no blinking
+#define BLINK_PERIOD_MAX_US 1500000// Longer ones neither
+#define BLINK_TIMEOUT_US 1500000   // Without a new flash or change for this long it stopped blinking
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief The digital inputs
+typedef enum {
+    DIGITAL_INPUT_BLINKER_LEFT,
+    DIGITAL_INPUT_BLINKER_RIGHT,
+    DIGITAL_INPUT_BUTTON_1,
+    DIGITAL_INPUT_BUTTON_2,
+    DIGITAL_INPUT_BUTTON_3,
+    DIGITAL_INPUT_COUNT,
+} DIGITAL_INPUT;
+
+//! \brief What the blinker lamps are doing
+typedef enum {
+    BLINKER_PATTERN_OFF,
+    BLINKER_PATTERN_LEFT,  // Left turn signal
+    BLINKER_PATTERN_RIGHT, // Right turn signal
+    BLINKER_PATTERN_HAZARD,// Both are flashing
+    BLINKER_PATTERN_STEADY,// A lamp is on without flashing (e.g. a broken flasher relay)
+} BLINKER_PATTERN;
+
+//! \brief A debounced change of a digital input
+typedef struct {
+    DIGITAL_INPUT input;
+    bool active;   // The new state
+    int64_t timeUs;// When the first edge of the change was seen [esp_timer time in us]
+} DigitalInputEvent;
+
+//! \brief The state of one blinker lamp
+typedef struct {
+    bool active;            // Is the lamp on?
+    int64_t lastChangeUs;   // When it was switched last
+    int64_t lastFlashUs;    // When it was switched on last
+    int64_t previousFlashUs;// When it was switched on before
+} BlinkerLamp;
+
+//! \brief Detects the blink pattern from the changes of both blinker lamps
+typedef struct {
+    BlinkerLamp left;
+    BlinkerLamp right;
+} BlinkDetector;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Configures the GPIOs, their edge interrupts and the debounce timer. Only the hardware has them
+//! \retval Boolean indicating if everything worked
+bool digitalInputsInit(void);
+
+//! \brief Waits for the next debounced change. Nothing is polled, the task sleeps until the debounce
+//! timer reports a change or the timeout is over
+//! \param event Where the change is written to
+//! \param timeout How long to wait at most [in ticks]
+//! \retval Boolean indicating if there was a change
+bool digitalInputsWaitForEvent(DigitalInputEvent *event, TickType_t timeout);
+
+//! \brief Returns the debounced state of an input
+//! \param input The input
+//! \retval Boolean indicating if it is active
+bool digitalInputsIsActive(DIGITAL_INPUT input);
+
+//! \brief Resets the detector, both lamps are off
+//! \param detector The detector
+void blinkDetectorInit(BlinkDetector *detector);
+
+//! \brief Hands a change of an input to the detector, buttons are ignored
+//! \param detector The detector
+//! \param event The change
+void blinkDetectorFeed(BlinkDetector *detector, const DigitalInputEvent *event);
+
+//! \brief Classifies what the lamps are doing
+//! \param detector The detector
+//! \param nowUs The current time [in us]
+//! \retval The pattern
+BLINKER_PATTERN blinkDetectorEvaluate(const BlinkDetector *detector, int64_t nowUs);
+
+//! \brief Returns when the pattern changes next without a new input change (e.g. the blinking stops)
+//! \param detector The detector
+//! \param nowUs The current time [in us]
+//! \retval The time [in us] or -1 if nothing times out
+int64_t blinkDetectorNextTimeoutUs(const BlinkDetector *detector, int64_t nowUs);
+
+//! \brief Tests the blink detection with synthetic lamp signals
+//! \retval Boolean indicating if they passed
+bool digitalInputs_test(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_DIGITALINPUTS
@@ -0,0 +1,60 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_EDGESNAPSHOT
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_EDGESNAPSHOT
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+
+// freeRTOS includes
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/* --- Defines & Macros --- */
+
+// How many snapshots the stress test reads
+#define EDGE_SNAPSHOT_TEST_READS 200000
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief The last edges of a pulse input. Written by exactly one writer (the edge ISR) and read by any
+//! number of tasks. The 64 bit timestamps can't be written atomically on the 32 bit cores, so the writer
+//! makes the sequence odd while it writes and the readers retry if it was odd or changed while they read
+typedef struct {
+    volatile uint32_t sequence;
+    volatile int64_t lastEdgeUs;
+    volatile int64_t previousEdgeUs;
+    volatile uint32_t edgeCount;
+} EdgeRecord;
+
+//! \brief A consistent copy of an EdgeRecord
+typedef struct {
+    int64_t lastEdgeUs;    // Time of the last falling edge [in us]
+    int64_t previousEdgeUs;// Time of the falling edge before [in us]
+    uint32_t edgeCount;    // How many edges were seen so far
+} EdgeSnapshot;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Records a new edge. Must only be called by the single writer of the record, doesn't block
+//! \param record The record
+//! \param timeUs Time of the edge [in us]
+void IRAM_ATTR edgeSnapshotRecord(EdgeRecord *record, int64_t timeUs);
+
+//! \brief Takes a consistent copy of a record without disabling interrupts
+//! \param record The record
+//! \param snapshot Where the copy is written to
+//! \retval How often the read had to be retried because the writer interfered
+uint32_t edgeSnapshotRead(const EdgeRecord *record, EdgeSnapshot *snapshot);
+
+//! \brief Hammers a record from a writer task on the other core while reading it and checks every
+//! snapshot for torn values
+//! \retval Boolean indicating if they passed
+bool edgeSnapshot_test(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_EDGESNAPSHOT
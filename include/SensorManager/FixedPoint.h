@@ -0,0 +1,54 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_FIXEDPOINT
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_FIXEDPOINT
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+/* --- Defines & Macros --- */
+
+// Returned if a resistance can't be calculated (e.g. open circuit)
+#define FIXED_POINT_RESISTANCE_INFINITE INT32_MAX
+
+/* --- Variables, Typedefs etc. --- */
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Divides and rounds to the nearest integer (half away from zero)
+//! \param numerator The numerator
+//! \param denominator The denominator, has to be > 0
+//! \retval The rounded quotient
+int64_t fixedPointDivideRounded(int64_t numerator, int64_t denominator);
+
+//! \brief Scales a value by numerator / denominator with a 64 bit intermediate and rounding
+//! \param value The value to scale
+//! \param numerator The numerator of the scale
+//! \param denominator The denominator of the scale, has to be > 0
+//! \retval The scaled value
+int32_t fixedPointScale(int32_t value, int32_t numerator, int32_t denominator);
+
+//! \brief Calculates the resistance R2 of a voltage divider
+//! \param supplyMV The voltage the divider works with [in Millivolts] e.g. 3300mV
+//! \param voltageMV The measured voltage between R1 and R2 [in Millivolts]
+//! \param r1 The resistance of R1 [in Ohms]
+//! \retval The resistance of R2 [in Milliohms] or FIXED_POINT_RESISTANCE_INFINITE
+int32_t fixedPointVoltageDividerR2(int32_t supplyMV, int32_t voltageMV, int32_t r1);
+
+//! \brief Calculates the frequency of a signal from its period
+//! \param periodUs The period [in Microseconds]
+//! \retval The frequency [in Millihertz] rounded, or -1 if the period is invalid
+int32_t fixedPointFrequencyFromPeriod(int64_t periodUs);
+
+//! \brief Converts a frequency to whole Hertz
+//! \param frequencyMilliHz The frequency [in Millihertz]
+//! \retval The frequency [in Hertz] rounded
+int32_t fixedPointMilliHzToHz(int32_t frequencyMilliHz);
+
+//! \brief Tests the conversions and benchmarks them against the old float versions
+//! \retval Boolean indicating if they passed
+bool fixedPoint_test(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_FIXEDPOINT
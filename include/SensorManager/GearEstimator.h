@@ -0,0 +1,57 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_GEARESTIMATOR
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_GEARESTIMATOR
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+/* --- Defines & Macros --- */
+
+// MX-5 (NA/NB) 5 speed gearbox
+#define GEAR_ESTIMATOR_GEAR_COUNT 5
+#define GEAR_ESTIMATOR_RATIOS_MILLI {3136, 1888, 1330, 1000, 814}
+#define GEAR_ESTIMATOR_FINAL_DRIVE_MILLI 4300
+#define GEAR_ESTIMATOR_TIRE_CIRCUMFERENCE_MM 1815// 185/60 R14
+
+// Classification
+#define GEAR_ESTIMATOR_ENTER_TOLERANCE_PERCENT 6// A new gear is detected within +-6% of its rpm/speed ratio
+#define GEAR_ESTIMATOR_STAY_TOLERANCE_PERCENT 10// The current gear is kept within +-10% (hysteresis)
+#define GEAR_ESTIMATOR_CONFIRM_SAMPLES 2        // Samples in a row a new state needs before it is taken
+#define GEAR_ESTIMATOR_MIN_SPEED_KMH 5          // Below this the ratio is too imprecise, it counts as standing
+#define GEAR_ESTIMATOR_IDLE_RPM 1100            // Rolling with at most this rpm and no matching gear -> neutral
+
+// Values besides the gears 1 - GEAR_ESTIMATOR_GEAR_COUNT
+#define GEAR_NEUTRAL 0
+#define GEAR_CLUTCH (-1)// Clutch pressed or slipping, no gear matches
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief State of the estimator
+typedef struct {
+    int32_t ratiosQ8[GEAR_ESTIMATOR_GEAR_COUNT];// rpm per km/h of every gear (Q8)
+    int gear;                                  // The current gear
+    int candidate;                             // A different gear which was detected lately
+    int candidateSamples;                      // How often in a row the candidate was detected
+} GearEstimator;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Calculates the ratios of the gearbox and starts in neutral
+//! \param estimator The estimator
+void gearEstimatorInit(GearEstimator *estimator);
+
+//! \brief Classifies the gear from the newest rpm and speed. Runs in constant time
+//! \param estimator The estimator
+//! \param rpm The engine rpm
+//! \param speedKmh The speed [in km/h]
+//! \retval The gear, GEAR_NEUTRAL or GEAR_CLUTCH
+int gearEstimatorUpdate(GearEstimator *estimator, int32_t rpm, int32_t speedKmh);
+
+//! \brief Tests the classification with synthetic drives
+//! \retval Boolean indicating if they passed
+bool gearEstimator_test(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_GEARESTIMATOR
@@ -0,0 +1,114 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_ODOMETER
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_ODOMETER
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+
+// espidf includes
+#include <nvs.h>
+#include <sdkconfig.h>
+
+/* --- Defines & Macros --- */
+#define ODOMETER_NVS_NAMESPACE "odometer"
+
+// Increase it whenever the stored data changes, older data is ignored then
+#define ODOMETER_VERSION 1
+
+// The speed signal has 1 Hz per km/h -> 3600 pulses per km
+#define ODOMETER_PULSES_PER_KM 3600
+
+// Persistence
+#define ODOMETER_SLOT_COUNT 4                // Stored round robin, so a broken slot only costs one store interval
+#define ODOMETER_DEFAULT_STORE_INTERVAL_M 100// At most one flash write per this distance
+#define ODOMETER_STOP_STORE_MIN_M 20          // A stop is only stored after at least this distance since the last store
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief What is stored in a slot of the NVS
+typedef struct {
+    uint32_t version;    // ODOMETER_VERSION
+    uint32_t sequence;   // Increases with every store, the highest valid slot is the newest
+    uint64_t totalPulses;// Speed pulses of the odometer
+    uint64_t tripPulses; // Speed pulses of the trip meter
+} OdometerRecord;
+
+//! \brief State of the odometer. Distances are whole speed pulses, they are only converted to meters
+//! when read, so nothing drifts
+typedef struct {
+    uint64_t totalPulses;        // Speed pulses of the odometer
+    uint64_t tripPulses;         // Speed pulses since the trip meter was reset
+    uint64_t storedTotalPulses;  // totalPulses when it was stored the last time
+    uint32_t storeIntervalPulses;// Distance between two stores
+    uint32_t lastEdgeCount;      // Edge count of the speed input at the last update
+    uint32_t sequence;           // Sequence of the last stored slot
+    bool tripResetPending;       // The trip meter was reset, but that isn't stored yet
+} Odometer;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Starts both meters at 0
+//! \param odometer The odometer
+//! \param edgeCount The current edge count of the speed input
+//! \param storeIntervalMeters At most one store per this distance
+void odometerInit(Odometer *odometer, uint32_t edgeCount, int32_t storeIntervalMeters);
+
+//! \brief Adds the edges since the last update to both meters. Only a subtraction and two additions,
+//! so it is cheap enough for the edge path
+//! \param odometer The odometer
+//! \param edgeCount The current edge count of the speed input, it may wrap around
+//! \retval Boolean indicating if a store is due
+bool odometerUpdate(Odometer *odometer, uint32_t edgeCount);
+
+//! \brief Returns a boolean indicating if something changed since the last store
+//! \param odometer The odometer
+//! \retval Boolean
+bool odometerHasUnstoredChanges(const Odometer *odometer);
+
+//! \brief Returns a boolean indicating if a stop should be stored: the vehicle moved at least
+//! ODOMETER_STOP_STORE_MIN_M since the last store or the trip meter was reset. Stop-and-go traffic
+//! doesn't write the flash on every stop this way
+//! \param odometer The odometer
+//! \retval Boolean
+bool odometerIsStopStoreDue(const Odometer *odometer);
+
+//! \brief Sets the distance between two stores
+//! \param odometer The odometer
+//! \param storeIntervalMeters The distance [in m], at least 1
+void odometerSetStoreInterval(Odometer *odometer, int32_t storeIntervalMeters);
+
+//! \brief Resets the trip meter, it is stored with the next store
+//! \param odometer The odometer
+void odometerResetTrip(Odometer *odometer);
+
+//! \brief Returns the distance of the odometer
+//! \param odometer The odometer
+//! \retval The distance [in m]
+int32_t odometerGetTotalMeters(const Odometer *odometer);
+
+//! \brief Returns the distance of the trip meter
+//! \param odometer The odometer
+//! \retval The distance [in m]
+int32_t odometerGetTripMeters(const Odometer *odometer);
+
+//! \brief Writes both meters to the next slot of the NVS
+//! \param odometer The odometer
+//! \retval Boolean indicating if it worked
+bool odometerStore(Odometer *odometer);
+
+//! \brief Restores both meters from the newest valid slot of the NVS
+//! \param odometer The odometer, it stays untouched if there is no valid slot (e.g. first boot)
+//! \retval Boolean indicating if a slot was restored
+bool odometerRestore(Odometer *odometer);
+
+//! \brief Tests the integration, the wrap around of the edge count and the store batching
+//! \retval Boolean indicating if they passed
+bool odometer_test(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_ODOMETER
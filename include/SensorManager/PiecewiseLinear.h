@@ -0,0 +1,85 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_PIECEWISELINEAR
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_PIECEWISELINEAR
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* --- Defines & Macros --- */
+#define PWL_MAX_POINTS 16
+
+// Weight of a calibration sample sitting exactly on a breakpoint (Q8)
+#define PWL_CALIBRATION_WEIGHT_ONE 256
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief What happens with inputs outside the first and last point of a table
+typedef enum {
+    PWL_END_CLAMP,      // Return the y value of the outermost point
+    PWL_END_EXTRAPOLATE,// Continue the outermost segment linearly
+} PWL_END_BEHAVIOR;
+
+//! \brief A single calibration point. Both values are fixed-point integers, the scaling
+//! is up to the user of the table (e.g. x in mHz and y in rpm)
+typedef struct {
+    int32_t x;
+    int32_t y;
+} PwlPoint;
+
+//! \brief A piecewise-linear conversion table. The x values have to be strictly increasing
+typedef struct {
+    PwlPoint points[PWL_MAX_POINTS];
+    int pointCount;
+    PWL_END_BEHAVIOR lowerEnd;
+    PWL_END_BEHAVIOR upperEnd;
+} PwlTable;
+
+//! \brief Accumulates reference samples to learn the y values of a table
+typedef struct {
+    int64_t sumWeights[PWL_MAX_POINTS];
+    int64_t sumWeightedResiduals[PWL_MAX_POINTS];
+    int sampleCount;
+} PwlCalibration;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Checks if a table can be evaluated (1 to PWL_MAX_POINTS points, strictly increasing x)
+//! \param table The table to check
+//! \retval Boolean indicating if the table is valid
+bool pwlIsValid(const PwlTable *table);
+
+//! \brief Converts x with the table. Between two points the result is interpolated
+//! linearly and rounded to the nearest integer
+//! \param table The table used for the conversion. Has to be valid!
+//! \param x The input value
+//! \retval The converted value
+int32_t pwlEvaluate(const PwlTable *table, int32_t x);
+
+//! \brief Resets a calibration so new samples can be collected
+//! \param calibration The calibration to reset
+void pwlCalibrationBegin(PwlCalibration *calibration);
+
+//! \brief Adds a sample of a known reference signal. The residual between the reference and
+//! the current table output is distributed onto the two surrounding points of the table
+//! \param calibration The calibration collecting the samples
+//! \param table The table that is calibrated
+//! \param x The measured input value
+//! \param yReference The value the table should have returned for x
+void pwlCalibrationAddSample(PwlCalibration *calibration, const PwlTable *table, int32_t x, int32_t yReference);
+
+//! \brief Moves every point of the table by the weighted mean residual of its samples.
+//! Points without samples are left untouched
+//! \param calibration The calibration containing the samples
+//! \param table The table that is calibrated
+//! \retval The amount of points that were adjusted
+int pwlCalibrationApply(const PwlCalibration *calibration, PwlTable *table);
+
+//! \brief Tests the conversion and calibration
+//! \retval Boolean indicating if they passed
+bool pwl_test(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_PIECEWISELINEAR
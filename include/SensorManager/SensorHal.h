@@ -0,0 +1,167 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SENSORHAL
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SENSORHAL
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+
+// espidf includes
+#include <sdkconfig.h>
+
+/* --- Defines & Macros --- */
+
+// How long a spike of the generator lasts
+#define SENSOR_HAL_GENERATOR_SPIKE_US 2000
+
+// How often the generator checks a pulse input without edges (frequency 0 or in a dropout)
+#define SENSOR_HAL_GENERATOR_IDLE_US 10000
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief The analog inputs of the SensorManager
+typedef enum {
+    SENSOR_HAL_ADC_OIL_PRESSURE,
+    SENSOR_HAL_ADC_FUEL_LEVEL,
+    SENSOR_HAL_ADC_WATER_TEMPERATURE,
+    SENSOR_HAL_ADC_INT_TEMPERATURE,
+    SENSOR_HAL_ADC_COUNT,
+} SENSOR_HAL_ADC;
+
+//! \brief The pulse inputs of the SensorManager, their falling edges are reported
+typedef enum {
+    SENSOR_HAL_PULSE_SPEED,
+    SENSOR_HAL_PULSE_RPM,
+    SENSOR_HAL_PULSE_COUNT,
+} SENSOR_HAL_PULSE;
+
+//! \brief Called for every falling edge of a pulse input. On the hardware it runs in the ISR!
+//! \param input The input the edge was seen on
+//! \param timeUs When the edge was seen [in us, same clock as sensorHalGetTimeUs()]
+typedef void (*SensorHalEdgeHandler)(SENSOR_HAL_PULSE input, int64_t timeUs);
+
+//! \brief A source of sensor signals. The SensorManager only talks to the selected backend
+typedef struct {
+    const char *name;
+
+    //! \brief Prepares everything shared by the inputs (e.g. ADC units, ISR service)
+    bool (*init)(void);
+
+    //! \brief Configures an analog input
+    bool (*initAdc)(SENSOR_HAL_ADC channel);
+
+    //! \brief Reads the voltage of an analog input [in Millivolts]
+    bool (*readMilliVolts)(SENSOR_HAL_ADC channel, int *voltageMV);
+
+    //! \brief Configures a pulse input
+    bool (*initPulse)(SENSOR_HAL_PULSE input);
+
+    //! \brief Starts reporting the edges of a pulse input to the handler
+    bool (*enableEdges)(SENSOR_HAL_PULSE input, SensorHalEdgeHandler handler);
+
+    //! \brief Stops reporting the edges of a pulse input
+    void (*disableEdges)(SENSOR_HAL_PULSE input);
+
+    //! \brief The current time [in us]
+    int64_t (*getTimeUs)(void);
+
+    //! \brief Moves a virtual clock forward and delivers everything that happens until then. NULL on the hardware
+    bool (*advanceTo)(int64_t timeUs);
+} SensorHalBackend;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+#if !CONFIG_IDF_TARGET_LINUX
+//! \brief The ADC and GPIO interrupts of the board
+extern const SensorHalBackend sensorHalHardware;
+#endif
+
+//! \brief Replays a recording, see sensorHalReplayOpen()
+extern const SensorHalBackend sensorHalReplay;
+
+//! \brief Generates synthetic signals, see sensorHalGeneratorConfigure()
+extern const SensorHalBackend sensorHalGenerator;
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Selects the backend used by the SensorManager. Has to be called before sensorManagerInit().
+//! The hardware is selected by default, on a Linux host there is no default
+//! \param backend The backend
+//! \retval Boolean indicating if the backend is complete
+bool sensorHalSelect(const SensorHalBackend *backend);
+
+//! \brief Returns the selected backend
+//! \retval The backend or NULL
+const SensorHalBackend *sensorHalGetBackend(void);
+
+//! \brief See SensorHalBackend
+bool sensorHalInit(void);
+
+//! \brief See SensorHalBackend
+bool sensorHalInitAdc(SENSOR_HAL_ADC channel);
+
+//! \brief See SensorHalBackend
+bool sensorHalReadMilliVolts(SENSOR_HAL_ADC channel, int *voltageMV);
+
+//! \brief See SensorHalBackend
+bool sensorHalInitPulse(SENSOR_HAL_PULSE input);
+
+//! \brief See SensorHalBackend
+bool sensorHalEnableEdges(SENSOR_HAL_PULSE input, SensorHalEdgeHandler handler);
+
+//! \brief See SensorHalBackend
+void sensorHalDisableEdges(SENSOR_HAL_PULSE input);
+
+//! \brief See SensorHalBackend
+int64_t sensorHalGetTimeUs(void);
+
+//! \brief Moves the virtual clock of the backend forward
+//! \param timeUs The new time [in us]
+//! \retval Boolean indicating if the backend has a virtual clock and there is still something to deliver
+bool sensorHalAdvanceTo(int64_t timeUs);
+
+//! \brief Opens a recording for the replay backend. Every line is one record, '#' starts a comment:
+//! "<time us> E <pulse input>" - A falling edge on the input
+//! "<time us> A <adc channel> <mV>" - The channel reads this voltage from now on
+//! The records have to be sorted by time
+//! \param path The full path of the file (e.g. "/sdcard/replay/drive.txt")
+//! \retval Boolean indicating if the file could be opened
+bool sensorHalReplayOpen(const char *path);
+
+//! \brief Closes the recording of the replay backend
+void sensorHalReplayClose(void);
+
+//! \brief Signal of an analog input of the generator
+typedef struct {
+    int32_t baseMV;      // Voltage at time 0
+    int32_t rampMVPerS;  // Change of the voltage per second
+    int32_t noiseMV;     // Uniform noise of +- this much
+    int32_t spikeMV;     // Added during a spike
+    int64_t spikeEveryUs;// A spike of SENSOR_HAL_GENERATOR_SPIKE_US every X us, 0 = none
+} SensorHalGeneratorAdc;
+
+//! \brief Signal of a pulse input of the generator
+typedef struct {
+    int32_t frequencyMilliHz;   // Frequency at time 0, 0 = no edges
+    int32_t rampMilliHzPerS;    // Change of the frequency per second
+    int32_t jitterUs;           // Uniform jitter of +- this much on every edge
+    int64_t dropoutEveryUs;     // The edges go missing every X us, 0 = never
+    int64_t dropoutLengthUs;    // For this long
+    int64_t spuriousEdgeEveryUs;// An ignition spike causes an extra edge every X us, 0 = never
+} SensorHalGeneratorPulse;
+
+//! \brief Everything the generator produces. The same config and seed always produce the same signals
+typedef struct {
+    uint32_t seed;
+    SensorHalGeneratorAdc adc[SENSOR_HAL_ADC_COUNT];
+    SensorHalGeneratorPulse pulse[SENSOR_HAL_PULSE_COUNT];
+} SensorHalGeneratorConfig;
+
+//! \brief Configures the signals of the generator backend and resets its clock to 0
+//! \param config The signals
+void sensorHalGeneratorConfigure(const SensorHalGeneratorConfig *config);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SENSORHAL
@@ -0,0 +1,43 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SENSORHALHARDWARE
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SENSORHALHARDWARE
+
+/* --- Includes --- */
+// Project includes
+#include "SensorManager/AdcCalibration.h"
+#include "SensorManager/SensorHal.h"
+
+// espidf includes
+#include <driver/gpio.h>
+#include <esp_adc/adc_oneshot.h>
+#include <esp_timer.h>
+
+/* --- Defines & Macros --- */
+
+// GPIOs
+#define GPIO_OIL_PRESSURE GPIO_NUM_12
+#define GPIO_FUEL_LEVEL GPIO_NUM_11
+#define GPIO_WATER_TEMPERATURE GPIO_NUM_13
+#define GPIO_INT_TEMPERATURE GPIO_NUM_7
+#define GPIO_SPEED GPIO_NUM_14
+#define GPIO_RPM GPIO_NUM_21
+
+// ADC CHANNELS
+#define ADC_CHANNEL_OIL_PRESSURE ADC_CHANNEL_1
+#define ADC_CHANNEL_FUEL_LEVEL ADC_CHANNEL_0
+#define ADC_CHANNEL_WATER_TEMPERATURE ADC_CHANNEL_2
+#define ADC_CHANNEL_INT_TEMPERATURE ADC_CHANNEL_6
+
+/* --- Variables, Typedefs etc. --- */
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Sets the board trims of an analog input, they are stored and used from the next reading on
+//! \param channel The input
+//! \param gain The gain, ADC_CALIBRATION_GAIN_ONE = 1.0
+//! \param offsetMV The offset [in Millivolts]
+//! \retval Boolean indicating if they were stored
+bool sensorHalHardwareSetTrim(SENSOR_HAL_ADC channel, int32_t gain, int32_t offsetMV);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SENSORHALHARDWARE
@@ -3,51 +3,68 @@
 
 /* --- Includes --- */
 // C includes
-#include <math.h>
 #include <stdbool.h>
 
 // Project includes
 #include "Logger/Logger.h"
-
-// espidf includes
-#include <driver/gpio.h>
-#include <driver/pulse_cnt.h>
-#include <esp_adc/adc_oneshot.h>
-#include <esp_timer.h>
+#include "SensorManager/CanBus.h"
+#include "SensorManager/CanSignals.h"
+#include "SensorManager/DigitalInputs.h"
+#include "SensorManager/EdgeSnapshot.h"
+#include "SensorManager/FixedPoint.h"
+#include "SensorManager/GearEstimator.h"
+#include "SensorManager/Odometer.h"
+#include "SensorManager/PiecewiseLinear.h"
+#include "SensorManager/SensorHal.h"
+#include "SensorManager/ShiftLight.h"
 
 // freeRTOS includes
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
+#include <freertos/semphr.h>
 #include <freertos/task.h>
 
 /* --- Defines & Macros --- */
 
 // Defines used for the voltage divider/ohmmeter to measure
 // the oil pressure, fuel level and water temperature
-#define OIL_FUEL_WATER_VOLTAGE_V 3.3
+#define OIL_FUEL_WATER_VOLTAGE_MV 3300
 #define OIL_FUEL_R1 240
 #define WATER_R1 3000
 
-// GPIOs
-#define GPIO_OIL_PRESSURE GPIO_NUM_12
-#define GPIO_FUEL_LEVEL GPIO_NUM_11
-#define GPIO_WATER_TEMPERATURE GPIO_NUM_13
-#define GPIO_SPEED GPIO_NUM_14
-#define GPIO_RPM GPIO_NUM_21
-
-// ADC CHANNELS
-#define ADC_CHANNEL_OIL_PRESSURE ADC_CHANNEL_1
-#define ADC_CHANNEL_FUEL_LEVEL ADC_CHANNEL_0
-#define ADC_CHANNEL_WATER_TEMPERATURE ADC_CHANNEL_2
-#define ADC_CHANNEL_INT_TEMPERATURE ADC_CHANNEL_6
-
 // OIL PRESSURE THRESHOLDS
 #define OIL_LOWER_VOLTAGE_THRESHOLD 65 // mV -> R2 ~= 5 Ohms
 #define OIL_UPPER_VOLTAGE_THRESHOLD 255// mV -> R2 ~= 20 Ohms
 
+// SAMPLES
+#define SENSOR_MAX_SUBSCRIBERS 4// Max. amount of subscribers per sensor
+
+#define SAMPLE_QUALITY_OK 0x00
+#define SAMPLE_QUALITY_READ_FAILED 0x01 // The ADC read or the conversion to a voltage failed
+#define SAMPLE_QUALITY_OUT_OF_RANGE 0x02// The measured value was implausible and replaced
+#define SAMPLE_QUALITY_ESTIMATED 0x04   // The next edge is overdue, the value is only an upper bound
+#define SAMPLE_QUALITY_STALE 0x08       // Its CAN frame didn't come for CAN_SIGNAL_TIMEOUT_US, it is the last received value
+
 // FUEL LEVEL CALCULATION STUFF
-#define FUEL_LEVEL_OFFSET 5.0f
-#define FUEL_LEVEL_TO_PERCENTAGE 115.0f// Divide the calculated resistance by this value to get the level in percent
+#define FUEL_LEVEL_OFFSET_MILLIOHM 5000
+#define FUEL_LEVEL_TO_PERCENTAGE_MILLIOHM 115000// Divide the calculated resistance by this value to get the level in percent
+
+// SPEED CALCULATION STUFF
+#define SPEED_MAX_KMH 499// Higher speeds are implausible
+
+// ODOMETER STUFF
+#define ODOMETER_PUBLISH_STEP_M 100// SENSOR_ODOMETER and SENSOR_TRIP are published everytime they pass a multiple of this
+
+// RPM CALCULATION STUFF
+#define RPM_MAX_FREQUENCY_MILLIHZ 300000// Higher frequencies are implausible (> 9000rpm)
+
+// CAN STUFF
+#define CAN_DEFAULT_CHANNELS 0              // Every channel is wired
+#define CAN_RECEIVE_TIMEOUT_MS 100          // sensorManagerUpdateCan() returns at least this often
+#define CAN_SIGNAL_TIMEOUT_US (500 * 1000LL)// A channel whose frame didn't come for this long is flagged stale
+
+// INTERNAL TEMPERATURE CALCULATION STUFF
+#define INT_TEMPERATURE_OFFSET_MV 540// Output voltage at 0 °C, the sensor has 10 mV/°C -> 1 mV = 0.1 °C
 
 /* --- Variables, Typedefs etc. --- */
 
@@ -59,8 +76,45 @@ typedef enum {
     SENSOR_INTERNAL_TEMPERATURE,
     SENSOR_SPEED,
     SENSOR_RPM,
+    SENSOR_GEAR,
+    SENSOR_BLINKER_LEFT,
+    SENSOR_BLINKER_RIGHT,
+    SENSOR_BLINKER_PATTERN,
+    SENSOR_BUTTON_1,
+    SENSOR_BUTTON_2,
+    SENSOR_BUTTON_3,
+    SENSOR_SHIFT_LIGHT,
+    SENSOR_ODOMETER,
+    SENSOR_TRIP,
+    SENSOR_COUNT,
 } SENSOR;
 
+//! \brief The fixed-point unit of a sample value
+typedef enum {
+    UNIT_NONE,
+    UNIT_BOOLEAN,     // 0 or 1
+    UNIT_PERCENT,     // 1 %
+    UNIT_LITRE,       // 1 l
+    UNIT_DECI_CELSIUS,// 0.1 °C
+    UNIT_KMH,         // 1 km/h
+    UNIT_RPM,         // 1 rpm
+    UNIT_GEAR,        // 1 - 5, GEAR_NEUTRAL or GEAR_CLUTCH
+    UNIT_PATTERN,     // BLINKER_PATTERN
+    UNIT_METER,       // 1 m
+} SENSOR_UNIT;
+
+//! \brief A single measurement of a sensor
+typedef struct {
+    SENSOR id;          // The sensor which was measured
+    int32_t value;      // The value in the fixed-point unit
+    SENSOR_UNIT unit;   // The unit of the value
+    int64_t timestampUs;// When the value was captured [sensorHalGetTimeUs() time in us]
+    uint8_t quality;    // SAMPLE_QUALITY_* flags
+} SensorSample;
+
+//! \brief A function receiving the samples of a sensor. The sample is only valid during the call!
+typedef void (*SensorSubscriber)(const SensorSample *sample);
+
 /* --- Imported Variables, Typedefs etc. --- */
 
 /* --- Global variables and function (headers) --- */
@@ -70,11 +124,38 @@ typedef enum {
 //! \retval 2 - Initialization succeeded with errors. See log
 int sensorManagerInit(void);
 
-//! \brief Registers a callback function which will be called once the specified value changes
-//! (e.g. oil, fuel, water temp etc.)
-//! \param sensorType The sensor the callback should be registered on
-//! \param callback The callback function
-void sensorManagerRegisterCallback(const SENSOR sensorType, void callback(void *val));
+//! \brief Selects the channels which are read from the CAN bus instead of their wired inputs, e.g. for a
+//! swapped engine. Has to be called before sensorManagerInit(). The odometer and the shift light only
+//! work with the wired speed and rpm edges
+//! \param channels CAN_CHANNEL_BIT() of the channels
+void sensorManagerSetCanChannels(uint32_t channels);
+
+//! \brief Returns a boolean indicating if any channel is read from the CAN bus and the bus works
+//! \retval Boolean
+bool sensorManagerUsesCan(void);
+
+//! \brief Waits for the next CAN frame and decodes its signals, the update functions of the channels
+//! publish them. Blocks up to CAN_RECEIVE_TIMEOUT_MS, so it can be called in an endless loop
+void sensorManagerUpdateCan(void);
+
+//! \brief Subscribes a function to the samples of a sensor. It is called on the updating task
+//! everytime the value of the sensor changes (e.g. oil, fuel, water temp etc.)
+//! \param sensorType The sensor to subscribe to
+//! \param subscriber The function receiving the samples
+//! \retval Boolean indicating if there was a free slot
+//! \note Subscribe before the update tasks are started
+bool sensorManagerSubscribe(const SENSOR sensorType, const SensorSubscriber subscriber);
+
+//! \brief Removes a function from the subscribers of a sensor
+//! \param sensorType The sensor to unsubscribe from
+//! \param subscriber The function which was subscribed
+//! \retval Boolean indicating if the subscriber was found
+bool sensorManagerUnsubscribe(const SENSOR sensorType, const SensorSubscriber subscriber);
+
+//! \brief Returns a printable name of the sensor
+//! \param sensorType The sensor
+//! \retval The name
+const char *sensorManagerGetSensorName(const SENSOR sensorType);
 
 //! \brief Checks if there is oil pressure
 void sensorManagerUpdateOilPressure(void);
@@ -93,9 +174,9 @@ int sensorManagerGetFuelLevel(void);
 //! \brief Updates the water temperature
 void sensorManagerUpdateWaterTemperature(void);
 
-//! \brief Returns the water temperature in degree Celsius
-//! \retval The water temperature as float
-float sensorManagerGetWaterTemperature(void);
+//! \brief Returns the water temperature
+//! \retval The water temperature in 0.1 degree Celsius as int
+int sensorManagerGetWaterTemperature(void);
 
 //! \brief Enables the speed ISR
 //! \retval Boolean indicating if it worked
@@ -111,6 +192,23 @@ void sensorManagerUpdateSpeed(void);
 //! \retval The speed as integer
 int sensorManagerGetSpeed(void);
 
+//! \brief Returns the distance of the odometer. It is integrated from the speed edges and restored at boot
+//! \retval The distance [in m]
+int32_t sensorManagerGetOdometer(void);
+
+//! \brief Returns the distance of the trip meter
+//! \retval The distance [in m]
+int32_t sensorManagerGetTrip(void);
+
+//! \brief Resets the trip meter. It is done and stored with the next speed update
+void sensorManagerResetTrip(void);
+
+//! \brief Sets the distance after which the odometer is stored. It is also stored once the vehicle stops
+//! after at least ODOMETER_STOP_STORE_MIN_M and on a software restart. A power loss isn't detected, so up to
+//! this distance can get lost if the supply goes away while driving
+//! \param storeIntervalMeters The distance [in m]
+void sensorManagerSetOdometerStoreInterval(int32_t storeIntervalMeters);
+
 //! \brief Enables the rpm ISR
 //! \retval Boolean indicating if it worked
 bool sensorManagerEnableRpmISR(void);
@@ -125,11 +223,64 @@ void sensorManagerUpdateRPM(void);
 //! \retval The rpm as integer
 int sensorManagerGetRPM(void);
 
+//! \brief Enables or disables the gear estimation. While it is enabled every rpm period seen by
+//! sensorManagerUpdateShiftLight() classifies the gear with the latest speed and publishes SENSOR_GEAR if
+//! it changed. Without wired rpm edges (e.g. the rpm comes from the CAN bus) the speed and rpm updates do it
+//! \param enabled Boolean
+void sensorManagerSetGearEstimation(bool enabled);
+
+//! \brief Returns the estimated gear
+//! \retval The gear, GEAR_NEUTRAL or GEAR_CLUTCH
+int sensorManagerGetGear(void);
+
+//! \brief Feeds the newest rpm signal period to the shift light and the gear estimation and publishes
+//! SENSOR_SHIFT_LIGHT if it switched. Call it much faster than the rpm is updated, it only reads the edge timestamps
+//! \param leadUs How long it takes until the shift light is visible on the display [in us]
+void sensorManagerUpdateShiftLight(int64_t leadUs);
+
+//! \brief Returns a boolean indicating if the shift light is on
+//! \retval Boolean
+bool sensorManagerIsShiftLightActive(void);
+
+//! \brief Waits for the next debounced change of a digital input and publishes it. Also publishes
+//! SENSOR_BLINKER_PATTERN whenever the pattern of the blinker lamps changes. Blocks until there is a
+//! change or the blinking may have stopped, so it can be called in an endless loop
+void sensorManagerUpdateDigitalInputs(void);
+
+//! \brief Returns the debounced state of a digital input
+//! \param input The input
+//! \retval Boolean indicating if it is active (lamp on, button pressed)
+bool sensorManagerIsDigitalInputActive(DIGITAL_INPUT input);
+
+//! \brief Returns what the blinker lamps are doing
+//! \retval The pattern
+BLINKER_PATTERN sensorManagerGetBlinkerPattern(void);
+
+//! \brief Starts learning the rpm conversion table from a known reference signal
+//! (e.g. a signal generator) applied to the rpm input
+void sensorManagerBeginRpmCalibration(void);
+
+//! \brief Pairs the currently measured rpm frequency with the rpm of the reference signal.
+//! Call it once the rpm was updated after changing the reference signal
+//! \param referenceRpm The rpm the reference signal represents
+//! \retval Boolean indicating if the point was added
+bool sensorManagerAddRpmCalibrationPoint(const int referenceRpm);
+
+//! \brief Applies the learned calibration to the rpm conversion table
+//! \retval Boolean indicating if the table was adjusted
+bool sensorManagerFinishRpmCalibration(void);
+
 //! \brief Updates the internal temperature
 void sensorManagerUpdateInternalTemperature(void);
 
-//! \brief Returns the internal temperature in degree Celsius
-//! \retval The temperature as double
-double sensorManagerGetInternalTemperature(void);
+//! \brief Returns the internal temperature
+//! \retval The temperature in 0.1 degree Celsius as int
+int sensorManagerGetInternalTemperature(void);
+
+//! \brief Runs the whole acquisition pipeline on the signal generator faster than real time and checks the results.
+//! Meant for the host or a bench, the SensorManager stays on the generator afterwards. Also benchmarks the rpm
+//! table in use against the old if/else ladder
+//! \retval Boolean indicating if they passed
+bool sensorManager_test(void);
 
 #endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SENSORMANAGER
@@ -0,0 +1,67 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SHIFTLIGHT
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SHIFTLIGHT
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+/* --- Defines & Macros --- */
+
+#define SHIFT_LIGHT_REDLINE_RPM 7000
+#define SHIFT_LIGHT_RELEASE_RPM 300        // It goes out once the rpm is this far below the redline and nothing is predicted
+#define SHIFT_LIGHT_HISTORY 16             // Measurements the slope is fitted over
+#define SHIFT_LIGHT_MAX_AGE_US 250000      // Older measurements are ignored, so the slope follows the throttle
+#define SHIFT_LIGHT_MIN_SLOPE_RPM_PER_S 300// Slower rises aren't predicted, the light comes at the redline
+#define SHIFT_LIGHT_DEFAULT_LEAD_US 100000 // Lead while the display latency isn't measured yet
+#define SHIFT_LIGHT_MAX_LEAD_US 500000     // The lead never gets longer, no matter how slow the display is
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief The latest rpm measurements and the state of the shift light
+typedef struct {
+    int64_t timesUs[SHIFT_LIGHT_HISTORY];// When each rpm was measured (ring buffer)
+    int32_t rpms[SHIFT_LIGHT_HISTORY];   // The rpm of a single period
+    int newest;                          // Index of the newest measurement
+    int count;                           // Measurements in the buffer
+    bool active;                         // Is the shift light on?
+} ShiftLight;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Clears the measurements and turns the light off
+//! \param light The shift light
+void shiftLightInit(ShiftLight *light);
+
+//! \brief Adds the rpm of a single signal period
+//! \param light The shift light
+//! \param timeUs When the period ended [in us]
+//! \param rpm The rpm
+void shiftLightFeed(ShiftLight *light, int64_t timeUs, int32_t rpm);
+
+//! \brief Fits a line through the recent measurements
+//! \param light The shift light
+//! \param nowUs The current time [in us]
+//! \retval The rpm change [in rpm/s], 0 if there aren't enough recent measurements
+int32_t shiftLightGetSlope(const ShiftLight *light, int64_t nowUs);
+
+//! \brief Predicts when the redline is reached with the current slope
+//! \param light The shift light
+//! \param nowUs The current time [in us]
+//! \retval The time [in us] or -1 if the rpm doesn't rise fast enough
+int64_t shiftLightPredictRedlineUs(const ShiftLight *light, int64_t nowUs);
+
+//! \brief Decides if the shift light is on. It turns on at the redline or leadUs before it is predicted
+//! \param light The shift light
+//! \param nowUs The current time [in us]
+//! \param leadUs How long it takes until the light is visible [in us]
+//! \retval Boolean indicating if it is on
+bool shiftLightUpdate(ShiftLight *light, int64_t nowUs, int64_t leadUs);
+
+//! \brief Tests the prediction with synthetic rpm ramps
+//! \retval Boolean indicating if they passed
+bool shiftLight_test(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SHIFTLIGHT
@@ -0,0 +1,141 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SETTINGS
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SETTINGS
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "FileManager/FileManager.h"
+#include "Logger/Logger.h"
+
+// espidf includes
+#include <nvs.h>
+
+// freeRTOS includes
+#include <freertos/FreeRTOS.h>
+
+/* --- Defines & Macros --- */
+#define SETTINGS_NVS_NAMESPACE "settings"
+
+// Optional file on the SD card, its values override the stored ones until the next boot. One
+// "name=value" per line, lines starting with # are ignored
+#define SETTINGS_OVERRIDE_FILE "settings.txt"
+
+// Longest line of the override file and longest console command
+#define SETTINGS_LINE_LENGTH 64
+
+// Prefix of the console command, which stores the value in the NVS as well
+#define SETTINGS_SAVE_COMMAND "save "
+
+#define SETTINGS_MAX_SUBSCRIBERS 4// Max. amount of subscribers per setting
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief Every tunable. The defaults are the macros of the modules they belong to
+typedef enum {
+    // Update intervals of the rate controlled sensors [ms]
+    SETTING_OIL_PRESSURE_INTERVAL_MIN_MS,
+    SETTING_OIL_PRESSURE_INTERVAL_MAX_MS,
+    SETTING_FUEL_LEVEL_INTERVAL_MIN_MS,
+    SETTING_FUEL_LEVEL_INTERVAL_MAX_MS,
+    SETTING_WATER_TEMPERATURE_INTERVAL_MIN_MS,
+    SETTING_WATER_TEMPERATURE_INTERVAL_MAX_MS,
+    SETTING_INTERNAL_TEMPERATURE_INTERVAL_MIN_MS,
+    SETTING_INTERNAL_TEMPERATURE_INTERVAL_MAX_MS,
+    SETTING_SPEED_INTERVAL_MIN_MS,
+    SETTING_SPEED_INTERVAL_MAX_MS,
+    SETTING_RPM_INTERVAL_MIN_MS,
+    SETTING_RPM_INTERVAL_MAX_MS,
+
+    // Other intervals [ms]
+    SETTING_SHIFT_LIGHT_INTERVAL_MS,
+    SETTING_SYSTEM_MONITOR_INTERVAL_MS,
+    SETTING_STATISTICS_DUMP_INTERVAL_MS,
+
+    // Priorities of the scheduler jobs and of the scheduler task
+    SETTING_ADC_ACQUISITION_PRIORITY,
+    SETTING_SPEED_PRIORITY,
+    SETTING_RPM_PRIORITY,
+    SETTING_SHIFT_LIGHT_PRIORITY,
+    SETTING_SCHEDULER_TASK_PRIORITY,
+
+    // Displays
+    SETTING_GUI_SPI_SPEED_HZ,
+    SETTING_GUI_REFRESH_PERIOD_MS,// Of the temperature and fuel display
+
+    // Logger
+    SETTING_LOGGING_LEVEL,
+
+    // CAN bus, read at boot
+    SETTING_CAN_CHANNELS,// CAN_CHANNEL_BIT() mask of the channels which come from the bus
+
+    SETTING_COUNT,
+} SETTING;
+
+//! \brief A function which is called when a setting changed. It is called on the task changing it
+typedef void (*SettingsSubscriber)(SETTING setting, int32_t value);
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Loads the settings: the defaults and then the values stored in the NVS. Invalid values are
+//! skipped with a warning. Call it after the NVS was initialized and before any module reads a setting
+//! \note The override file is applied by settingsReloadOverrideFile() once the SD card is mounted
+void settingsInit(void);
+
+//! \brief Returns the current value of a setting. Doesn't lock, so it can be used in hot paths
+//! \param setting The setting
+//! \retval The value
+int32_t settingsGet(SETTING setting);
+
+//! \brief Validates and sets a setting and notifies its subscribers if it changed
+//! \param setting The setting
+//! \param value The new value
+//! \param persist Boolean indicating if it is stored in the NVS for the next boot as well
+//! \retval Boolean indicating if the value was valid and, if it should persist, stored
+bool settingsSet(SETTING setting, int32_t value, bool persist);
+
+//! \brief Sets a setting by its name, e.g. from a line of the override file
+//! \param name The name of the setting
+//! \param value The new value
+//! \param persist Boolean indicating if it is stored in the NVS for the next boot as well
+//! \retval Boolean indicating if there is such a setting and the value was valid
+bool settingsSetByName(const char *name, int32_t value, bool persist);
+
+//! \brief Reads the override file on the SD card and applies its values
+//! \retval The number of applied values or -1 if there is no such file
+int settingsReloadOverrideFile(void);
+
+//! \brief Applies a console command: "name=value" sets a setting until the next boot, like a line of the
+//! override file, "save name=value" stores it for the next boots as well, "reload" applies the override
+//! file again and "erase" deletes all stored values
+//! \param command The command without the line ending, it is modified
+//! \retval Boolean indicating if it is a known command and the value was valid
+bool settingsApplyCommand(char *command);
+
+//! \brief Deletes all stored values, the defaults are used again from the next boot on
+//! \retval Boolean indicating if it worked
+bool settingsErase(void);
+
+//! \brief Reads the value stored in the NVS for the next boot
+//! \param setting The setting
+//! \param value Set to the stored value
+//! \retval Boolean indicating if one is stored
+bool settingsGetStored(SETTING setting, int32_t *value);
+
+//! \brief Returns the name of a setting, it is also its key in the NVS and the override file
+//! \param setting The setting
+//! \retval The name
+const char *settingsGetName(SETTING setting);
+
+//! \brief Subscribes a function to the changes of a setting
+//! \param setting The setting
+//! \param subscriber The function
+//! \retval Boolean indicating if there was a free slot
+//! \note Subscribe before the tasks which change settings are started
+bool settingsSubscribe(SETTING setting, SettingsSubscriber subscriber);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SETTINGS
@@ -0,0 +1,91 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SYSTEMMONITOR
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SYSTEMMONITOR
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+
+// espidf includes
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+// freeRTOS includes
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/* --- Defines & Macros --- */
+
+// Tasks which are tracked, later ones are ignored
+#define SYSTEM_MONITOR_MAX_TASKS 24
+
+// Samples kept in the rolling history
+#define SYSTEM_MONITOR_HISTORY_LENGTH 32
+
+// The task didn't exist when the sample was taken
+#define SYSTEM_MONITOR_NO_TASK UINT16_MAX
+
+// The task isn't pinned to a core
+#define SYSTEM_MONITOR_ANY_CORE -1
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief The heaps which are tracked
+typedef enum {
+    SYSTEM_MONITOR_HEAP_INTERNAL,// MALLOC_CAP_INTERNAL
+    SYSTEM_MONITOR_HEAP_DMA,     // MALLOC_CAP_DMA
+    SYSTEM_MONITOR_HEAP_PSRAM,   // MALLOC_CAP_SPIRAM
+    SYSTEM_MONITOR_HEAP_COUNT,
+} SYSTEM_MONITOR_HEAP;
+
+//! \brief State of a heap when the sample was taken
+typedef struct {
+    uint32_t freeBytes;       // Free right now
+    uint32_t minimumFreeBytes;// Least free since boot
+    uint32_t largestFreeBlock;// Largest allocation that would succeed
+} SystemMonitorHeap;
+
+//! \brief A task during the interval before the sample
+typedef struct {
+    uint16_t loadPermille;  // Share of the time of one core it ran, SYSTEM_MONITOR_NO_TASK if it didn't exist
+    uint16_t stackFreeBytes;// Least stack that was free since the task started (high water mark)
+    int8_t core;            // The core it is pinned to or SYSTEM_MONITOR_ANY_CORE
+} SystemMonitorTask;
+
+//! \brief One sample of the history. Tasks are identified by their index, see systemMonitorGetTaskName()
+typedef struct {
+    int64_t timestampUs;// When it was taken [esp_timer time in us]
+    int64_t intervalUs; // Time since the sample before
+    uint8_t taskCount;  // Valid entries of tasks
+    SystemMonitorTask tasks[SYSTEM_MONITOR_MAX_TASKS];
+    uint16_t coreLoadPermille[portNUM_PROCESSORS];// Share of the time the core didn't run its idle task
+    SystemMonitorHeap heaps[SYSTEM_MONITOR_HEAP_COUNT];
+} SystemMonitorSample;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Takes a sample of every task and heap and adds it to the history. Meant to be called at a low
+//! rate, it iterates all tasks with the scheduler suspended
+void systemMonitorSample(void);
+
+//! \brief Copies a sample of the history
+//! \param age 0 is the newest sample, 1 the one before and so on
+//! \param sample Where the sample is copied to
+//! \retval Boolean indicating if there is a sample that old
+bool systemMonitorGetSample(int age, SystemMonitorSample *sample);
+
+//! \brief Returns the name of a task of the samples
+//! \param task The index of the task
+//! \retval The name or NULL if there is no such task
+const char *systemMonitorGetTaskName(int task);
+
+//! \brief Writes the newest sample to the log: the load of every core, the load, core and free stack of every
+//! task and the heaps
+void systemMonitorDump(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_SYSTEMMONITOR
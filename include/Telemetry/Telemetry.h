@@ -0,0 +1,68 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_TELEMETRY
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_TELEMETRY
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "EventBus/EventBus.h"
+#include "Logger/Logger.h"
+#include "Telemetry/TelemetryFrame.h"
+
+// espidf includes
+#include <esp_timer.h>
+
+// freeRTOS includes
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/* --- Defines & Macros --- */
+
+// How long the first sample of a frame waits for more before the frame is sent anyway
+#define TELEMETRY_FLUSH_INTERVAL_MS 10
+
+// Transmit buffer of the USB-Serial-JTAG driver, shared with the text log. A frame which doesn't fit is dropped
+#define TELEMETRY_TX_BUFFER_SIZE 4096
+#define TELEMETRY_RX_BUFFER_SIZE 256// Lines the host sends, see telemetryReadLine()
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief Counters of the stream
+typedef struct {
+    uint32_t frames;        // Frames handed to the driver
+    uint32_t samples;       // Samples in them
+    uint32_t bytes;         // Bytes on the wire, including the COBS overhead and the delimiters
+    uint32_t droppedFrames; // Frames the driver had no room for, the host sees them as a sequence gap
+    uint32_t droppedSamples;// Samples in them
+} TelemetryStats;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Takes over the USB-Serial-JTAG port and starts streaming every sample as binary frames. The text log
+//! keeps working, it goes through the same driver, so it only ends up between two frames
+//! \param queueLength Length of its event bus queue
+//! \param taskPriority Priority of the task sending the frames
+//! \param core The core the task is pinned to
+//! \retval Boolean indicating if it worked
+//! \note Call it before the first sample is published
+bool telemetryInit(int queueLength, UBaseType_t taskPriority, BaseType_t core);
+
+//! \brief Blocks until the host sent a line over the port. Longer lines are dropped as a whole
+//! \param line Where the line is written to, without the line ending
+//! \param size Size of line, including the terminating zero
+//! \retval Boolean indicating if it is complete, false if it was too long
+//! \note Only one task may read
+bool telemetryReadLine(char *line, size_t size);
+
+//! \brief Returns the counters of the stream
+//! \param stats Where the counters are written to
+void telemetryGetStats(TelemetryStats *stats);
+
+//! \brief Writes the counters, and the bandwidth and the framing overhead since the last dump to the log
+void telemetryDump(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_TELEMETRY
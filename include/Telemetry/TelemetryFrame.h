@@ -0,0 +1,78 @@
+#ifndef FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_TELEMETRYFRAME
+#define FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_TELEMETRYFRAME
+
+/* --- Includes --- */
+// C includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Project includes
+#include "Logger/Logger.h"
+#include "SensorManager/SensorManager.h"
+
+/* --- Defines & Macros --- */
+
+// Layout of a frame before the COBS encoding, everything is little endian:
+// version (1), sequence (2), sample count (1), samples, CRC-16/CCITT-FALSE over everything before (2)
+#define TELEMETRY_FRAME_VERSION 1
+#define TELEMETRY_HEADER_SIZE 4
+#define TELEMETRY_CRC_SIZE 2
+
+// A sample: sensor (1), unit (1), quality (1), lower 32 bit of the timestamp [us] (4), value (4)
+#define TELEMETRY_SAMPLE_SIZE 11
+#define TELEMETRY_MAX_SAMPLES_PER_FRAME 16
+
+#define TELEMETRY_MAX_PAYLOAD_SIZE (TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_SAMPLES_PER_FRAME * TELEMETRY_SAMPLE_SIZE + TELEMETRY_CRC_SIZE)
+
+// COBS adds one byte per started 254 bytes, the frame is enclosed by two 0x00 delimiters
+#define TELEMETRY_MAX_FRAME_SIZE (TELEMETRY_MAX_PAYLOAD_SIZE + TELEMETRY_MAX_PAYLOAD_SIZE / 254 + 1 + 2)
+
+/* --- Variables, Typedefs etc. --- */
+
+//! \brief A frame which is being filled
+typedef struct {
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD_SIZE];
+    size_t length;// Bytes of the payload used so far
+    int count;    // Samples in it
+} TelemetryFrame;
+
+/* --- Imported Variables, Typedefs etc. --- */
+
+/* --- Global variables and function (headers) --- */
+
+//! \brief Starts an empty frame
+//! \param frame The frame
+//! \param sequence Counts up with every frame, so lost frames show up as a gap
+void telemetryFrameBegin(TelemetryFrame *frame, uint16_t sequence);
+
+//! \brief Adds a sample to a frame
+//! \param frame The frame
+//! \param sample The sample
+//! \retval Boolean indicating if there was room left
+bool telemetryFrameAdd(TelemetryFrame *frame, const SensorSample *sample);
+
+//! \brief Adds the CRC and encodes the frame for the wire
+//! \param frame The frame, it can't be added to anymore afterwards
+//! \param output At least TELEMETRY_MAX_FRAME_SIZE bytes
+//! \retval The number of bytes written to output
+size_t telemetryFrameEncode(TelemetryFrame *frame, uint8_t *output);
+
+//! \brief Calculates the CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF)
+//! \param data The data
+//! \param length The number of bytes
+//! \retval The CRC
+uint16_t telemetryCrc16(const uint8_t *data, size_t length);
+
+//! \brief COBS encodes data, so it doesn't contain 0x00 anymore
+//! \param input The data
+//! \param length The number of bytes
+//! \param output At least length + length / 254 + 1 bytes
+//! \retval The number of bytes written to output
+size_t telemetryCobsEncode(const uint8_t *input, size_t length, uint8_t *output);
+
+//! \brief Tests the encoding with frames containing zeros and long runs without them
+//! \retval Boolean indicating if they passed
+bool telemetryFrame_test(void);
+
+#endif// FIRMWARE_INCLUDE_C_HEADER_TEMPLATE_H_TELEMETRYFRAME
@@ -1,4 +1,42 @@
 #ifndef FIRMWARE_MACROS_H
 #define FIRMWARE_MACROS_H
 
+/* --- Includes --- */
+// espidf includes
+#include <sdkconfig.h>
+
+// freeRTOS includes
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/* --- Defines & Macros --- */
+
+// STATIC ALLOCATION: With CONFIG_FIRMWARE_STATIC_ALLOCATION the long-lived objects are static variables of the
+// module creating them, they can't fragment the heap and the map file tells how much RAM every module needs
+
+//! \brief Creates a task which runs until the restart, pinned like xTaskCreatePinnedToCore(). Its stack and TCB are
+//! static variables of the calling function in the static allocation mode, so call it once per task function
+//! \param function The task function, it names the static variables as well
+//! \param name The name of the task
+//! \param stackSize The stack size [in bytes], a constant
+//! \param params The parameter of the task function
+//! \param priority The priority
+//! \param handle Where the handle is written to, may be NULL
+//! \param core The core or tskNO_AFFINITY
+//! \retval pdPASS or pdFAIL
+#if CONFIG_FIRMWARE_STATIC_ALLOCATION
+#define TASK_CREATE(function, name, stackSize, params, priority, handle, core)                                                                                         \
+    ({                                                                                                                                                                 \
+        static StackType_t function##Stack_[(stackSize)];                                                                                                              \
+        static StaticTask_t function##Tcb_;                                                                                                                            \
+        TaskHandle_t *function##Handle_ = (handle);                                                                                                                    \
+        const TaskHandle_t function##Created_ = xTaskCreateStaticPinnedToCore(function, name, (stackSize), params, priority, function##Stack_, &function##Tcb_, core); \
+        if (function##Handle_ != NULL) *function##Handle_ = function##Created_;                                                                                        \
+        function##Created_ != NULL ? pdPASS : pdFAIL;                                                                                                                  \
+    })
+#else
+#define TASK_CREATE(function, name, stackSize, params, priority, handle, core) \
+    xTaskCreatePinnedToCore(function, name, (stackSize), params, priority, handle, core)
+#endif
+
 #endif//FIRMWARE_MACROS_H
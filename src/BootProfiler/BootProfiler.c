@@ -0,0 +1,186 @@
+/* --- Includes --- */
+#include "BootProfiler/BootProfiler.h"
+
+// C includes
+#include <stdio.h>
+
+/* --- Private Defines & Macros --- */
+
+// Longest printed critical path
+#define BOOT_PROFILER_PATH_LENGTH 160
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// A milestone after the phases
+typedef struct {
+    const char *name;
+    int64_t timeUs;// [esp_timer time in us]
+} BootMark;
+
+// The phases of the current run and how they went
+static const BootPhase *phases_ = NULL;
+static int phaseCount_ = 0;
+static BootPhaseTiming timings_[BOOT_PROFILER_MAX_PHASES];
+static int64_t runStartUs_ = 0;
+static int64_t runEndUs_ = 0;
+
+// A bit is set once the phase is done, no matter how it ended
+static EventGroupHandle_t doneBits_ = NULL;
+static StaticEventGroup_t doneBitsBuffer_;
+
+// Milestones, they may be recorded by any task
+static BootMark marks_[BOOT_PROFILER_MAX_MARKS];
+static int markCount_ = 0;
+static portMUX_TYPE marksLock_ = portMUX_INITIALIZER_UNLOCKED;
+
+// Printable names of the results
+static const char *resultNames_[] = {
+        [BOOT_PHASE_PENDING] = "pending",
+        [BOOT_PHASE_SUCCEEDED] = "ok",
+        [BOOT_PHASE_FAILED] = "FAILED",
+        [BOOT_PHASE_SKIPPED] = "SKIPPED",
+};
+
+//! \brief Checks if a phase has to be skipped, because one of its critical dependencies failed or was skipped
+//! \param phase The phase, its dependencies have to be done
+//! \retval Boolean indicating if it has to be skipped
+static bool mustSkip(const BootPhase *phase) {
+    for (int i = 0; i < phaseCount_; i++) {
+        if (!(phase->dependencies & BOOT_PHASE(i))) continue;
+
+        const BOOT_PHASE_RESULT result = timings_[i].result;
+        if (result == BOOT_PHASE_SKIPPED || (result == BOOT_PHASE_FAILED && phases_[i].critical)) return true;
+    }
+
+    return false;
+}
+
+/* --- Tasks --- */
+
+//! \brief Task, which runs one phase once its dependencies are done
+//! \param params The index of the phase
+//! \note This task ends itself!
+static void taskRunPhase(void *params) {
+    const int index = (int) params;
+    const BootPhase *phase = &phases_[index];
+    BootPhaseTiming *timing = &timings_[index];
+    timing->startUs = esp_timer_get_time();
+    timing->core = xPortGetCoreID();
+
+    // Wait for the dependencies
+    if (phase->dependencies != 0) xEventGroupWaitBits(doneBits_, phase->dependencies, pdFALSE, pdTRUE, portMAX_DELAY);
+    timing->readyUs = esp_timer_get_time();
+
+    // Run it
+    BOOT_PHASE_RESULT result = BOOT_PHASE_SKIPPED;
+    if (!mustSkip(phase)) result = phase->function() ? BOOT_PHASE_SUCCEEDED : BOOT_PHASE_FAILED;
+    timing->endUs = esp_timer_get_time();
+    timing->result = result;
+
+    // Let the phases depending on it run
+    xEventGroupSetBits(doneBits_, BOOT_PHASE(index));
+    vTaskDelete(NULL);
+}
+
+/* --- Function implementations --- */
+bool bootProfilerRun(const BootPhase *phases, const int count) {
+    // Are the phases valid?
+    if (phases == NULL || count <= 0 || count > BOOT_PROFILER_MAX_PHASES) return false;
+    for (int i = 0; i < count; i++) {
+        if (phases[i].dependencies & ~(BOOT_PHASE(i) - 1)) {
+            // Logging
+            loggerCritical("Boot phase %s depends on itself or a later phase", phases[i].name);
+
+            return false;
+        }
+    }
+
+    // Only the bits of this run count
+    if (doneBits_ == NULL) doneBits_ = xEventGroupCreateStatic(&doneBitsBuffer_);
+    const uint32_t allPhases = BOOT_PHASE(count) - 1;
+    xEventGroupClearBits(doneBits_, allPhases);
+
+    phases_ = phases;
+    phaseCount_ = count;
+    runStartUs_ = esp_timer_get_time();
+
+    // Start every phase, they wait for their dependencies themselves
+    for (int i = 0; i < count; i++) {
+        timings_[i] = (BootPhaseTiming) {.result = BOOT_PHASE_PENDING};
+        if (xTaskCreatePinnedToCore(taskRunPhase, phases[i].name, phases[i].stackSize, (void *) i, uxTaskPriorityGet(NULL), NULL, phases[i].core) != pdPASS) {
+            // Logging
+            loggerCritical("Couldn't create the task of the boot phase %s!", phases[i].name);
+
+            // Count it as failed, so the phases depending on it don't wait forever
+            timings_[i].result = BOOT_PHASE_FAILED;
+            xEventGroupSetBits(doneBits_, BOOT_PHASE(i));
+        }
+    }
+
+    // Wait for all of them
+    xEventGroupWaitBits(doneBits_, allPhases, pdFALSE, pdTRUE, portMAX_DELAY);
+    runEndUs_ = esp_timer_get_time();
+
+    // Did every critical phase work?
+    bool success = true;
+    for (int i = 0; i < count; i++) {
+        success &= timings_[i].result != BOOT_PHASE_SKIPPED && !(timings_[i].result == BOOT_PHASE_FAILED && phases[i].critical);
+    }
+
+    return success;
+}
+
+bool bootProfilerGetTiming(const int phase, BootPhaseTiming *timing) {
+    // Is the phase valid?
+    if (phase < 0 || phase >= phaseCount_) return false;
+
+    *timing = timings_[phase];
+
+    return true;
+}
+
+void bootProfilerMark(const char *name) {
+    const int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&marksLock_);
+    if (markCount_ < BOOT_PROFILER_MAX_MARKS) marks_[markCount_++] = (BootMark) {name, now};
+    portEXIT_CRITICAL(&marksLock_);
+
+    // Logging
+    loggerInfo("Boot: %s after %lld us", name, now);
+}
+
+void bootProfilerDump(void) {
+    // Every phase
+    int64_t busyUs = 0;
+    int last = -1;
+    for (int i = 0; i < phaseCount_; i++) {
+        const BootPhaseTiming *timing = &timings_[i];
+        busyUs += timing->endUs - timing->readyUs;
+        if (last < 0 || timing->endUs > timings_[last].endUs) last = i;
+
+        // Logging
+        loggerInfo("Boot phase %s: core %d, ready at %lld us, took %lld us, %s", phases_[i].name, (int) timing->core, timing->readyUs,
+                   timing->endUs - timing->readyUs, resultNames_[timing->result]);
+    }
+
+    // The critical path: from the last phase back through the dependency which was done last
+    char path[BOOT_PROFILER_PATH_LENGTH];
+    int length = 0;
+    for (int phase = last; phase >= 0 && length < BOOT_PROFILER_PATH_LENGTH;) {
+        length += snprintf(path + length, BOOT_PROFILER_PATH_LENGTH - length, "%s%s", length > 0 ? " <- " : "", phases_[phase].name);
+
+        int previous = -1;
+        for (int i = 0; i < phase; i++) {
+            if ((phases_[phase].dependencies & BOOT_PHASE(i)) && (previous < 0 || timings_[i].endUs > timings_[previous].endUs)) previous = i;
+        }
+        phase = previous;
+    }
+
+    // Logging
+    loggerInfo("Boot: all phases done after %lld us, the run took %lld us for %lld us of work", runEndUs_, runEndUs_ - runStartUs_, busyUs);
+    if (last >= 0) loggerInfo("Boot: critical path %s", path);
+    for (int i = 0; i < markCount_; i++) {
+        loggerInfo("Boot: %s after %lld us", marks_[i].name, marks_[i].timeUs);
+    }
+}
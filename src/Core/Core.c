@@ -1,91 +1,294 @@
 /* --- Includes --- */
 #include "Core/Core.h"
 
+// Project includes
+#include "macros.h"
+
+// C includes
+#include <stdio.h>
+#include <string.h>
+
 /* --- Private Defines & Macros --- */
 
+// Sensors updated by scheduler jobs
+#define SENSOR_JOB_COUNT 6
+
 /* --- Private Variables, Typedefs etc. --- */
 
+// A sensor updated by a scheduler job, its interval comes from the rate controller
+typedef struct {
+    SENSOR sensor;
+    void (*update)(void);
+    int (*getValue)(void);
+    uint32_t phaseMs;          // Delay of the first update
+    SETTING minIntervalSetting;// Limits of the rate controller
+    SETTING maxIntervalSetting;
+    int32_t changePerS;
+    SETTING prioritySetting;// Priority of the job
+} SensorJob;
+
+//! \brief Returns the oil pressure as int for the rate controller
+static int getOilPressure(void) {
+    return sensorManagerHasOilPressure();
+}
+
+static const SensorJob sensorJobs_[SENSOR_JOB_COUNT] = {
+        {SENSOR_OIL_PRESSURE, sensorManagerUpdateOilPressure, getOilPressure, 0 * ADC_ACQUISITION_PHASE_MS, SETTING_OIL_PRESSURE_INTERVAL_MIN_MS,
+         SETTING_OIL_PRESSURE_INTERVAL_MAX_MS, OIL_PRESSURE_CHANGE_PER_S, SETTING_ADC_ACQUISITION_PRIORITY},
+        {SENSOR_FUEL_LEVEL_PERCENT, sensorManagerUpdateFuelLevel, sensorManagerGetFuelLevel, 1 * ADC_ACQUISITION_PHASE_MS, SETTING_FUEL_LEVEL_INTERVAL_MIN_MS,
+         SETTING_FUEL_LEVEL_INTERVAL_MAX_MS, FUEL_LEVEL_CHANGE_PER_S, SETTING_ADC_ACQUISITION_PRIORITY},
+        {SENSOR_WATER_TEMPERATURE, sensorManagerUpdateWaterTemperature, sensorManagerGetWaterTemperature, 2 * ADC_ACQUISITION_PHASE_MS,
+         SETTING_WATER_TEMPERATURE_INTERVAL_MIN_MS, SETTING_WATER_TEMPERATURE_INTERVAL_MAX_MS, WATER_TEMPERATURE_CHANGE_PER_S, SETTING_ADC_ACQUISITION_PRIORITY},
+        {SENSOR_INTERNAL_TEMPERATURE, sensorManagerUpdateInternalTemperature, sensorManagerGetInternalTemperature, 3 * ADC_ACQUISITION_PHASE_MS,
+         SETTING_INTERNAL_TEMPERATURE_INTERVAL_MIN_MS, SETTING_INTERNAL_TEMPERATURE_INTERVAL_MAX_MS, INTERNAL_TEMPERATURE_CHANGE_PER_S, SETTING_ADC_ACQUISITION_PRIORITY},
+        {SENSOR_SPEED, sensorManagerUpdateSpeed, sensorManagerGetSpeed, SPEED_PHASE_MS, SETTING_SPEED_INTERVAL_MIN_MS, SETTING_SPEED_INTERVAL_MAX_MS, SPEED_CHANGE_PER_S,
+         SETTING_SPEED_PRIORITY},
+        {SENSOR_RPM, sensorManagerUpdateRPM, sensorManagerGetRPM, RPM_PHASE_MS, SETTING_RPM_INTERVAL_MIN_MS, SETTING_RPM_INTERVAL_MAX_MS, RPM_CHANGE_PER_S,
+         SETTING_RPM_PRIORITY},
+};
+
+// Where the samples of the sensors are delivered to, on the sample delivery task
+static const SensorSubscriber deliveries_[SENSOR_COUNT] = {
+        [SENSOR_OIL_PRESSURE] = guiSetOilPressure,
+        [SENSOR_FUEL_LEVEL_PERCENT] = guiSetFuelLevelPercent,
+        [SENSOR_FUEL_LEVEL_LITRE] = guiSetFuelLevelLitre,
+        [SENSOR_WATER_TEMPERATURE] = guiSetWaterTemperature,
+        [SENSOR_INTERNAL_TEMPERATURE] = thermalGovernorSetTemperature,// Scales the workload back while the board is hot
+        [SENSOR_SPEED] = guiSetSpeed,
+        [SENSOR_RPM] = guiSetRpm,
+        [SENSOR_BLINKER_LEFT] = guiSetLeftBlinker,
+        [SENSOR_BLINKER_RIGHT] = guiSetRightBlinker,
+};
+
+// Ids of the event bus subscribers
+static int deliverySubscriberId_ = -1;
+static int loggingSubscriberId_ = -1;
+
+// Ids of the scheduler jobs, their priorities can be changed by the settings
+static int sensorJobIds_[SENSOR_JOB_COUNT] = {-1, -1, -1, -1, -1, -1};
+static int shiftLightJobId_ = -1;
+
 // Task handlers
-TaskHandle_t taskOilPressureHandler_ = NULL;
-TaskHandle_t taskFuelLevelHandler_ = NULL;
-TaskHandle_t taskWaterTemperatureHandler_ = NULL;
-TaskHandle_t taskInternalTemperatureHandler_ = NULL;
-TaskHandle_t taskSpeedHandler_ = NULL;
-TaskHandle_t taskRpmHandler_ = NULL;
+TaskHandle_t taskSampleDeliveryHandler_ = NULL;
+TaskHandle_t taskSampleLoggingHandler_ = NULL;
+TaskHandle_t taskDigitalInputsHandler_ = NULL;
+TaskHandle_t taskCanReceiveHandler_ = NULL;
+TaskHandle_t taskStatisticsDumpHandler_ = NULL;
+TaskHandle_t taskSettingsConsoleHandler_ = NULL;
+
+/* --- Private functions --- */
+
+//! \brief Writes every sensor sample to the log
+//! \param sample The sample
+void logSensorSample(const SensorSample *sample) {
+    // Logging
+    loggerInfo("%s changed! Value: '%ld' Unit: '%d' Quality: '0x%02x' Captured: '%lld us'",
+               sensorManagerGetSensorName(sample->id), (long) sample->value, sample->unit, sample->quality, sample->timestampUs);
+}
+
+//! \brief Returns how early the shift light has to be switched on: the measured time from the decision
+//! until the display is flushed plus one update interval the decision may come late
+//! \retval The lead [in us]
+static int64_t getShiftLightLeadUs(void) {
+    LatencyHistogram histogram;
+    if (!latencyTracerGetHistogram(SENSOR_SHIFT_LIGHT, LATENCY_STAGE_FLUSHED, &histogram) || histogram.count == 0) return SHIFT_LIGHT_DEFAULT_LEAD_US;
+
+    return (int64_t) (histogram.sumUs / histogram.count) + (int64_t) settingsGet(SETTING_SHIFT_LIGHT_INTERVAL_MS) * 1000;
+}
+
+//! \brief Configures the rate controller of a sensor job with the current settings
+//! \param job The job
+//! \retval Boolean indicating if the limits are valid
+static bool configureRateController(const SensorJob *job) {
+    const RateControllerLimits limits = {settingsGet(job->minIntervalSetting), settingsGet(job->maxIntervalSetting), job->changePerS};
+
+    return rateControllerConfigure(job->sensor, &limits);
+}
+
+//! \brief Applies a changed setting to the rate controller, the scheduler or the thermal governor
+//! \param setting The setting
+//! \param value Its new value
+//! \note Subscribed to the settings
+static void applySetting(const SETTING setting, const int32_t value) {
+    // Intervals and priorities of the sensor jobs
+    for (int i = 0; i < SENSOR_JOB_COUNT; i++) {
+        const SensorJob *job = &sensorJobs_[i];
+        if (setting == job->minIntervalSetting || setting == job->maxIntervalSetting) configureRateController(job);
+        if (setting == job->prioritySetting) schedulerSetJobPriority(sensorJobIds_[i], value);
+    }
+
+    switch (setting) {
+        case SETTING_SHIFT_LIGHT_PRIORITY:
+            schedulerSetJobPriority(shiftLightJobId_, value);
+            break;
+        case SETTING_SCHEDULER_TASK_PRIORITY:
+            schedulerSetTaskPriority(value);
+            break;
+        case SETTING_GUI_SPI_SPEED_HZ:
+        case SETTING_GUI_REFRESH_PERIOD_MS:
+        case SETTING_LOGGING_LEVEL:
+            // The thermal level caps them
+            thermalGovernorApply();
+            break;
+        default:
+            break;
+    }
+}
+
+/* --- Jobs --- */
+
+//! \brief Job, which updates a sensor. It runs again as soon as the rate controller says
+//! \param context The SensorJob
+//! \retval The interval until the next update [in Milliseconds]
+static uint32_t runSensorJob(void *context) {
+    const SensorJob *job = context;
+
+    // Update the sensor
+    job->update();
+
+    // Wait as long as the rate controller says
+    return rateControllerFeed(job->sensor, job->getValue());
+}
+
+//! \brief Job, which runs the shift light and the gear estimation. It reads the rpm edges much faster than
+//! the rpm is updated
+//! \retval The configured interval [in Milliseconds]
+static uint32_t runShiftLightJob(void *context) {
+    // Predict with the current display latency
+    sensorManagerUpdateShiftLight(getShiftLightLeadUs());
+
+    return settingsGet(SETTING_SHIFT_LIGHT_INTERVAL_MS);
+}
+
+//! \brief Job, which samples the load and stack of every task and the heaps
+//! \retval The configured interval [in Milliseconds]
+static uint32_t runSystemMonitorJob(void *context) {
+    systemMonitorSample();
+
+    return settingsGet(SETTING_SYSTEM_MONITOR_INTERVAL_MS);
+}
 
 /* --- Tasks --- */
 
-//! \brief Task, which updates the oil pressure periodically
-void IRAM_ATTR taskUpdateOilPressure(void *params) {
+//! \brief Task, which hands the samples to the displays and the thermal governor. The sensors are
+//! sampled on other tasks, so a slow display update only delays the displays
+void taskDeliverSamples(void *params) {
     // ReSharper disable once CppDFAEndlessLoop
     while (1) {
-        // Update the oil pressure
-        sensorManagerUpdateOilPressure();
-
-        // Wait X milliseconds
-        vTaskDelay(pdMS_TO_TICKS(OIL_PRESSURE_UPDATE_INTERVAL_MS));
+        SensorSample sample;
+        if (eventBusReceive(deliverySubscriberId_, &sample, portMAX_DELAY)) deliveries_[sample.id](&sample);
     }
 }
 
-//! \brief Task, which updates the fuel level periodically
-void IRAM_ATTR taskUpdateFuelLevel(void *params) {
+//! \brief Task, which writes every sample to the log
+void taskLogSamples(void *params) {
     // ReSharper disable once CppDFAEndlessLoop
     while (1) {
-        // Update the fuel level
-        sensorManagerUpdateFuelLevel();
-
-        // Wait X milliseconds
-        vTaskDelay(pdMS_TO_TICKS(FUEL_LEVEL_UPDATE_INTERVAL_MS));
+        SensorSample sample;
+        if (eventBusReceive(loggingSubscriberId_, &sample, portMAX_DELAY)) logSensorSample(&sample);
     }
 }
 
-//! \brief Task, which updates the water temp periodically
-void IRAM_ATTR taskUpdateWaterTemperature(void *params) {
+//! \brief Task, which publishes the changes of the digital inputs. It blocks until there is one
+void taskUpdateDigitalInputs(void *params) {
     // ReSharper disable once CppDFAEndlessLoop
     while (1) {
-        // Update the water temperature
-        sensorManagerUpdateWaterTemperature();
-
-        // Wait X milliseconds
-        vTaskDelay(pdMS_TO_TICKS(WATER_TEMPERATURE_UPDATE_INTERVAL_MS));
+        // Wait for and publish the next change
+        sensorManagerUpdateDigitalInputs();
     }
 }
 
-//! \brief Task, which updates the internal temp periodically
-void IRAM_ATTR taskUpdateInternalTemperature(void *params) {
+//! \brief Task, which decodes the frames of the CAN bus. The update jobs publish the decoded values
+void taskReceiveCan(void *params) {
     // ReSharper disable once CppDFAEndlessLoop
     while (1) {
-        //Update the internal temperature
-        sensorManagerUpdateInternalTemperature();
-
-        // Wait X milliseconds
-        vTaskDelay(pdMS_TO_TICKS(INTERNAL_TEMPERATURE_UPDATE_INTERVAL_MS));
+        // Wait for and decode the next frame
+        sensorManagerUpdateCan();
     }
 }
 
-//! \brief Task, which updates the speed periodically
-void IRAM_ATTR taskUpdateSpeed(void *params) {
+//! \brief Task, which writes the sensor to display latencies, the sample rates, the job statistics, the telemetry bandwidth and the system state to the log periodically
+void taskDumpStatistics(void *params) {
+    TickType_t lastWakeTime = xTaskGetTickCount();
+
     // ReSharper disable once CppDFAEndlessLoop
     while (1) {
-        // Update the speed
-        sensorManagerUpdateSpeed();
+        // Wait for the next period, the time the dump took doesn't add to it
+        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(settingsGet(SETTING_STATISTICS_DUMP_INTERVAL_MS)));
+
+        // Dump the histograms
+        latencyTracerDump();
 
-        // Wait X milliseconds
-        vTaskDelay(pdMS_TO_TICKS(SPEED_UPDATE_INTERVAL_MS));
+        // Dump the sample rates
+        rateControllerDump();
 
-        //loggerInfo("Updating Speed!");
+        // Dump the lateness and run time of the jobs
+        schedulerDump();
+
+        // Dump the deliveries and drops of the event bus
+        eventBusDump();
+
+        // Dump the bandwidth of the telemetry
+        telemetryDump();
+
+        // Dump the task loads, stacks and heaps
+        systemMonitorDump();
     }
 }
 
-//! \brief Task, which updates the RPM periodically
-void IRAM_ATTR taskUpdateRpm(void *params) {
+//! \brief Applies a trim console command
+//! \param arguments Everything after CORE_TRIM_COMMAND
+//! \retval Boolean indicating if the trims were valid and stored
+static bool applyTrimCommand(const char *arguments) {
+    int channel;
+    long gain;
+    long offsetMV;
+    char rest;
+    if (sscanf(arguments, "%d %ld %ld %c", &channel, &gain, &offsetMV, &rest) != 3 || channel < 0 || channel >= SENSOR_HAL_ADC_COUNT) {
+        // Logging
+        loggerWarn("Invalid trim command, expected '" CORE_TRIM_COMMAND "<0-%d> <gain, %d = 1.0> <offset mV>'", SENSOR_HAL_ADC_COUNT - 1,
+                   ADC_CALIBRATION_GAIN_ONE);
+
+        return false;
+    }
+
+    // The hardware uses them from the next reading on
+    if (!sensorHalHardwareSetTrim(channel, (int32_t) gain, (int32_t) offsetMV)) {
+        // Logging
+        loggerError("Couldn't store the trims of analog input %d", channel);
+
+        return false;
+    }
+
+    // Logging
+    loggerInfo("Trims of analog input %d: gain %ld, offset %ld mV", channel, gain, offsetMV);
+
+    return true;
+}
+
+//! \brief Task, which applies the settings the host sends over the port: "name=value", "save name=value",
+//! "reload", "erase", "trim <analog input> <gain> <offset mV>" or "test"
+void taskReadSettings(void *params) {
+    char command[SETTINGS_LINE_LENGTH];
+
     // ReSharper disable once CppDFAEndlessLoop
     while (1) {
-        // Update the RPM
-        sensorManagerUpdateRPM();
+        // Wait for the next line
+        if (!telemetryReadLine(command, sizeof(command))) {
+            // Logging
+            loggerWarn("Console command too long, at most %d characters", SETTINGS_LINE_LENGTH - 1);
+
+            continue;
+        }
+        if (command[0] == '\0') continue;
 
-        // Wait X milliseconds
-        vTaskDelay(pdMS_TO_TICKS(RPM_UPDATE_INTERVAL_MS));
+        if (strcmp(command, "test") == 0) {
+            core_test();
+        } else if (strncmp(command, CORE_TRIM_COMMAND, strlen(CORE_TRIM_COMMAND)) == 0) {
+            applyTrimCommand(command + strlen(CORE_TRIM_COMMAND));
+        } else {
+            settingsApplyCommand(command);
+        }
     }
 }
 
@@ -94,36 +297,76 @@ void IRAM_ATTR taskUpdateRpm(void *params) {
 bool coreInit(void) {
     bool success = true;
 
-    // Register the callbacks
-    sensorManagerRegisterCallback(SENSOR_OIL_PRESSURE, guiSetOilPressure);
-    sensorManagerRegisterCallback(SENSOR_FUEL_LEVEL_PERCENT, guiSetFuelLevelPercent);
-    sensorManagerRegisterCallback(SENSOR_FUEL_LEVEL_LITRE, guiSetFuelLevelLitre);
-    sensorManagerRegisterCallback(SENSOR_WATER_TEMPERATURE, guiSetWaterTemperature);
-    sensorManagerRegisterCallback(SENSOR_SPEED, guiSetSpeed);
-    sensorManagerRegisterCallback(SENSOR_RPM, guiSetRpm);
+    // Configure the sample rates
+    for (int i = 0; i < SENSOR_JOB_COUNT; i++) {
+        success &= configureRateController(&sensorJobs_[i]);
+    }
 
-    // Start the update oil pressure task
-    success &= xTaskCreate(taskUpdateOilPressure, "taskUpdateOilPressure", 8196, NULL, OIL_PRESSURE_PRIORITY_LEVEL, &taskOilPressureHandler_);
+    // Classify the gear on every speed and rpm update
+    sensorManagerSetGearEstimation(true);
 
-    // Start the update fuel level task
-    success &= xTaskCreate(taskUpdateFuelLevel, "taskUpdateFuelLevel", 8196, NULL, FUEL_LEVEL_PRIORITY_LEVEL, &taskFuelLevelHandler_);
+    // The displays only get the latest value of every sensor, the log gets every sample as long as it keeps up
+    uint32_t deliveryTopics = 0;
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++) {
+        if (deliveries_[sensor] != NULL) deliveryTopics |= EVENT_BUS_TOPIC(sensor);
+    }
+    deliverySubscriberId_ = eventBusSubscribe("Delivery", deliveryTopics, DISPLAY_QUEUE_LENGTH, EVENT_BUS_KEEP_LATEST);
+    loggingSubscriberId_ = eventBusSubscribe("Logging", EVENT_BUS_ALL_TOPICS, LOGGING_QUEUE_LENGTH, EVENT_BUS_DROP_OLDEST);
+    success &= deliverySubscriberId_ >= 0 && loggingSubscriberId_ >= 0;
 
-    // Start the update water temperature task
-    success &= xTaskCreate(taskUpdateWaterTemperature, "taskUpdateWaterTemperature", 8196, NULL, WATER_TEMPERATURE_PRIORITY_LEVEL, &taskWaterTemperatureHandler_);
+    // Stream every sample to the host as well
+    success &= telemetryInit(TELEMETRY_QUEUE_LENGTH, TELEMETRY_PRIORITY_LEVEL, OUTPUT_CORE);
 
-    // Start the update internal temperature task
-    success &= xTaskCreate(taskUpdateInternalTemperature, "taskUpdateInternalTemperature", 8196, NULL, INTERNAL_TEMPERATURE_PRIORITY_LEVEL, &taskInternalTemperatureHandler_);
+    // Every sample goes through the event bus, the updating tasks only copy it into the queues
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++) {
+        success &= sensorManagerSubscribe(sensor, eventBusPublish);
+    }
+
+    // The shift light must not wait behind the labels in the delivery queue, its setter only wakes the LVGL task
+    success &= sensorManagerSubscribe(SENSOR_SHIFT_LIGHT, guiSetShiftLight);
+
+    // Apply the settings which are capped by the thermal level and follow every change
+    thermalGovernorApply();
+    for (int setting = 0; setting < SETTING_COUNT; setting++) {
+        success &= settingsSubscribe(setting, applySetting);
+    }
+
+    // Add the periodic jobs, they all run on the scheduler task
+    for (int i = 0; i < SENSOR_JOB_COUNT; i++) {
+        const SensorJob *job = &sensorJobs_[i];
+        sensorJobIds_[i] = schedulerAddJob(sensorManagerGetSensorName(job->sensor), runSensorJob, (void *) job, rateControllerGetIntervalMs(job->sensor), job->phaseMs,
+                                           settingsGet(job->prioritySetting));
+        success &= sensorJobIds_[i] >= 0;
+    }
+    shiftLightJobId_ = schedulerAddJob("Shift light", runShiftLightJob, NULL, settingsGet(SETTING_SHIFT_LIGHT_INTERVAL_MS), 0, settingsGet(SETTING_SHIFT_LIGHT_PRIORITY));
+    success &= shiftLightJobId_ >= 0;
+    success &= schedulerAddJob("System monitor", runSystemMonitorJob, NULL, settingsGet(SETTING_SYSTEM_MONITOR_INTERVAL_MS), 0, SYSTEM_MONITOR_PRIORITY_LEVEL) >= 0;
+
+    // Start the scheduler
+    success &= schedulerInit(settingsGet(SETTING_SCHEDULER_TASK_PRIORITY), ACQUISITION_CORE);
+
+    // Start the tasks receiving from the event bus
+    success &= TASK_CREATE(taskDeliverSamples, "taskDeliverSamples", 4096, NULL, SAMPLE_DELIVERY_PRIORITY_LEVEL, &taskSampleDeliveryHandler_, OUTPUT_CORE);
+    success &= TASK_CREATE(taskLogSamples, "taskLogSamples", 4096, NULL, SAMPLE_LOGGING_PRIORITY_LEVEL, &taskSampleLoggingHandler_, OUTPUT_CORE);
+
+    // Start the digital inputs task
+    success &= TASK_CREATE(taskUpdateDigitalInputs, "taskUpdateDigitalInputs", 4096, NULL, DIGITAL_INPUTS_PRIORITY_LEVEL, &taskDigitalInputsHandler_, ACQUISITION_CORE);
+
+    // Start the CAN task, only if a channel comes from the bus
+    if (sensorManagerUsesCan()) {
+        success &= TASK_CREATE(taskReceiveCan, "taskReceiveCan", 4096, NULL, CAN_RECEIVE_PRIORITY_LEVEL, &taskCanReceiveHandler_, ACQUISITION_CORE);
+    }
 
-    // Start the update speed task
-    success &= xTaskCreate(taskUpdateSpeed, "taskUpdateSpeed", 8196 * 2, NULL, SPEED_PRIORITY_LEVEL, &taskSpeedHandler_);
+    // Start the statistics dump task
+    success &= TASK_CREATE(taskDumpStatistics, "taskDumpStatistics", 4096, NULL, STATISTICS_DUMP_PRIORITY_LEVEL, &taskStatisticsDumpHandler_, OUTPUT_CORE);
 
-    // Start the update rpm task
-    success &= xTaskCreate(taskUpdateRpm, "taskUpdateRpm", 8196, NULL, RPM_PRIORITY_LEVEL, &taskRpmHandler_);
+    // Start the settings console, the settings can be retuned without a rebuild
+    success &= TASK_CREATE(taskReadSettings, "taskReadSettings", 4096, NULL, SETTINGS_CONSOLE_PRIORITY_LEVEL, &taskSettingsConsoleHandler_, OUTPUT_CORE);
 
     // Did everything work?
     if (!success) {
         // Logging
-        loggerCritical("Couldn't create one or more update tasks!");
+        loggerCritical("Couldn't subscribe to the sensors or create one or more update tasks!");
 
         return false;
     }
@@ -131,3 +374,42 @@ bool coreInit(void) {
     // Everything worked
     return true;
 }
+
+bool core_test(void) {
+    bool passed = true;
+    const SETTING setting = SETTING_SHIFT_LIGHT_PRIORITY;
+    const int32_t original = settingsGet(setting);
+    const int32_t changed = original > 0 ? original - 1 : original + 1;
+    char command[SETTINGS_LINE_LENGTH];
+    int priority = -1;
+    int32_t stored = -1;
+
+    // A command changes the priority of the job
+    snprintf(command, sizeof(command), "%s=%ld", settingsGetName(setting), (long) changed);
+    passed &= settingsApplyCommand(command);
+    passed &= schedulerGetJobPriority(shiftLightJobId_, &priority) && priority == changed;
+
+    // One out of range changes nothing
+    snprintf(command, sizeof(command), "%s=1000", settingsGetName(setting));
+    passed &= !settingsApplyCommand(command);
+    passed &= settingsGet(setting) == changed;
+
+    // Saving it stores it for the next boot as well
+    snprintf(command, sizeof(command), SETTINGS_SAVE_COMMAND "%s=%ld", settingsGetName(setting), (long) changed);
+    passed &= settingsApplyCommand(command);
+    passed &= settingsGetStored(setting, &stored) && stored == changed;
+
+    // Back to where it was, the stored value as well
+    passed &= settingsSet(setting, original, true);
+    passed &= settingsGetStored(setting, &stored) && stored == original;
+    passed &= schedulerGetJobPriority(shiftLightJobId_, &priority) && priority == original;
+
+    // Logging
+    if (passed) {
+        loggerInfo("Core tests passed");
+    } else {
+        loggerError("Core tests FAILED");
+    }
+
+    return passed;
+}
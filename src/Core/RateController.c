@@ -0,0 +1,136 @@
+/* --- Includes --- */
+#include "Core/RateController.h"
+
+// C includes
+#include <stdlib.h>
+
+// espidf includes
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// State of one channel
+typedef struct {
+    RateControllerLimits limits;
+    bool configured;
+    uint32_t intervalMs;
+    uint8_t steadySamples;
+
+    // The last fed value
+    bool hasValue;
+    int32_t lastValue;
+    int64_t lastFeedUs;
+
+    // Average time between two feeds
+    int64_t averagePeriodUs;
+} RateChannel;
+
+static RateChannel channels_[SENSOR_COUNT];
+
+// The channels are fed by different tasks
+static portMUX_TYPE channelsLock_ = portMUX_INITIALIZER_UNLOCKED;
+
+/* --- Function implementations --- */
+bool rateControllerConfigure(const SENSOR sensorType, const RateControllerLimits *limits) {
+    // Are the limits valid?
+    if (sensorType >= SENSOR_COUNT || limits == NULL || limits->minIntervalMs == 0 || limits->minIntervalMs > limits->maxIntervalMs ||
+        limits->changePerSecond <= 0) {
+        // Logging
+        loggerError("Invalid rate limits for '%s'", sensorManagerGetSensorName(sensorType));
+
+        return false;
+    }
+
+    portENTER_CRITICAL(&channelsLock_);
+    channels_[sensorType] = (RateChannel) {
+            .limits = *limits,
+            .configured = true,
+            .intervalMs = limits->minIntervalMs,
+    };
+    portEXIT_CRITICAL(&channelsLock_);
+
+    return true;
+}
+
+uint32_t rateControllerFeed(const SENSOR sensorType, const int32_t value) {
+    // Is the channel valid?
+    if (sensorType >= SENSOR_COUNT || !channels_[sensorType].configured) return 0;
+
+    const int64_t now = esp_timer_get_time();
+    RateChannel *channel = &channels_[sensorType];
+
+    portENTER_CRITICAL(&channelsLock_);
+
+    if (channel->hasValue) {
+        const int64_t elapsedUs = now - channel->lastFeedUs;
+
+        // Update the effective rate, the first period seeds the average
+        if (channel->averagePeriodUs == 0) {
+            channel->averagePeriodUs = elapsedUs;
+        } else {
+            channel->averagePeriodUs += (elapsedUs - channel->averagePeriodUs) >> RATE_CONTROLLER_AVERAGE_SHIFT;
+        }
+
+        // Compare the change per second, not per sample. Otherwise a shorter interval would make the
+        // same movement look steady and the channel would oscillate between its limits
+        const int64_t change = llabs((int64_t) value - channel->lastValue);
+        const bool changingFast = elapsedUs > 0 && change * 1000000 >= (int64_t) channel->limits.changePerSecond * elapsedUs;
+
+        if (changingFast) {
+            // Sample twice as often
+            channel->intervalMs /= 2;
+            if (channel->intervalMs < channel->limits.minIntervalMs) channel->intervalMs = channel->limits.minIntervalMs;
+            channel->steadySamples = 0;
+        } else if (++channel->steadySamples >= RATE_CONTROLLER_STEADY_SAMPLES) {
+            // Back off slowly
+            channel->intervalMs += channel->intervalMs / 2;
+            if (channel->intervalMs > channel->limits.maxIntervalMs) channel->intervalMs = channel->limits.maxIntervalMs;
+            channel->steadySamples = 0;
+        }
+    }
+
+    channel->hasValue = true;
+    channel->lastValue = value;
+    channel->lastFeedUs = now;
+    const uint32_t intervalMs = channel->intervalMs;
+
+    portEXIT_CRITICAL(&channelsLock_);
+
+    return intervalMs;
+}
+
+uint32_t rateControllerGetIntervalMs(const SENSOR sensorType) {
+    // Is the channel valid?
+    if (sensorType >= SENSOR_COUNT || !channels_[sensorType].configured) return 0;
+
+    return channels_[sensorType].intervalMs;
+}
+
+int32_t rateControllerGetEffectiveRate(const SENSOR sensorType) {
+    // Is the channel valid?
+    if (sensorType >= SENSOR_COUNT) return 0;
+
+    portENTER_CRITICAL(&channelsLock_);
+    const int64_t averagePeriodUs = channels_[sensorType].averagePeriodUs;
+    portEXIT_CRITICAL(&channelsLock_);
+
+    // Not enough samples yet?
+    if (averagePeriodUs <= 0) return 0;
+    return fixedPointFrequencyFromPeriod(averagePeriodUs);
+}
+
+void rateControllerDump(void) {
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++) {
+        if (!channels_[sensor].configured) continue;
+
+        const int32_t rate = rateControllerGetEffectiveRate(sensor);
+
+        // Logging
+        loggerInfo("Rate %s: interval=%lums (%lu..%lums) effective=%ld.%03ldHz", sensorManagerGetSensorName(sensor),
+                   (unsigned long) rateControllerGetIntervalMs(sensor), (unsigned long) channels_[sensor].limits.minIntervalMs,
+                   (unsigned long) channels_[sensor].limits.maxIntervalMs, (long) (rate / 1000), (long) (rate % 1000));
+    }
+}
@@ -0,0 +1,287 @@
+/* --- Includes --- */
+#include "Core/Scheduler.h"
+
+// Project includes
+#include "macros.h"
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// A slot of the job table
+typedef struct {
+    bool used;
+    uint32_t generation;// Changes whenever the slot is reused, so a run can tell if its job was removed meanwhile
+    const char *name;
+    SchedulerJobFunction function;
+    void *context;
+    uint32_t periodMs;
+    int priority;
+    int64_t deadlineUs;// When the job is released next [esp_timer time in us]
+
+    // Timing, meanLatenessUs is only calculated when it is read
+    SchedulerJobStats stats;
+    int64_t sumLatenessUs;
+} SchedulerJob;
+
+static SchedulerJob jobs_[SCHEDULER_MAX_JOBS];
+
+// Jobs are added and removed by other tasks
+static portMUX_TYPE jobsLock_ = portMUX_INITIALIZER_UNLOCKED;
+
+// Task handler, it is notified whenever the table changes or the next deadline is reached
+static TaskHandle_t taskSchedulerHandler_ = NULL;
+
+// Wakes the task at the next deadline
+static esp_timer_handle_t wakeUpTimer_ = NULL;
+
+//! \brief Wakes the scheduler task. Called by the wake up timer and whenever the table changes
+static void wakeUpScheduler(void *arg) {
+    if (taskSchedulerHandler_ != NULL) xTaskNotifyGive(taskSchedulerHandler_);
+}
+
+//! \brief Picks the job to run next. Must be called with the lock taken
+//! \param now The current time [esp_timer time in us]
+//! \param nextDeadlineUs Set to the earliest deadline if no job is due, INT64_MAX if there is no job at all
+//! \retval The index of the job or -1 if none is due
+static int pickJob(const int64_t now, int64_t *nextDeadlineUs) {
+    int picked = -1;
+    *nextDeadlineUs = INT64_MAX;
+
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        const SchedulerJob *job = &jobs_[i];
+        if (!job->used) continue;
+
+        // Not due yet -> only its deadline matters
+        if (job->deadlineUs > now) {
+            if (job->deadlineUs < *nextDeadlineUs) *nextDeadlineUs = job->deadlineUs;
+            continue;
+        }
+
+        // Due -> the highest priority, then the earliest deadline
+        if (picked < 0 || job->priority > jobs_[picked].priority ||
+            (job->priority == jobs_[picked].priority && job->deadlineUs < jobs_[picked].deadlineUs)) {
+            picked = i;
+        }
+    }
+
+    return picked;
+}
+
+//! \brief Adds a run to the timing of a job. Must be called with the lock taken
+//! \param job The job
+//! \param startUs When the run started [esp_timer time in us]
+//! \param endUs When the run was done [esp_timer time in us]
+//! \param nextReleaseUs When the next period started [esp_timer time in us]
+static void recordRun(SchedulerJob *job, const int64_t startUs, const int64_t endUs, const int64_t nextReleaseUs) {
+    SchedulerJobStats *stats = &job->stats;
+    const int64_t latenessUs = startUs - job->deadlineUs;
+
+    // Jitter
+    if (stats->runs == 0 || latenessUs < stats->minLatenessUs) stats->minLatenessUs = latenessUs;
+    if (stats->runs == 0 || latenessUs > stats->maxLatenessUs) stats->maxLatenessUs = latenessUs;
+    job->sumLatenessUs += latenessUs;
+    stats->runs++;
+
+    // Run time
+    if (endUs - startUs > stats->maxRunTimeUs) stats->maxRunTimeUs = endUs - startUs;
+
+    // Done after the next release?
+    if (endUs > nextReleaseUs) {
+        const int64_t overrunUs = endUs - nextReleaseUs;
+        stats->missedDeadlines++;
+        stats->sumOverrunUs += overrunUs;
+        if (overrunUs > stats->maxOverrunUs) stats->maxOverrunUs = overrunUs;
+    }
+}
+
+/* --- Tasks --- */
+
+//! \brief Task, which runs the jobs. It always runs the most important due job and otherwise sleeps
+//! until the wake up timer fires at the next deadline or the table changes
+static void IRAM_ATTR taskScheduler(void *params) {
+    // ReSharper disable once CppDFAEndlessLoop
+    while (1) {
+        // What's next?
+        const int64_t now = esp_timer_get_time();
+        int64_t nextDeadlineUs;
+        portENTER_CRITICAL(&jobsLock_);
+        const int index = pickJob(now, &nextDeadlineUs);
+        const SchedulerJob job = index >= 0 ? jobs_[index] : (SchedulerJob) {0};
+        portEXIT_CRITICAL(&jobsLock_);
+
+        // Nothing due -> sleep until the next deadline. A change of the table wakes it up earlier
+        if (index < 0) {
+            esp_timer_stop(wakeUpTimer_);
+            if (nextDeadlineUs != INT64_MAX) esp_timer_start_once(wakeUpTimer_, (uint64_t) (nextDeadlineUs - now));
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        // Run it
+        const uint32_t intervalMs = job.function(job.context);
+        const int64_t end = esp_timer_get_time();
+
+        portENTER_CRITICAL(&jobsLock_);
+        SchedulerJob *slot = &jobs_[index];
+        if (slot->used && slot->generation == job.generation) {
+            // The next release is relative to this one so the period doesn't drift
+            const int64_t periodUs = (int64_t) (intervalMs > 0 ? intervalMs : slot->periodMs) * 1000;
+            const int64_t nextReleaseUs = slot->deadlineUs + periodUs;
+            recordRun(slot, now, end, nextReleaseUs);
+
+            // If it is more than a whole period behind, start over from now instead of catching up
+            slot->deadlineUs = nextReleaseUs < now ? now + periodUs : nextReleaseUs;
+        }
+        portEXIT_CRITICAL(&jobsLock_);
+    }
+}
+
+/* --- Function implementations --- */
+bool schedulerInit(const UBaseType_t taskPriority, const BaseType_t core) {
+    // Only once
+    if (taskSchedulerHandler_ != NULL) return true;
+
+    // Create the wake up timer, it only notifies the task
+    const esp_timer_create_args_t timerArgs = {
+            .callback = wakeUpScheduler,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "scheduler",
+    };
+    if (esp_timer_create(&timerArgs, &wakeUpTimer_) != ESP_OK) {
+        // Logging
+        loggerCritical("Couldn't create the scheduler wake up timer!");
+
+        return false;
+    }
+
+    if (TASK_CREATE(taskScheduler, "taskScheduler", SCHEDULER_TASK_STACK_SIZE, NULL, taskPriority, &taskSchedulerHandler_, core) != pdPASS) {
+        // Logging
+        loggerCritical("Couldn't create the scheduler task!");
+
+        return false;
+    }
+
+    return true;
+}
+
+int schedulerAddJob(const char *name, const SchedulerJobFunction function, void *context, const uint32_t periodMs, const uint32_t phaseMs, const int priority) {
+    // Are the parameters valid?
+    if (function == NULL || periodMs == 0) return -1;
+
+    // Take a free slot
+    const int64_t now = esp_timer_get_time();
+    int jobId = -1;
+    portENTER_CRITICAL(&jobsLock_);
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        if (jobs_[i].used) continue;
+
+        jobs_[i] = (SchedulerJob) {
+                .used = true,
+                .generation = jobs_[i].generation + 1,
+                .name = name,
+                .function = function,
+                .context = context,
+                .periodMs = periodMs,
+                .priority = priority,
+                .deadlineUs = now + (int64_t) phaseMs * 1000,
+        };
+        jobId = i;
+        break;
+    }
+    portEXIT_CRITICAL(&jobsLock_);
+
+    if (jobId < 0) {
+        // Logging
+        loggerError("Couldn't add the job '%s', all %d slots are taken", name, SCHEDULER_MAX_JOBS);
+
+        return -1;
+    }
+
+    // It may be due before the one the scheduler is waiting for
+    wakeUpScheduler(NULL);
+
+    return jobId;
+}
+
+bool schedulerRemoveJob(const int jobId) {
+    // Is the id valid?
+    if (jobId < 0 || jobId >= SCHEDULER_MAX_JOBS) return false;
+
+    portENTER_CRITICAL(&jobsLock_);
+    const bool found = jobs_[jobId].used;
+    jobs_[jobId].used = false;
+    portEXIT_CRITICAL(&jobsLock_);
+
+    return found;
+}
+
+bool schedulerSetJobPriority(const int jobId, const int priority) {
+    // Is the id valid?
+    if (jobId < 0 || jobId >= SCHEDULER_MAX_JOBS) return false;
+
+    portENTER_CRITICAL(&jobsLock_);
+    const bool found = jobs_[jobId].used;
+    jobs_[jobId].priority = priority;
+    portEXIT_CRITICAL(&jobsLock_);
+
+    return found;
+}
+
+bool schedulerGetJobPriority(const int jobId, int *priority) {
+    // Is the id valid?
+    if (jobId < 0 || jobId >= SCHEDULER_MAX_JOBS) return false;
+
+    portENTER_CRITICAL(&jobsLock_);
+    const bool found = jobs_[jobId].used;
+    *priority = jobs_[jobId].priority;
+    portEXIT_CRITICAL(&jobsLock_);
+
+    return found;
+}
+
+bool schedulerSetTaskPriority(const UBaseType_t taskPriority) {
+    // Is the task running?
+    if (taskSchedulerHandler_ == NULL) return false;
+
+    vTaskPrioritySet(taskSchedulerHandler_, taskPriority);
+
+    return true;
+}
+
+bool schedulerGetStats(const int jobId, SchedulerJobStats *stats) {
+    // Is the id valid?
+    if (jobId < 0 || jobId >= SCHEDULER_MAX_JOBS) return false;
+
+    portENTER_CRITICAL(&jobsLock_);
+    const SchedulerJob job = jobs_[jobId];
+    portEXIT_CRITICAL(&jobsLock_);
+    if (!job.used) return false;
+
+    *stats = job.stats;
+    stats->meanLatenessUs = job.stats.runs > 0 ? job.sumLatenessUs / job.stats.runs : 0;
+
+    return true;
+}
+
+void schedulerResetStats(void) {
+    portENTER_CRITICAL(&jobsLock_);
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        jobs_[i].stats = (SchedulerJobStats) {0};
+        jobs_[i].sumLatenessUs = 0;
+    }
+    portEXIT_CRITICAL(&jobsLock_);
+}
+
+void schedulerDump(void) {
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        // Copy it, logging takes way too long to do it with the lock taken
+        SchedulerJobStats stats;
+        if (!schedulerGetStats(i, &stats) || stats.runs == 0) continue;
+
+        // Logging
+        loggerInfo("Job %s: n=%lu lateness min=%lldus mean=%lldus max=%lldus, max. run time %lldus, missed %lu (overrun max=%lldus sum=%lldus)", jobs_[i].name,
+                   (unsigned long) stats.runs, stats.minLatenessUs, stats.meanLatenessUs, stats.maxLatenessUs, stats.maxRunTimeUs, (unsigned long) stats.missedDeadlines,
+                   stats.maxOverrunUs, stats.sumOverrunUs);
+    }
+}
@@ -0,0 +1,116 @@
+/* --- Includes --- */
+#include "Core/ThermalGovernor.h"
+
+// C includes
+#include <stdlib.h>
+
+// espidf includes
+#include <esp_pm.h>
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// Everything runs as configured on NORMAL, every level above scales back a bit more
+static const ThermalLevelConfig levels_[THERMAL_LEVEL_COUNT] = {
+        [THERMAL_LEVEL_NORMAL] = {0, INT32_MAX, 4, 240},
+        [THERMAL_LEVEL_WARM] = {100, INT32_MAX, 3, 240},
+        [THERMAL_LEVEL_HOT] = {250, 40000000, 3, 160},
+        [THERMAL_LEVEL_CRITICAL] = {500, 20000000, 2, 80},
+};
+
+// Printable names of the levels
+static const char *levelNames_[THERMAL_LEVEL_COUNT] = {
+        [THERMAL_LEVEL_NORMAL] = "normal",
+        [THERMAL_LEVEL_WARM] = "warm",
+        [THERMAL_LEVEL_HOT] = "hot",
+        [THERMAL_LEVEL_CRITICAL] = "critical",
+};
+
+static THERMAL_LEVEL level_ = THERMAL_LEVEL_NORMAL;
+
+//! \brief Sets the CPU frequency, light sleep stays off
+//! \retval Boolean indicating if it worked
+static bool setCpuFrequency(const int frequencyMHz) {
+    const esp_pm_config_t pmConfig = {
+            .max_freq_mhz = frequencyMHz,
+            .min_freq_mhz = frequencyMHz,
+            .light_sleep_enable = false,
+    };
+    return esp_pm_configure(&pmConfig) == ESP_OK;
+}
+
+//! \brief Returns what a level runs with: the settings, capped by the level
+//! \param level The level
+//! \retval The effective config
+static ThermalLevelConfig getEffectiveConfig(const THERMAL_LEVEL level) {
+    ThermalLevelConfig config = levels_[level];
+
+    const uint32_t refreshMs = settingsGet(SETTING_GUI_REFRESH_PERIOD_MS);
+    if (refreshMs > config.lowPriorityRefreshMs) config.lowPriorityRefreshMs = refreshMs;
+    const int spiSpeedHz = settingsGet(SETTING_GUI_SPI_SPEED_HZ);
+    if (spiSpeedHz < config.spiSpeedHz) config.spiSpeedHz = spiSpeedHz;
+    const int loggingLevel = settingsGet(SETTING_LOGGING_LEVEL);
+    if (loggingLevel < config.maxLoggingLevel) config.maxLoggingLevel = loggingLevel;
+
+    return config;
+}
+
+//! \brief Applies everything of a level
+//! \param level The level
+static void apply(const THERMAL_LEVEL level) {
+    const ThermalLevelConfig config = getEffectiveConfig(level);
+
+    // Never log more than configured
+    loggerSetLevel(config.maxLoggingLevel);
+
+    // The speed and rpm displays keep their refresh rate
+    guiSetLowPriorityRefreshPeriod(config.lowPriorityRefreshMs);
+    guiSetSpiSpeed(config.spiSpeedHz);
+
+    if (!setCpuFrequency(config.cpuFrequencyMHz)) {
+        // Logging
+        loggerError("Couldn't set the CPU frequency to %d MHz", config.cpuFrequencyMHz);
+    }
+}
+
+//! \brief Writes a level change and what the new level runs with to the log
+static void logTransition(const THERMAL_LEVEL oldLevel, const THERMAL_LEVEL newLevel, const int32_t deciCelsius) {
+    const ThermalLevelConfig config = getEffectiveConfig(newLevel);
+
+    // Logging
+    loggerWarn("Board temperature %s%ld.%ld C: thermal level %s -> %s (temp display %lums, SPI %dHz, log level %d, CPU %dMHz)",
+               deciCelsius < 0 ? "-" : "", labs(deciCelsius) / 10, labs(deciCelsius) % 10, levelNames_[oldLevel], levelNames_[newLevel],
+               (unsigned long) config.lowPriorityRefreshMs, config.spiSpeedHz, config.maxLoggingLevel, config.cpuFrequencyMHz);
+}
+
+/* --- Function implementations --- */
+void thermalGovernorSetTemperature(const SensorSample *sample) {
+    // A failed reading says nothing about the temperature
+    if (sample->quality & SAMPLE_QUALITY_READ_FAILED) return;
+
+    const THERMAL_LEVEL oldLevel = level_;
+    const THERMAL_LEVEL newLevel = thermalLevelDecide(oldLevel, sample->value);
+    if (newLevel == oldLevel) return;
+    level_ = newLevel;
+
+    if (newLevel > oldLevel) {
+        // Logging (before the log level may drop)
+        logTransition(oldLevel, newLevel, sample->value);
+
+        apply(newLevel);
+    } else {
+        apply(newLevel);
+
+        // Logging (after the log level was raised again)
+        logTransition(oldLevel, newLevel, sample->value);
+    }
+}
+
+void thermalGovernorApply(void) {
+    apply(level_);
+}
+
+THERMAL_LEVEL thermalGovernorGetLevel(void) {
+    return level_;
+}
@@ -0,0 +1,56 @@
+/* --- Includes --- */
+#include "Core/ThermalLevel.h"
+
+// Project includes
+#include "Logger/Logger.h"
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// The temperature every level is entered at
+static const int32_t enterDeciCelsius_[THERMAL_LEVEL_COUNT] = {
+        [THERMAL_LEVEL_NORMAL] = INT32_MIN,
+        [THERMAL_LEVEL_WARM] = THERMAL_LEVEL_WARM_DECI_CELSIUS,
+        [THERMAL_LEVEL_HOT] = THERMAL_LEVEL_HOT_DECI_CELSIUS,
+        [THERMAL_LEVEL_CRITICAL] = THERMAL_LEVEL_CRITICAL_DECI_CELSIUS,
+};
+
+/* --- Function implementations --- */
+THERMAL_LEVEL thermalLevelDecide(const THERMAL_LEVEL level, const int32_t deciCelsius) {
+    // Hotter?
+    if (level + 1 < THERMAL_LEVEL_COUNT && deciCelsius >= enterDeciCelsius_[level + 1]) return level + 1;
+
+    // Cooled down enough?
+    if (level > THERMAL_LEVEL_NORMAL && deciCelsius < enterDeciCelsius_[level] - THERMAL_LEVEL_HYSTERESIS_DECI_CELSIUS) return level - 1;
+
+    return level;
+}
+
+bool thermalLevel_test(void) {
+    bool passed = true;
+
+    // Heating up goes one level per step
+    passed &= thermalLevelDecide(THERMAL_LEVEL_NORMAL, 599) == THERMAL_LEVEL_NORMAL;
+    passed &= thermalLevelDecide(THERMAL_LEVEL_NORMAL, 600) == THERMAL_LEVEL_WARM;
+    passed &= thermalLevelDecide(THERMAL_LEVEL_NORMAL, 900) == THERMAL_LEVEL_WARM;
+    passed &= thermalLevelDecide(THERMAL_LEVEL_WARM, 900) == THERMAL_LEVEL_HOT;
+    passed &= thermalLevelDecide(THERMAL_LEVEL_HOT, 900) == THERMAL_LEVEL_CRITICAL;
+    passed &= thermalLevelDecide(THERMAL_LEVEL_CRITICAL, 900) == THERMAL_LEVEL_CRITICAL;
+
+    // Cooling down needs the hysteresis
+    passed &= thermalLevelDecide(THERMAL_LEVEL_CRITICAL, 760) == THERMAL_LEVEL_CRITICAL;
+    passed &= thermalLevelDecide(THERMAL_LEVEL_CRITICAL, 749) == THERMAL_LEVEL_HOT;
+    passed &= thermalLevelDecide(THERMAL_LEVEL_HOT, 680) == THERMAL_LEVEL_HOT;
+    passed &= thermalLevelDecide(THERMAL_LEVEL_WARM, 549) == THERMAL_LEVEL_NORMAL;
+    passed &= thermalLevelDecide(THERMAL_LEVEL_NORMAL, -200) == THERMAL_LEVEL_NORMAL;
+
+    // Logging
+    if (passed) {
+        loggerInfo("Thermal level tests passed");
+    } else {
+        loggerError("Thermal level tests FAILED");
+    }
+
+    return passed;
+}
@@ -0,0 +1,169 @@
+/* --- Includes --- */
+#include "EventBus/EventBus.h"
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// A subscriber and its queue
+typedef struct {
+    const char *name;
+    uint32_t topics;
+    EVENT_BUS_POLICY policy;
+
+    // Ring buffer in the pool, head is the oldest sample
+    SensorSample *queue;
+    int length;
+    int head;
+    int count;
+
+    EventBusStats stats;
+
+    // Counts the queued samples, the receiver waits on it
+    SemaphoreHandle_t samples;
+    StaticSemaphore_t samplesBuffer;
+
+    // Counts the free slots, only EVENT_BUS_BLOCK publishers wait on it
+    SemaphoreHandle_t spaces;
+    StaticSemaphore_t spacesBuffer;
+} Subscriber;
+
+static Subscriber subscribers_[EVENT_BUS_MAX_SUBSCRIBERS];
+static volatile int subscriberCount_ = 0;
+
+// The queues of all subscribers
+static SensorSample pool_[EVENT_BUS_POOL_LENGTH];
+static int poolUsed_ = 0;
+
+// Protects the queues and counters, publishers and receivers run on different tasks
+static portMUX_TYPE queuesLock_ = portMUX_INITIALIZER_UNLOCKED;
+
+//! \brief Puts a sample into the queue of a subscriber according to its policy. Must be called with the lock taken
+//! \param subscriber The subscriber
+//! \param sample The sample
+//! \retval Boolean indicating if the queue got longer, only then the receiver has to be woken up
+static bool enqueue(Subscriber *subscriber, const SensorSample *sample) {
+    // Replace a queued sample of the same sensor, only the latest value matters
+    if (subscriber->policy == EVENT_BUS_KEEP_LATEST) {
+        for (int i = 0; i < subscriber->count; i++) {
+            SensorSample *queued = &subscriber->queue[(subscriber->head + i) % subscriber->length];
+            if (queued->id == sample->id) {
+                *queued = *sample;
+                subscriber->stats.replaced++;
+                return false;
+            }
+        }
+    }
+
+    // Full -> overwrite the oldest one. A blocking subscriber always has a free slot reserved
+    if (subscriber->count == subscriber->length) {
+        subscriber->queue[subscriber->head] = *sample;
+        subscriber->head = (subscriber->head + 1) % subscriber->length;
+        subscriber->stats.dropped++;
+        return false;
+    }
+
+    subscriber->queue[(subscriber->head + subscriber->count) % subscriber->length] = *sample;
+    subscriber->count++;
+    if (subscriber->count > subscriber->stats.maxQueued) subscriber->stats.maxQueued = subscriber->count;
+
+    return true;
+}
+
+/* --- Function implementations --- */
+int eventBusSubscribe(const char *name, const uint32_t topics, const int queueLength, const EVENT_BUS_POLICY policy) {
+    // Is there room left?
+    if (queueLength <= 0 || subscriberCount_ >= EVENT_BUS_MAX_SUBSCRIBERS || poolUsed_ + queueLength > EVENT_BUS_POOL_LENGTH) {
+        // Logging
+        loggerError("Couldn't subscribe '%s' to the event bus, %d of %d subscribers and %d of %d samples are taken", name, subscriberCount_,
+                    EVENT_BUS_MAX_SUBSCRIBERS, poolUsed_, EVENT_BUS_POOL_LENGTH);
+
+        return -1;
+    }
+
+    Subscriber *subscriber = &subscribers_[subscriberCount_];
+    *subscriber = (Subscriber) {
+            .name = name,
+            .topics = topics,
+            .policy = policy,
+            .queue = &pool_[poolUsed_],
+            .length = queueLength,
+    };
+    subscriber->samples = xSemaphoreCreateCountingStatic(queueLength, 0, &subscriber->samplesBuffer);
+    subscriber->spaces = xSemaphoreCreateCountingStatic(queueLength, queueLength, &subscriber->spacesBuffer);
+    poolUsed_ += queueLength;
+
+    // Publish it only once it is complete
+    return subscriberCount_++;
+}
+
+void eventBusPublish(const SensorSample *sample) {
+    const uint32_t topic = EVENT_BUS_TOPIC(sample->id);
+
+    for (int i = 0; i < subscriberCount_; i++) {
+        Subscriber *subscriber = &subscribers_[i];
+        if (!(subscriber->topics & topic)) continue;
+
+        // A blocking subscriber has to make room first, but never stalls the publisher for long
+        if (subscriber->policy == EVENT_BUS_BLOCK && xSemaphoreTake(subscriber->spaces, pdMS_TO_TICKS(EVENT_BUS_BLOCK_TIMEOUT_MS)) != pdTRUE) {
+            portENTER_CRITICAL(&queuesLock_);
+            subscriber->stats.dropped++;
+            portEXIT_CRITICAL(&queuesLock_);
+            continue;
+        }
+
+        portENTER_CRITICAL(&queuesLock_);
+        const bool added = enqueue(subscriber, sample);
+        portEXIT_CRITICAL(&queuesLock_);
+
+        // Wake up the receiver
+        if (added) xSemaphoreGive(subscriber->samples);
+    }
+}
+
+bool eventBusReceive(const int subscriberId, SensorSample *sample, const TickType_t timeout) {
+    // Is the id valid?
+    if (subscriberId < 0 || subscriberId >= subscriberCount_) return false;
+    Subscriber *subscriber = &subscribers_[subscriberId];
+
+    // Wait for a sample
+    if (xSemaphoreTake(subscriber->samples, timeout) != pdTRUE) return false;
+
+    portENTER_CRITICAL(&queuesLock_);
+    const bool found = subscriber->count > 0;
+    if (found) {
+        *sample = subscriber->queue[subscriber->head];
+        subscriber->head = (subscriber->head + 1) % subscriber->length;
+        subscriber->count--;
+        subscriber->stats.delivered++;
+    }
+    portEXIT_CRITICAL(&queuesLock_);
+
+    // Let a waiting publisher in
+    if (found && subscriber->policy == EVENT_BUS_BLOCK) xSemaphoreGive(subscriber->spaces);
+
+    return found;
+}
+
+bool eventBusGetStats(const int subscriberId, EventBusStats *stats) {
+    // Is the id valid?
+    if (subscriberId < 0 || subscriberId >= subscriberCount_) return false;
+
+    portENTER_CRITICAL(&queuesLock_);
+    *stats = subscribers_[subscriberId].stats;
+    portEXIT_CRITICAL(&queuesLock_);
+
+    return true;
+}
+
+void eventBusDump(void) {
+    for (int i = 0; i < subscriberCount_; i++) {
+        // Copy it, logging takes way too long to do it with the lock taken
+        EventBusStats stats;
+        if (!eventBusGetStats(i, &stats)) continue;
+
+        // Logging
+        loggerInfo("Event bus %s: delivered=%lu replaced=%lu dropped=%lu max. queued=%u of %d", subscribers_[i].name, (unsigned long) stats.delivered,
+                   (unsigned long) stats.replaced, (unsigned long) stats.dropped, stats.maxQueued, subscribers_[i].length);
+    }
+}
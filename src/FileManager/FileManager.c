@@ -20,13 +20,11 @@ bool spiffsMounted_ = false;
 //! \brief Builds the whole path depending on the location
 //! \param path The path that should be checked
 //! \param location The location e.g. SD Card or Internal
-//! \retval char* which contains the full path. Check for NULL!
-char *buildFullPath(const char *path, const int location) {
-    // Contains the full path to the file
-    char *fullPath = malloc(strlen("/sdcard/") + strlen(path) + 1);
-    if (fullPath == NULL) return false;
-
+//! \param fullPath Where the full path is written to, FILEMANAGER_MAX_PATH_LENGTH bytes
+//! \retval Boolean indicating if the location is mounted and the path fits
+static bool buildFullPath(const char *path, const int location, char *fullPath) {
     // Check the location
+    const char *prefix = NULL;
     if (location == LOCATION_INTERNAL) {
         // Is the spiffs partition mounted?
         if (!spiffsMounted_) {
@@ -34,12 +32,10 @@ char *buildFullPath(const char *path, const int location) {
             loggerError("Spiffs partition not mounted");
 
             // No so stop here!
-            free(fullPath);
             return false;
         }
 
-        // Yes, so build the full path
-        sprintf(fullPath, "%s%s", "/spiffs/", path);
+        prefix = "/spiffs/";
     } else if (location == LOCATION_SDCARD) {
         // Is the SD Card mounted?
         if (!sdCardMounted_) {
@@ -47,19 +43,36 @@ char *buildFullPath(const char *path, const int location) {
             loggerError("SD Card not mounted");
 
             // No so stop here!
-            free(fullPath);
             return false;
         }
 
-        // Yes, so build the full path
-        sprintf(fullPath, "%s%s", "/sdcard/", path);
+        prefix = "/sdcard/";
+    } else {
+        return false;
+    }
+
+    // Yes, so build the full path
+    if (snprintf(fullPath, FILEMANAGER_MAX_PATH_LENGTH, "%s%s", prefix, path) >= FILEMANAGER_MAX_PATH_LENGTH) {
+        // Logging
+        loggerError("Path too long: %s", path);
+
+        return false;
     }
 
-    return fullPath;
+    return true;
 }
 
 /* --- Function implementations --- */
 bool fileManagerInit(void) {
+    // Both, they are independent of each other
+    const bool sdCardMounted = fileManagerMountSdCard();
+    const bool spiffsMounted = fileManagerMountSpiffs();
+
+    // Return success
+    return spiffsMounted || sdCardMounted;
+}
+
+bool fileManagerMountSdCard(void) {
     /* Initializing the micro SDCard slot */
 
     // Initialize the SDMMC host
@@ -94,6 +107,10 @@ bool fileManagerInit(void) {
         loggerError("Mounting failed with error");
     }
 
+    return sdCardMounted_;
+}
+
+bool fileManagerMountSpiffs(void) {
     /* Initialize spiffs partition */
 
     // Initialize spiffs config
@@ -120,9 +137,7 @@ bool fileManagerInit(void) {
         loggerError("Mounting spiffs partition failed");
     }
 
-    // Return success
-    return spiffsMounted_
-            || sdCardMounted_;
+    return spiffsMounted_;
 }
 
 bool fileManagerCreateFile(const char *path, const int location) {
@@ -134,7 +149,8 @@ bool fileManagerCreateFile(const char *path, const int location) {
     }
 
     // Contains the full path to the file
-    char *fullPath = buildFullPath(path, location);
+    char fullPath[FILEMANAGER_MAX_PATH_LENGTH];
+    if (!buildFullPath(path, location, fullPath)) return false;
 
     // For whatever reason fopen crashes with test.txt. I have absolutely no clue why but it costed me quite a few
     // hours until I found the crashes are caused by this :C
@@ -150,9 +166,6 @@ bool fileManagerCreateFile(const char *path, const int location) {
             // Logging
             loggerError("Failed creating file %s", fullPath);
 
-            // Free the fullPath
-            free(fullPath);
-
             // Then return NULL
             return false;
         }
@@ -161,8 +174,7 @@ bool fileManagerCreateFile(const char *path, const int location) {
         fclose(file);
     }
 
-    // Yes, free the path and return true
-    free(fullPath);
+    // Yes, return true
     return true;
 }
 
@@ -175,14 +187,12 @@ bool fileManagerDoesFileExists(const char *path, const int location) {
     }
 
     // Contains the full path to the file
-    char *fullPath = buildFullPath(path, location);
+    char fullPath[FILEMANAGER_MAX_PATH_LENGTH];
+    if (!buildFullPath(path, location, fullPath)) return false;
 
     // Try to access that path
     const bool result = access(fullPath, F_OK);// 0 -> success ; 1 -> error
 
-    // Free the full path
-    free(fullPath);
-
     return !result;
 }
 
@@ -195,7 +205,8 @@ FILE *fileManagerOpenFile(const char *path, const char *mode, const int location
     }
 
     // Contains the full path to the file
-    char *fullPath = buildFullPath(path, location);
+    char fullPath[FILEMANAGER_MAX_PATH_LENGTH];
+    if (!buildFullPath(path, location, fullPath)) return NULL;
 
     // Try to create a file
     FILE *file = fopen(fullPath, mode);
@@ -205,15 +216,11 @@ FILE *fileManagerOpenFile(const char *path, const char *mode, const int location
         // Logging
         loggerError("Failed to open file. Path: %s ; Mode: %s", fullPath, mode);
 
-        // Free the fullPath
-        free(fullPath);
-
         // Then return NULL
         return NULL;
     }
 
-    // Yes, free the path and return the file
-    free(fullPath);
+    // Yes, return the file
     return file;
 }
 
@@ -226,7 +233,8 @@ bool fileManagerDeleteFile(const char *path, const int location) {
     }
 
     // Contains the full path to the file
-    char *fullPath = buildFullPath(path, location);
+    char fullPath[FILEMANAGER_MAX_PATH_LENGTH];
+    if (!buildFullPath(path, location, fullPath)) return false;
 
     // Try to delete the file
     const bool result = !remove(fullPath);// 0 -> success ;  1 -> error
@@ -238,9 +246,6 @@ bool fileManagerDeleteFile(const char *path, const int location) {
         loggerWarn("Failed deleting file: %s", fullPath);
     }
 
-    // Free the path
-    free(fullPath);
-
     return result;
 }
 
@@ -251,16 +256,14 @@ bool fileManagerDoesDirectoryExist(const char *dir) {
     }
 
     // Contains the full path to the file
-    char *fullPath = buildFullPath(dir, LOCATION_SDCARD);
+    char fullPath[FILEMANAGER_MAX_PATH_LENGTH];
+    if (!buildFullPath(dir, LOCATION_SDCARD, fullPath)) return false;
 
     // Does the path exist?
     struct stat stats;
     stat(fullPath, &stats);
     const bool result = S_ISDIR(stats.st_mode);
 
-    // Free fullPath
-    free(fullPath);
-
     // Return result
     return result;
 }
@@ -272,7 +275,8 @@ bool fileManagerCreateDir(const char *path) {
     }
 
     // Contains the full path to the file
-    char *fullPath = buildFullPath(path, LOCATION_SDCARD);
+    char fullPath[FILEMANAGER_MAX_PATH_LENGTH];
+    if (!buildFullPath(path, LOCATION_SDCARD, fullPath)) return false;
 
     // Create the path
     const bool result = mkdir(fullPath, S_IRWXU) == 0 ? true : false;// 0 -> success ; -1 -> error
@@ -283,9 +287,6 @@ bool fileManagerCreateDir(const char *path) {
         loggerWarn("Failed to create directory: %s", fullPath);
     }
 
-    // Free fullPath
-    free(fullPath);
-
     return result;
 }
 
@@ -296,7 +297,8 @@ bool fileManagerDeleteDir(const char *path) {
     }
 
     // Contains the full path to the file
-    char *fullPath = buildFullPath(path, LOCATION_SDCARD);
+    char fullPath[FILEMANAGER_MAX_PATH_LENGTH];
+    if (!buildFullPath(path, LOCATION_SDCARD, fullPath)) return false;
 
     // Create the path
     const bool result = rmdir(fullPath) == 0 ? true : false;// 0 -> success ; -1 -> error
@@ -307,9 +309,6 @@ bool fileManagerDeleteDir(const char *path) {
         loggerWarn("Failed to delete directory: %s", fullPath);
     }
 
-    // Free fullPath
-    free(fullPath);
-
     return result;
 }
 
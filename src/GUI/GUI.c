@@ -2,9 +2,15 @@
 #include "GUI/GUI.h"
 
 #include <Logger/Logger.h>
+#include <macros.h>
 
 /* --- Private Defines & Macros --- */
 
+// Indices of the displays for the latency tracing
+#define GUI_DISPLAY_TEMP 0 // display1_
+#define GUI_DISPLAY_RPM 1  // display2_
+#define GUI_DISPLAY_SPEED 2// display3_
+
 /* --- Private Variables, Typedefs etc. --- */
 
 // General display stuff
@@ -12,6 +18,13 @@ const size_t drawBufferSize_ = GUI_LCD_RES * GUI_LCD_RES * 2;
 esp_lcd_panel_dev_config_t lcdPanelConfig_;
 SemaphoreHandle_t semaphoreLvTaskHandle_;
 SemaphoreHandle_t semaphoreLvFlushHandle_;
+StaticSemaphore_t semaphoreLvTaskBuffer_;
+StaticSemaphore_t semaphoreLvFlushBuffer_;
+
+#if CONFIG_FIRMWARE_STATIC_ALLOCATION
+// The six draw buffers, in the PSRAM like the allocated ones
+EXT_RAM_BSS_ATTR static uint16_t drawBuffers_[6][GUI_LCD_RES * GUI_LCD_RES] __attribute__((aligned(LV_DRAW_BUF_ALIGN)));
+#endif
 
 // Display 1 management stuff
 esp_lcd_panel_io_handle_t lcdPanelIoHandle1_ = NULL;
@@ -37,10 +50,31 @@ uint16_t *drawBuffer31_ = NULL;
 uint16_t *drawBuffer32_ = NULL;
 bool firstFrameDrawnD3_ = false;
 
+// Color transfers in flight and if the last area of a frame was queued
+int pendingColorTransfers_[LATENCY_TRACER_MAX_DISPLAYS] = {0};
+volatile bool lastAreaQueued_[LATENCY_TRACER_MAX_DISPLAYS] = {false};
+
+// Given once all color transfers of a display finished, so LVGL can reuse the draw buffer
+SemaphoreHandle_t semaphoreTransfersDoneHandles_[LATENCY_TRACER_MAX_DISPLAYS];
+StaticSemaphore_t semaphoreTransfersDoneBuffers_[LATENCY_TRACER_MAX_DISPLAYS];
+
+// Requested state of the shift light, handed from its setter to the LVGL task
+volatile bool shiftLightActive_ = false;
+volatile bool shiftLightChanged_ = false;
+
+// The current SPI clock of the displays, the setting is taken at the initialization
+int spiSpeedHz_ = GUI_SPI_SPEED;
+
 // Variables indicating stati
 bool initSuccessful_ = false;
 int waitForFirstFrameCounter_ = 0;
 
+// Task handler, the shift light wakes it and only this task may render
+TaskHandle_t taskUpdateLvglHandle_ = NULL;
+
+// A frame was rendered on another task, it's only logged once
+bool renderedOnOtherTask_ = false;
+
 /* --- Private Variables: GUI --- */
 
 // Screen 1 - SPEEDOMETER
@@ -56,6 +90,7 @@ lv_style_t rpmLabelStyle_;
 lv_obj_t *rpmTitleLabel_ = NULL;
 lv_style_t rpmTitleStyle_;
 lv_obj_t *blinkerLeft_ = NULL;
+lv_obj_t *shiftLight_ = NULL;
 
 // Screen 3 - Temp and Fuel
 lv_obj_t *tempLabel_ = NULL;
@@ -93,6 +128,18 @@ void flushToDisplay2(lv_display_t *display, const lv_area_t *area, uint8_t *pxMa
 //! \param pxMap An array which contains the colors for each pixel
 void flushToDisplay3(lv_display_t *display, const lv_area_t *area, uint8_t *pxMap);
 
+//! \brief Callback function for LVGL to wait until the first physical display took the draw buffer
+//! \param display A pointer to the lvgl display
+void flushWaitDisplay1(lv_display_t *display);
+
+//! \brief Callback function for LVGL to wait until the second physical display took the draw buffer
+//! \param display A pointer to the lvgl display
+void flushWaitDisplay2(lv_display_t *display);
+
+//! \brief Callback function for LVGL to wait until the third physical display took the draw buffer
+//! \param display A pointer to the lvgl display
+void flushWaitDisplay3(lv_display_t *display);
+
 //! \brief Initializes the LVGL library
 //! \retval A boolean indicating if the operation was successful
 bool initLvgl(void);
@@ -109,22 +156,142 @@ void createAndShowRpmScreen(lv_display_t *display);
 //! \param display The display the screen should be displayed on
 void createAndShowTempScreen(lv_display_t *display);
 
+//! \brief Called from the SPI ISR once a color transfer to a display finished
+//! \param panelIo The panel io the transfer was made on
+//! \param eventData Unused
+//! \param userCtx The index of the display
+//! \retval Boolean indicating if a higher priority task was woken up
+bool IRAM_ATTR notifyColorTransferDone(esp_lcd_panel_io_handle_t panelIo, esp_lcd_panel_io_event_data_t *eventData, void *userCtx) {
+    const int display = (int) userCtx;
+
+    // Anything left in flight?
+    if (__atomic_sub_fetch(&pendingColorTransfers_[display], 1, __ATOMIC_SEQ_CST) != 0) return false;
+
+    // Was it the last transfer of the frame?
+    if (lastAreaQueued_[display]) {
+        lastAreaQueued_[display] = false;
+        latencyTracerMarkFlushed(display);
+    }
+
+    // The draw buffer is free again
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(semaphoreTransfersDoneHandles_[display], &higherPriorityTaskWoken);
+    return higherPriorityTaskWoken == pdTRUE;
+}
+
+//! \brief Blocks until all color transfers of a display finished. A give left over from an earlier
+//! wait only causes another pass through the loop
+//! \param display The index of the display
+void waitForColorTransfers(const int display) {
+    while (__atomic_load_n(&pendingColorTransfers_[display], __ATOMIC_SEQ_CST) > 0) {
+        xSemaphoreTake(semaphoreTransfersDoneHandles_[display], portMAX_DELAY);
+    }
+}
+
+//! \brief Called by LVGL before a display is refreshed. With LV_OS_NONE, LVGL renders on whichever task
+//! calls lv_timer_handler() or lv_refr_now(). Only taskUpdateLvgl has a stack sized for that
+//! \param event Unused
+void checkRenderingTask(lv_event_t *event) {
+    if (renderedOnOtherTask_ || xTaskGetCurrentTaskHandle() == taskUpdateLvglHandle_) return;
+    renderedOnOtherTask_ = true;
+
+    // Logging
+    loggerCritical("LVGL rendered on task \"%s\" instead of \"taskUpdateLvgl\", its stack may be too small", pcTaskGetName(NULL));
+}
+
+//! \brief Tick source of LVGL, which counts in milliseconds. A FreeRTOS tick is 10 ms with CONFIG_FREERTOS_HZ=100
+//! \retval The milliseconds since the scheduler started
+uint32_t getLvglTickMs(void) {
+    return pdTICKS_TO_MS(xTaskGetTickCount());
+}
+
+//! \brief Tracks a color transfer that is about to be queued, for the flush waiting and the latency tracing
+//! \param display The index of the display
+//! \param lastArea Boolean indicating if it is the last area of the frame
+void traceColorTransferQueued(const int display, const bool lastArea) {
+    __atomic_add_fetch(&pendingColorTransfers_[display], 1, __ATOMIC_SEQ_CST);
+    if (lastArea) lastAreaQueued_[display] = true;
+}
+
+//! \brief Untracks a color transfer that couldn't be queued, nothing would wait for it otherwise
+//! \param display The index of the display
+void traceColorTransferFailed(const int display) {
+    __atomic_sub_fetch(&pendingColorTransfers_[display], 1, __ATOMIC_SEQ_CST);
+    lastAreaQueued_[display] = false;
+}
+
+//! \brief Attaches a display to the SPI bus again with another clock. The panel itself isn't reset or
+//! initialized again, it keeps its content and configuration
+//! \param panelIo The panel io, replaced by the new one
+//! \param panel The panel, replaced by the new one
+//! \param csGpio The chip select of the display
+//! \param display The index of the display
+//! \param speedHz The new clock [in Hz]
+//! \retval Boolean indicating if it worked
+bool reattachDisplay(esp_lcd_panel_io_handle_t *panelIo, esp_lcd_panel_handle_t *panel, const gpio_num_t csGpio, const int display, const int speedHz) {
+    // Remove the old one, this waits for its last transfers
+    esp_lcd_panel_del(*panel);
+    esp_lcd_panel_io_del(*panelIo);
+
+    // Create the SPI config
+    const esp_lcd_panel_io_spi_config_t lcdPanelIoConfig = {
+            .dc_gpio_num = GUI_GPIO_LCD_DC,
+            .cs_gpio_num = csGpio,
+            .pclk_hz = speedHz,
+            .lcd_cmd_bits = 8,
+            .lcd_param_bits = 8,
+            .spi_mode = 0,
+            .trans_queue_depth = 10,
+            .on_color_trans_done = notifyColorTransferDone,
+            .user_ctx = (void *) display,
+    };
+
+    // Then attach it to the SPI bus
+    if (esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t) GUI_LCD_SPI_HOST, &lcdPanelIoConfig, panelIo) != ESP_OK) return false;
+    if (esp_lcd_new_panel_gc9a01(*panelIo, &lcdPanelConfig_, panel) != ESP_OK) return false;
+
+    // The new driver has to know the settings the panel still has
+    esp_lcd_panel_invert_color(*panel, true);
+    esp_lcd_panel_mirror(*panel, true, false);
+
+    return true;
+}
+
 /* --- Tasks --- */
 
 //! \brief Task which is needed for lvgl to work
 //! \param params void* needed for FreeRTOS to accept this function as task!
 void IRAM_ATTR taskUpdateLvgl(void *params) {
+    TickType_t lastWakeTime = xTaskGetTickCount();
+
+    // The creator sets the handle only once the task was created, it may already render before that
+    taskUpdateLvglHandle_ = xTaskGetCurrentTaskHandle();
+
     // ReSharper disable once CppDFAEndlessLoop
     while (1) {
         // Try to get the semaphore mutex
         if (xSemaphoreTake(semaphoreLvTaskHandle_, portMAX_DELAY) == pdTRUE) {
+            // Switch the shift light and refresh the rpm display now, only the area of the light is invalid
+            if (shiftLightChanged_) {
+                shiftLightChanged_ = false;
+                if (shiftLightActive_) {
+                    lv_obj_remove_flag(shiftLight_, LV_OBJ_FLAG_HIDDEN);
+                } else {
+                    lv_obj_add_flag(shiftLight_, LV_OBJ_FLAG_HIDDEN);
+                }
+                lv_timer_ready(lv_display_get_refr_timer(display2_));
+            }
+
             // Then run the lvgl task handler
             lv_timer_handler();
             xSemaphoreGive(semaphoreLvTaskHandle_);
-
-            // Wait 10ms
-            vTaskDelay(pdMS_TO_TICKS(10));
         }
+
+        // Wait for the next period, the time the handler took doesn't add to it. The shift light ends the wait early
+        const TickType_t period = pdMS_TO_TICKS(GUI_LVGL_TASK_PERIOD_MS);
+        const TickType_t elapsed = xTaskGetTickCount() - lastWakeTime;
+        if (elapsed < period && ulTaskNotifyTake(pdTRUE, period - elapsed) > 0) continue;
+        lastWakeTime += period;
     }
 }
 
@@ -138,10 +305,11 @@ void IRAM_ATTR taskWaitForFirstFrameDrawn(void *params) {
     bool display1Completed = false;
     bool display2Completed = false;
     bool display3Completed = false;
+    bool dashboardLive = false;
 
     while (1) {
-        // Wait 100ms before next try
-        vTaskDelay(pdMS_TO_TICKS(100));
+        // Wait before next try
+        vTaskDelay(pdMS_TO_TICKS(GUI_FIRST_FRAME_POLL_INTERVAL_MS));
 
         //! Check display 1
         if (firstFrameDrawnD1_ && !display1Completed) {
@@ -161,8 +329,14 @@ void IRAM_ATTR taskWaitForFirstFrameDrawn(void *params) {
             display3Completed = true;
         }
 
-        // Check if counter > 10 was reached
-        if (waitForFirstFrameCounter_++ > 10) {
+        // The dashboard is live once every display shows its first frame
+        if (display1Completed && display2Completed && display3Completed && !dashboardLive) {
+            bootProfilerMark("Dashboard live");
+            dashboardLive = true;
+        }
+
+        // Check if the timeout was reached
+        if (waitForFirstFrameCounter_++ > GUI_FIRST_FRAME_TIMEOUT_MS / GUI_FIRST_FRAME_POLL_INTERVAL_MS) {
             // Just turn them on, otherwise they will never light up
             ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(lcdPanelHandle1_, true));
             ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(lcdPanelHandle2_, true));
@@ -183,11 +357,13 @@ bool initDisplays(void) {
     const esp_lcd_panel_io_spi_config_t lcdPanel1IoConfig = {
             .dc_gpio_num = GUI_GPIO_LCD_DC,
             .cs_gpio_num = GUI_GPIO_LCD1_CS,
-            .pclk_hz = GUI_SPI_SPEED,
+            .pclk_hz = spiSpeedHz_,
             .lcd_cmd_bits = 8,
             .lcd_param_bits = 8,
             .spi_mode = 0,
             .trans_queue_depth = 10,
+            .on_color_trans_done = notifyColorTransferDone,
+            .user_ctx = (void *) GUI_DISPLAY_TEMP,
     };
 
     // Then attach it to the SPI bus
@@ -219,11 +395,13 @@ bool initDisplays(void) {
     const esp_lcd_panel_io_spi_config_t lcdPanel2IoConfig = {
             .dc_gpio_num = GUI_GPIO_LCD_DC,
             .cs_gpio_num = GUI_GPIO_LCD2_CS,
-            .pclk_hz = GUI_SPI_SPEED,
+            .pclk_hz = spiSpeedHz_,
             .lcd_cmd_bits = 8,
             .lcd_param_bits = 8,
             .spi_mode = 0,
             .trans_queue_depth = 10,
+            .on_color_trans_done = notifyColorTransferDone,
+            .user_ctx = (void *) GUI_DISPLAY_RPM,
     };
 
     // Then attach it to the SPI bus
@@ -244,11 +422,13 @@ bool initDisplays(void) {
     const esp_lcd_panel_io_spi_config_t lcdPanel3IoConfig = {
             .dc_gpio_num = GUI_GPIO_LCD_DC,
             .cs_gpio_num = GUI_GPIO_LCD3_CS,
-            .pclk_hz = GUI_SPI_SPEED,
+            .pclk_hz = spiSpeedHz_,
             .lcd_cmd_bits = 8,
             .lcd_param_bits = 8,
             .spi_mode = 0,
             .trans_queue_depth = 10,
+            .on_color_trans_done = notifyColorTransferDone,
+            .user_ctx = (void *) GUI_DISPLAY_SPEED,
     };
 
     // Then attach it to the SPI bus
@@ -266,47 +446,71 @@ bool initDisplays(void) {
 }
 
 void flushToDisplay1(lv_display_t *display, const lv_area_t *area, uint8_t *pxMap) {
+    // The area was rendered
+    latencyTracerMarkRendered(GUI_DISPLAY_TEMP);
+
     // Swap the color channels as needed
     lv_draw_sw_rgb565_swap(pxMap, (area->x2 + 1 - area->x1) * (area->y2 + 1 - area->y1));
 
     // Then draw the bitmap to the physical display (+1 needed, otherwise the image is distorted)
     if (xSemaphoreTake(semaphoreLvFlushHandle_, portMAX_DELAY) == pdTRUE) {
-        esp_lcd_panel_draw_bitmap(lcdPanelHandle1_, area->x1, area->y1, area->x2 + 1, area->y2 + 1, pxMap);
-        vTaskDelay(pdMS_TO_TICKS(GUI_DELAY_BETWEEN_DRAWING_MS));
+        traceColorTransferQueued(GUI_DISPLAY_TEMP, lv_display_flush_is_last(display));
+        if (esp_lcd_panel_draw_bitmap(lcdPanelHandle1_, area->x1, area->y1, area->x2 + 1, area->y2 + 1, pxMap) != ESP_OK) traceColorTransferFailed(GUI_DISPLAY_TEMP);
         xSemaphoreGive(semaphoreLvFlushHandle_);
     }
-    lv_display_flush_ready(display);
+
+    // The transfer is still running, flushWaitDisplay1() lets LVGL know once the buffer is free
     firstFrameDrawnD1_ = true;
 }
 
+void flushWaitDisplay1(lv_display_t *display) {
+    waitForColorTransfers(GUI_DISPLAY_TEMP);
+}
+
 void flushToDisplay2(lv_display_t *display, const lv_area_t *area, uint8_t *pxMap) {
+    // The area was rendered
+    latencyTracerMarkRendered(GUI_DISPLAY_RPM);
+
     // Swap the color channels as needed
     lv_draw_sw_rgb565_swap(pxMap, (area->x2 + 1 - area->x1) * (area->y2 + 1 - area->y1));
 
     // Then draw the bitmap to the physical display (+1 needed, otherwise the image is distorted)
     if (xSemaphoreTake(semaphoreLvFlushHandle_, portMAX_DELAY) == pdTRUE) {
-        esp_lcd_panel_draw_bitmap(lcdPanelHandle2_, area->x1, area->y1, area->x2 + 1, area->y2 + 1, pxMap);
-        vTaskDelay(pdMS_TO_TICKS(GUI_DELAY_BETWEEN_DRAWING_MS));
+        traceColorTransferQueued(GUI_DISPLAY_RPM, lv_display_flush_is_last(display));
+        if (esp_lcd_panel_draw_bitmap(lcdPanelHandle2_, area->x1, area->y1, area->x2 + 1, area->y2 + 1, pxMap) != ESP_OK) traceColorTransferFailed(GUI_DISPLAY_RPM);
         xSemaphoreGive(semaphoreLvFlushHandle_);
     }
-    lv_display_flush_ready(display);
+
+    // The transfer is still running, flushWaitDisplay2() lets LVGL know once the buffer is free
     firstFrameDrawnD2_ = true;
 }
 
+void flushWaitDisplay2(lv_display_t *display) {
+    waitForColorTransfers(GUI_DISPLAY_RPM);
+}
+
 void flushToDisplay3(lv_display_t *display, const lv_area_t *area, uint8_t *pxMap) {
+    // The area was rendered
+    latencyTracerMarkRendered(GUI_DISPLAY_SPEED);
+
     // Swap the color channels as needed
     lv_draw_sw_rgb565_swap(pxMap, (area->x2 + 1 - area->x1) * (area->y2 + 1 - area->y1));
 
     // Then draw the bitmap to the physical display (+1 needed, otherwise the image is distorted)
     if (xSemaphoreTake(semaphoreLvFlushHandle_, portMAX_DELAY) == pdTRUE) {
-        esp_lcd_panel_draw_bitmap(lcdPanelHandle3_, area->x1, area->y1, area->x2 + 1, area->y2 + 1, pxMap);
-        vTaskDelay(pdMS_TO_TICKS(GUI_DELAY_BETWEEN_DRAWING_MS));
+        traceColorTransferQueued(GUI_DISPLAY_SPEED, lv_display_flush_is_last(display));
+        if (esp_lcd_panel_draw_bitmap(lcdPanelHandle3_, area->x1, area->y1, area->x2 + 1, area->y2 + 1, pxMap) != ESP_OK) traceColorTransferFailed(GUI_DISPLAY_SPEED);
         xSemaphoreGive(semaphoreLvFlushHandle_);
     }
-    lv_display_flush_ready(display);
+
+    // The transfer is still running, flushWaitDisplay3() lets LVGL know once the buffer is free
     firstFrameDrawnD3_ = true;
 }
 
+void flushWaitDisplay3(lv_display_t *display) {
+    waitForColorTransfers(GUI_DISPLAY_SPEED);
+}
+
 bool initLvgl(void) {
     lv_init();
 
@@ -315,6 +519,15 @@ bool initLvgl(void) {
     display2_ = lv_display_create(GUI_LCD_RES, GUI_LCD_RES);
     display3_ = lv_display_create(GUI_LCD_RES, GUI_LCD_RES);
 
+#if CONFIG_FIRMWARE_STATIC_ALLOCATION
+    // Take the static draw buffers
+    drawBuffer11_ = drawBuffers_[0];
+    drawBuffer21_ = drawBuffers_[1];
+    drawBuffer31_ = drawBuffers_[2];
+    drawBuffer12_ = drawBuffers_[3];
+    drawBuffer22_ = drawBuffers_[4];
+    drawBuffer32_ = drawBuffers_[5];
+#else
     // Create the three draw buffers
     drawBuffer11_ = (uint16_t *) heap_caps_malloc(drawBufferSize_, MALLOC_CAP_SPIRAM);
     drawBuffer21_ = (uint16_t *) heap_caps_malloc(drawBufferSize_, MALLOC_CAP_SPIRAM);
@@ -324,6 +537,7 @@ bool initLvgl(void) {
     drawBuffer12_ = (uint16_t *) heap_caps_malloc(drawBufferSize_, MALLOC_CAP_SPIRAM);
     drawBuffer22_ = (uint16_t *) heap_caps_malloc(drawBufferSize_, MALLOC_CAP_SPIRAM);
     drawBuffer32_ = (uint16_t *) heap_caps_malloc(drawBufferSize_, MALLOC_CAP_SPIRAM);
+#endif
 
     // Check the draw buffers
     if (drawBuffer11_ == NULL || drawBuffer21_ == NULL || drawBuffer31_ == NULL) {
@@ -360,8 +574,18 @@ bool initLvgl(void) {
     lv_display_set_flush_cb(display2_, flushToDisplay2);
     lv_display_set_flush_cb(display3_, flushToDisplay3);
 
+    // Wait for the SPI transfers to finish, instead of assuming they are done once queued
+    lv_display_set_flush_wait_cb(display1_, flushWaitDisplay1);
+    lv_display_set_flush_wait_cb(display2_, flushWaitDisplay2);
+    lv_display_set_flush_wait_cb(display3_, flushWaitDisplay3);
+
+    // Check that every frame is rendered on the LVGL task
+    lv_display_add_event_cb(display1_, checkRenderingTask, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(display2_, checkRenderingTask, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(display3_, checkRenderingTask, LV_EVENT_REFR_START, NULL);
+
     // Set tick interface
-    lv_tick_set_cb(xTaskGetTickCount);
+    lv_tick_set_cb(getLvglTickMs);
 
     // Everything was successful
     return true;
@@ -465,6 +689,20 @@ void createAndShowRpmScreen(lv_display_t *display) {
 
     // Disable the blinker visually
     guiSetLeftBlinkerActive(false);
+
+    // Create the shift light, a red bar at the top
+    shiftLight_ = lv_obj_create(screen);
+    lv_obj_remove_style_all(shiftLight_);
+    lv_obj_set_size(shiftLight_, GUI_SHIFT_LIGHT_WIDTH, GUI_SHIFT_LIGHT_HEIGHT);
+    lv_obj_set_style_radius(shiftLight_, LV_RADIUS_CIRCLE, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(shiftLight_, lv_color_hex(GUI_SHIFT_LIGHT_COLOR), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(shiftLight_, LV_OPA_COVER, LV_PART_MAIN);
+
+    // Position it centered at the top
+    lv_obj_align(shiftLight_, LV_ALIGN_TOP_MID, 0, 20);
+
+    // It is off
+    lv_obj_add_flag(shiftLight_, LV_OBJ_FLAG_HIDDEN);
 }
 
 void createAndShowTempScreen(lv_display_t *display) {
@@ -575,6 +813,13 @@ void createAndShowTempScreen(lv_display_t *display) {
 }
 
 bool guiInit(void) {
+    return guiInitDisplays() && guiInitScreens() && guiStart();
+}
+
+bool guiInitDisplays(void) {
+    // The displays are attached with the configured SPI clock
+    spiSpeedHz_ = settingsGet(SETTING_GUI_SPI_SPEED_HZ);
+
     // Initialize SPI bus
     const spi_bus_config_t spiBusConfig = {
             .sclk_io_num = GUI_GPIO_LCD_PCLK,
@@ -600,16 +845,23 @@ bool guiInit(void) {
         return false;
     };
 
-    // Create the Semaphore needed for the lvgl task handler
-    semaphoreLvTaskHandle_ = xSemaphoreCreateMutex();
-
-    // Create the Semaphore needed for the drawing
-    semaphoreLvFlushHandle_ = xSemaphoreCreateMutex();
-
     ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(lcdPanelHandle1_, true));
     ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(lcdPanelHandle2_, true));
     ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(lcdPanelHandle3_, true));
 
+    return true;
+}
+
+bool guiInitScreens(void) {
+    // Create the Semaphore needed for the lvgl task handler
+    semaphoreLvTaskHandle_ = xSemaphoreCreateMutexStatic(&semaphoreLvTaskBuffer_);
+
+    // Create the Semaphore needed for the drawing
+    semaphoreLvFlushHandle_ = xSemaphoreCreateMutexStatic(&semaphoreLvFlushBuffer_);
+    for (int i = 0; i < LATENCY_TRACER_MAX_DISPLAYS; i++) {
+        semaphoreTransfersDoneHandles_[i] = xSemaphoreCreateBinaryStatic(&semaphoreTransfersDoneBuffers_[i]);
+    }
+
     // Initialize LVGL
     if (!initLvgl()) {
         // Logging
@@ -618,21 +870,34 @@ bool guiInit(void) {
         return false;
     }
 
+    // LVGL isn't thread safe, nothing else may touch it while the screens are built
+    xSemaphoreTake(semaphoreLvTaskHandle_, portMAX_DELAY);
+
     // Set the background for each display
     lv_obj_set_style_bg_color(lv_display_get_screen_active(display1_), lv_color_hex(0x000000), LV_PART_MAIN);
     lv_obj_set_style_bg_color(lv_display_get_screen_active(display2_), lv_color_hex(0x000000), LV_PART_MAIN);
     lv_obj_set_style_bg_color(lv_display_get_screen_active(display3_), lv_color_hex(0x000000), LV_PART_MAIN);
 
-    // Start the turn on display task
-    xTaskCreate(&taskWaitForFirstFrameDrawn, "taskWaitForFirstFrameDrawn", 2024, NULL, 0, NULL);
-
     // Build the screens and put them on the displays
     createAndShowSpeedometerScreen(display3_);
     createAndShowRpmScreen(display2_);
     createAndShowTempScreen(display1_);
 
-    // Then start the lvgl task handler task on core 0 - on core 1 the application crashes in the createAndShowTempScreen function
-    if (xTaskCreate(taskUpdateLvgl, "taskUpdateLvgl", 10000, NULL, 0, NULL) != pdPASS) {
+    xSemaphoreGive(semaphoreLvTaskHandle_);
+
+    return true;
+}
+
+bool guiStart(void) {
+    // Start the turn on display task
+    xTaskCreatePinnedToCore(&taskWaitForFirstFrameDrawn, "taskWaitForFirstFrameDrawn", 2024, NULL, GUI_FIRST_FRAME_PRIORITY_LEVEL, NULL, GUI_CORE);
+
+    // Then start the lvgl task handler task. LVGL runs with LV_OS_NONE, so it renders on the task calling
+    // lv_timer_handler() or lv_refr_now(). Only this task does, the setters just change the widgets under the
+    // mutex and wake it. checkRenderingTask() reports a frame rendered anywhere else.
+    // It stays on core 0: the original firmware crashed in createAndShowTempScreen() with it on core 1. That
+    // crash was never reproduced, its cause is unknown. Set GUI_CORE to 1 to try to reproduce it
+    if (TASK_CREATE(taskUpdateLvgl, "taskUpdateLvgl", GUI_LVGL_TASK_STACK_SIZE, NULL, GUI_LVGL_PRIORITY_LEVEL, &taskUpdateLvglHandle_, GUI_CORE) != pdPASS) {
         // Logging
         loggerCritical("Failed to create task: \"taskUpdateLvgl\"!");
 
@@ -645,6 +910,7 @@ bool guiInit(void) {
 }
 
 void guiDeInit(void) {
+#if !CONFIG_FIRMWARE_STATIC_ALLOCATION
     // Delete the draw buffers
     free(drawBuffer11_);
     free(drawBuffer21_);
@@ -652,6 +918,45 @@ void guiDeInit(void) {
     free(drawBuffer12_);
     free(drawBuffer22_);
     free(drawBuffer32_);
+#endif
+}
+
+void guiSetLowPriorityRefreshPeriod(const uint32_t periodMs) {
+    // Is there anything to refresh?
+    if (!initSuccessful_) return;
+
+    // Try to get the semaphore mutex
+    if (xSemaphoreTake(semaphoreLvTaskHandle_, portMAX_DELAY) == pdTRUE) {
+        lv_timer_set_period(lv_display_get_refr_timer(display1_), periodMs);
+        xSemaphoreGive(semaphoreLvTaskHandle_);
+    }
+}
+
+bool guiSetSpiSpeed(const int speedHz) {
+    // Is there anything to do?
+    if (!initSuccessful_ || speedHz == spiSpeedHz_) return true;
+
+    bool success = false;
+
+    // Nothing may be rendered or flushed meanwhile
+    if (xSemaphoreTake(semaphoreLvTaskHandle_, portMAX_DELAY) == pdTRUE) {
+        if (xSemaphoreTake(semaphoreLvFlushHandle_, portMAX_DELAY) == pdTRUE) {
+            success = reattachDisplay(&lcdPanelIoHandle1_, &lcdPanelHandle1_, GUI_GPIO_LCD1_CS, GUI_DISPLAY_TEMP, speedHz);
+            success &= reattachDisplay(&lcdPanelIoHandle2_, &lcdPanelHandle2_, GUI_GPIO_LCD2_CS, GUI_DISPLAY_RPM, speedHz);
+            success &= reattachDisplay(&lcdPanelIoHandle3_, &lcdPanelHandle3_, GUI_GPIO_LCD3_CS, GUI_DISPLAY_SPEED, speedHz);
+            spiSpeedHz_ = speedHz;
+            xSemaphoreGive(semaphoreLvFlushHandle_);
+        }
+        xSemaphoreGive(semaphoreLvTaskHandle_);
+    }
+
+    // Did it work?
+    if (!success) {
+        // Logging
+        loggerCritical("Failed to attach the displays with a SPI clock of %d Hz!", speedHz);
+    }
+
+    return success;
 }
 
 void guiSetRightBlinkerActive(const bool active) {
@@ -674,60 +979,105 @@ void guiSetLeftBlinkerActive(const bool active) {
     }
 }
 
-void guiSetOilPressure(void *pressure) {
+void guiSetLeftBlinker(const SensorSample *sample) {
+    // Try to get the semaphore mutex
+    if (xSemaphoreTake(semaphoreLvTaskHandle_, portMAX_DELAY) == pdTRUE) {
+        // Follow the lamp, it is drawn with the next frame
+        guiSetLeftBlinkerActive(sample->value != 0);
+        latencyTracerMarkPublished(sample, GUI_DISPLAY_RPM);
+        xSemaphoreGive(semaphoreLvTaskHandle_);
+    }
+}
+
+void guiSetRightBlinker(const SensorSample *sample) {
+    // Try to get the semaphore mutex
+    if (xSemaphoreTake(semaphoreLvTaskHandle_, portMAX_DELAY) == pdTRUE) {
+        // Follow the lamp, it is drawn with the next frame
+        guiSetRightBlinkerActive(sample->value != 0);
+        latencyTracerMarkPublished(sample, GUI_DISPLAY_SPEED);
+        xSemaphoreGive(semaphoreLvTaskHandle_);
+    }
+}
+
+void guiSetShiftLight(const SensorSample *sample) {
+    // Only hand it over, rendering here would need an LVGL sized stack on every publishing task
+    shiftLightActive_ = sample->value != 0;
+    shiftLightChanged_ = true;
+    latencyTracerMarkPublished(sample, GUI_DISPLAY_RPM);
+
+    // Waiting for the next refresh would add up to a whole refresh period
+    if (taskUpdateLvglHandle_ != NULL) xTaskNotifyGive(taskUpdateLvglHandle_);
+}
+
+void guiSetOilPressure(const SensorSample *sample) {
     // TODO: Show the NO OIL PRESSURE screen or hide it
 }
 
-void guiSetFuelLevelPercent(void *percent) {
-    // Save the old value
-    lastFuelInPercent_ = (int) percent;
+void guiSetFuelLevelPercent(const SensorSample *sample) {
+    const int percent = (int) sample->value;
 
-    // Set the new text
-    lv_label_set_text_fmt(fuelLevelInPercentLabel_, "%d%%", (int) percent);
+    // Save the old value
+    lastFuelInPercent_ = percent;
 
-    // Check if the fuel level increased (by more than 5%)
-    if (lastFuelInPercent_ < (int) percent + 5) {
-        // Reactivate all fuel blocks
-        for (int i = 0; i < 10; i++) {
-            lv_obj_set_style_arc_opa(fuelLevelArcs_[i], LV_OPA_100, LV_PART_MAIN);
+    // Try to get the semaphore mutex
+    if (xSemaphoreTake(semaphoreLvTaskHandle_, portMAX_DELAY) == pdTRUE) {
+        // Set the new text
+        lv_label_set_text_fmt(fuelLevelInPercentLabel_, "%d%%", percent);
+        latencyTracerMarkPublished(sample, GUI_DISPLAY_TEMP);
+
+        // Check if the fuel level increased (by more than 5%)
+        if (lastFuelInPercent_ < percent + 5) {
+            // Reactivate all fuel blocks
+            for (int i = 0; i < 10; i++) {
+                lv_obj_set_style_arc_opa(fuelLevelArcs_[i], LV_OPA_100, LV_PART_MAIN);
+            }
         }
-    }
 
-    // Update the fuel blocks
-    const int currActiveBlock = ((int) percent + 10) / 10;
-    for (int i = 9; i >= currActiveBlock; i--) {
-        lv_obj_set_style_arc_opa(fuelLevelArcs_[i], LV_OPA_20, LV_PART_MAIN);
+        // Update the fuel blocks
+        const int currActiveBlock = (percent + 10) / 10;
+        for (int i = 9; i >= currActiveBlock; i--) {
+            lv_obj_set_style_arc_opa(fuelLevelArcs_[i], LV_OPA_20, LV_PART_MAIN);
+        }
+        xSemaphoreGive(semaphoreLvTaskHandle_);
     }
 }
 
-void guiSetFuelLevelLitre(void *litres) {
-    // Set the new text
-    lv_label_set_text_fmt(fuelLevelInLitreLabel_, "%dL", (int) litres);
+void guiSetFuelLevelLitre(const SensorSample *sample) {
+    // Try to get the semaphore mutex
+    if (xSemaphoreTake(semaphoreLvTaskHandle_, portMAX_DELAY) == pdTRUE) {
+        // Set the new text
+        lv_label_set_text_fmt(fuelLevelInLitreLabel_, "%dL", (int) sample->value);
+        latencyTracerMarkPublished(sample, GUI_DISPLAY_TEMP);
+        xSemaphoreGive(semaphoreLvTaskHandle_);
+    }
 }
 
-void guiSetWaterTemperature(void *temp) {
+void guiSetWaterTemperature(const SensorSample *sample) {
     // Try to get the semaphore mutex
     if (xSemaphoreTake(semaphoreLvTaskHandle_, portMAX_DELAY) == pdTRUE) {
-        // Set the new text
-        lv_label_set_text_fmt(tempLabel_, "%d", (int) temp);
+        // Set the new text (the sample is in 0.1 °C)
+        lv_label_set_text_fmt(tempLabel_, "%d", (int) (sample->value / 10));
+        latencyTracerMarkPublished(sample, GUI_DISPLAY_TEMP);
         xSemaphoreGive(semaphoreLvTaskHandle_);
     }
 }
 
-void guiSetSpeed(void *speed) {
+void guiSetSpeed(const SensorSample *sample) {
     // Try to get the semaphore mutex
     if (xSemaphoreTake(semaphoreLvTaskHandle_, portMAX_DELAY) == pdTRUE) {
         // Set the new text
-        lv_label_set_text_fmt(speedLabel_, "%d", (int) speed);
+        lv_label_set_text_fmt(speedLabel_, "%d", (int) sample->value);
+        latencyTracerMarkPublished(sample, GUI_DISPLAY_SPEED);
         xSemaphoreGive(semaphoreLvTaskHandle_);
     }
 }
 
-void guiSetRpm(void *rpm) {
+void guiSetRpm(const SensorSample *sample) {
     // Try to get the semaphore mutex
     if (xSemaphoreTake(semaphoreLvTaskHandle_, portMAX_DELAY) == pdTRUE) {
         // Set the new text
-        lv_label_set_text_fmt(rpmLabel_, "%d", (int) rpm);
+        lv_label_set_text_fmt(rpmLabel_, "%d", (int) sample->value);
+        latencyTracerMarkPublished(sample, GUI_DISPLAY_RPM);
         xSemaphoreGive(semaphoreLvTaskHandle_);
     }
-}
\ No newline at end of file
+}
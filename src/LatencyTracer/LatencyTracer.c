@@ -0,0 +1,142 @@
+/* --- Includes --- */
+#include "LatencyTracer/LatencyTracer.h"
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// Samples shown on a display which weren't flushed yet
+typedef struct {
+    int64_t captureTimeUs[SENSOR_COUNT];
+    bool pending[SENSOR_COUNT];
+    bool rendered[SENSOR_COUNT];
+} PendingSamples;
+
+static LatencyHistogram histograms_[SENSOR_COUNT][LATENCY_STAGE_COUNT];
+static PendingSamples pendingSamples_[LATENCY_TRACER_MAX_DISPLAYS];
+
+// Protects everything above, the flush is marked from an ISR
+static portMUX_TYPE tracerLock_ = portMUX_INITIALIZER_UNLOCKED;
+
+// Printable names of the stages
+static const char *stageNames_[LATENCY_STAGE_COUNT] = {
+        [LATENCY_STAGE_PUBLISHED] = "published",
+        [LATENCY_STAGE_RENDERED] = "rendered",
+        [LATENCY_STAGE_FLUSHED] = "flushed",
+};
+
+//! \brief Adds a latency to a histogram. Has to be called with the lock taken
+//! \param histogram The histogram
+//! \param latencyUs The latency in us
+static void IRAM_ATTR recordLatency(LatencyHistogram *histogram, int64_t latencyUs) {
+    // Timestamps from before the capture (e.g. a reset in between) are counted as 0
+    if (latencyUs < 0) latencyUs = 0;
+    if (latencyUs > UINT32_MAX) latencyUs = UINT32_MAX;
+    const uint32_t latency = (uint32_t) latencyUs;
+
+    // Find the bucket: floor(log2(latency)) - offset
+    int bucket = latency == 0 ? 0 : 31 - __builtin_clz(latency) - LATENCY_HISTOGRAM_BUCKET_OFFSET;
+    if (bucket < 0) bucket = 0;
+    if (bucket >= LATENCY_HISTOGRAM_BUCKETS) bucket = LATENCY_HISTOGRAM_BUCKETS - 1;
+
+    // Update the statistics
+    histogram->buckets[bucket]++;
+    if (histogram->count == 0 || latency < histogram->minUs) histogram->minUs = latency;
+    if (latency > histogram->maxUs) histogram->maxUs = latency;
+    histogram->sumUs += latency;
+    histogram->count++;
+}
+
+/* --- Function implementations --- */
+void latencyTracerMarkPublished(const SensorSample *sample, const int display) {
+    // Is everything valid?
+    if (display < 0 || display >= LATENCY_TRACER_MAX_DISPLAYS || sample->id >= SENSOR_COUNT) return;
+
+    const int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&tracerLock_);
+    recordLatency(&histograms_[sample->id][LATENCY_STAGE_PUBLISHED], now - sample->timestampUs);
+
+    // Remember it until it is on the display. A newer sample replaces an older one, which then never gets shown
+    pendingSamples_[display].captureTimeUs[sample->id] = sample->timestampUs;
+    pendingSamples_[display].pending[sample->id] = true;
+    pendingSamples_[display].rendered[sample->id] = false;
+    portEXIT_CRITICAL(&tracerLock_);
+}
+
+void latencyTracerMarkRendered(const int display) {
+    // Is the display valid?
+    if (display < 0 || display >= LATENCY_TRACER_MAX_DISPLAYS) return;
+
+    const int64_t now = esp_timer_get_time();
+    PendingSamples *pending = &pendingSamples_[display];
+
+    portENTER_CRITICAL(&tracerLock_);
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++) {
+        if (pending->pending[sensor] && !pending->rendered[sensor]) {
+            recordLatency(&histograms_[sensor][LATENCY_STAGE_RENDERED], now - pending->captureTimeUs[sensor]);
+            pending->rendered[sensor] = true;
+        }
+    }
+    portEXIT_CRITICAL(&tracerLock_);
+}
+
+void IRAM_ATTR latencyTracerMarkFlushed(const int display) {
+    // Is the display valid?
+    if (display < 0 || display >= LATENCY_TRACER_MAX_DISPLAYS) return;
+
+    const int64_t now = esp_timer_get_time();
+    PendingSamples *pending = &pendingSamples_[display];
+
+    portENTER_CRITICAL_ISR(&tracerLock_);
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++) {
+        // Only samples which were rendered are on the display now
+        if (pending->pending[sensor] && pending->rendered[sensor]) {
+            recordLatency(&histograms_[sensor][LATENCY_STAGE_FLUSHED], now - pending->captureTimeUs[sensor]);
+            pending->pending[sensor] = false;
+        }
+    }
+    portEXIT_CRITICAL_ISR(&tracerLock_);
+}
+
+bool latencyTracerGetHistogram(const SENSOR sensorType, const LATENCY_STAGE stage, LatencyHistogram *histogram) {
+    // Is everything valid?
+    if (sensorType >= SENSOR_COUNT || stage >= LATENCY_STAGE_COUNT || histogram == NULL) return false;
+
+    portENTER_CRITICAL(&tracerLock_);
+    *histogram = histograms_[sensorType][stage];
+    portEXIT_CRITICAL(&tracerLock_);
+
+    return true;
+}
+
+void latencyTracerReset(void) {
+    portENTER_CRITICAL(&tracerLock_);
+    memset(histograms_, 0, sizeof(histograms_));
+    portEXIT_CRITICAL(&tracerLock_);
+}
+
+void latencyTracerDump(void) {
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++) {
+        for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+            // Copy it, logging takes way too long to do it with the lock taken
+            LatencyHistogram histogram;
+            latencyTracerGetHistogram(sensor, stage, &histogram);
+            if (histogram.count == 0) continue;
+
+            // Print the buckets as one line: "<upper bound in ms>:<count>"
+            char bucketText[LATENCY_HISTOGRAM_BUCKETS * 16] = "";
+            size_t length = 0;
+            for (int i = 0; i < LATENCY_HISTOGRAM_BUCKETS && length < sizeof(bucketText); i++) {
+                if (histogram.buckets[i] == 0) continue;
+                length += snprintf(bucketText + length, sizeof(bucketText) - length, " <%lums:%lu",
+                                   (unsigned long) (1UL << (i + LATENCY_HISTOGRAM_BUCKET_OFFSET + 1)) / 1000, (unsigned long) histogram.buckets[i]);
+            }
+
+            // Logging
+            loggerInfo("Latency %s -> %s: n=%lu min=%luus mean=%luus max=%luus |%s",
+                       sensorManagerGetSensorName(sensor), stageNames_[stage], (unsigned long) histogram.count, (unsigned long) histogram.minUs,
+                       (unsigned long) (histogram.sumUs / histogram.count), (unsigned long) histogram.maxUs, bucketText);
+        }
+    }
+}
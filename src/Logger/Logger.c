@@ -10,6 +10,28 @@ FILE *logFileSpiffs_ = NULL;
 
 /* --- Private Variables, Typedefs etc. --- */
 
+// What is logged right now
+static volatile int loggingLevel_ = LOGGING_LEVEL;
+
+//! \brief Writes one line to a log output. The file stays locked meanwhile, so lines of different tasks don't mix
+//! \param file The output
+//! \param level The level prefix
+//! \param message The format string
+//! \param args The arguments, they are copied
+static void logTo(FILE *file, const char *level, const char *message, va_list args) {
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+
+    flockfile(file);
+    fputs(level, file);
+    fputc(' ', file);
+    vfprintf(file, message, argsCopy);
+    fputc('\n', file);
+    funlockfile(file);
+
+    va_end(argsCopy);
+}
+
 /* --- Function implementations --- */
 void loggerInit(void) {
     // Should we create a file on the internal spiffs partition?
@@ -49,32 +71,39 @@ void loggerInit(void) {
     }
 }
 
-void loggerLog(const char *level, const char *message, const va_list args) {
-    // Build the whole log message
-    char *fullMessage = malloc(strlen(level) + strlen(" ") + strlen(message) + strlen("\n") + 1);
-    sprintf(fullMessage, "%s%s%s%s", level, " ", message, "\n");
+void loggerSetLevel(int level) {
+    // Clamp it
+    if (level < 0) level = 0;
+    if (level > 4) level = 4;
+
+    loggingLevel_ = level;
+}
+
+int loggerGetLevel(void) {
+    return loggingLevel_;
+}
+
+void loggerLog(const char *level, const char *message, va_list args) {
+    // The level and the message are written one after the other, nothing is allocated per message
 
     // Should we log to an internal file?
     if (LOGGER_SAVE_INTERNAL && logFileSpiffs_) {
-        vfprintf(logFileSpiffs_, fullMessage, args);
+        logTo(logFileSpiffs_, level, message, args);
     }
     // Should we log to a file on the SD Card?
     if (LOGGER_SAVE_ON_SDCARD && logFileSDCard_) {
-        vfprintf(logFileSDCard_, fullMessage, args);
+        logTo(logFileSDCard_, level, message, args);
     }
     // Should we log to the USB port?
     if (LOGGER_SEND_TO_USB) {
         // Print the message
-        vprintf(fullMessage, args);
+        logTo(stdout, level, message, args);
     }
-
-    // Free the full message
-    free(fullMessage);
 }
 
 void loggerInfo(const char *message, ...) {
     // Check log level
-    if (LOGGING_LEVEL < 4) return;
+    if (loggingLevel_ < 4) return;
 
     // Get all arguments
     va_list args;
@@ -89,7 +118,7 @@ void loggerInfo(const char *message, ...) {
 
 void loggerWarn(const char *message, ...) {
     // Check log level
-    if (LOGGING_LEVEL < 3) return;
+    if (loggingLevel_ < 3) return;
 
     // Get all arguments
     va_list args;
@@ -104,7 +133,7 @@ void loggerWarn(const char *message, ...) {
 
 void loggerError(const char *message, ...) {
     // Check log level
-    if (LOGGING_LEVEL < 2) return;
+    if (loggingLevel_ < 2) return;
 
     // Get all arguments
     va_list args;
@@ -119,7 +148,7 @@ void loggerError(const char *message, ...) {
 
 void loggerCritical(const char *message, ...) {
     // Check log level
-    if (LOGGING_LEVEL < 1) return;
+    if (loggingLevel_ < 1) return;
 
     // Get all arguments
     va_list args;
@@ -0,0 +1,175 @@
+/* --- Includes --- */
+#include "SensorManager/AdcCalibration.h"
+
+// C includes
+#include <stdlib.h>
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// Boot time statistics
+static int64_t bootSpentUs_ = 0;
+static int64_t bootSavedUs_ = 0;
+
+//! \brief Checks if stored data belongs to the channel and can be used
+//! \retval Boolean
+static bool isMatching(const AdcCalibration *calibration, const adc_unit_t unit, const adc_channel_t channel, const adc_atten_t atten) {
+    return calibration->version == ADC_CALIBRATION_VERSION && calibration->unit == unit && calibration->channel == channel && calibration->atten == atten &&
+           calibration->gain > 0 && pwlIsValid(&calibration->table);
+}
+
+//! \brief Writes the calibration to the NVS
+//! \retval Boolean indicating if it worked
+static bool store(const char *key, const AdcCalibration *calibration) {
+    nvs_handle_t handle;
+    if (nvs_open(ADC_CALIBRATION_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) return false;
+
+    const bool success = nvs_set_blob(handle, key, calibration, sizeof(AdcCalibration)) == ESP_OK && nvs_commit(handle) == ESP_OK;
+    nvs_close(handle);
+
+    return success;
+}
+
+//! \brief Reads the calibration from the NVS
+//! \retval Boolean indicating if there was one with the right size
+static bool restore(const char *key, AdcCalibration *calibration) {
+    nvs_handle_t handle;
+    if (nvs_open(ADC_CALIBRATION_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) return false;
+
+    size_t size = sizeof(AdcCalibration);
+    const bool success = nvs_get_blob(handle, key, calibration, &size) == ESP_OK && size == sizeof(AdcCalibration);
+    nvs_close(handle);
+
+    return success;
+}
+
+//! \brief Samples the curve fitting scheme of a channel into the table. deriveTimeUs is set to how long
+//! creating the scheme took, that's what every boot cost without the stored table
+//! \retval Boolean indicating if it worked
+static bool derive(const adc_unit_t unit, const adc_channel_t channel, const adc_atten_t atten, AdcCalibration *calibration) {
+    // Create the calibration curve config
+    const adc_cali_curve_fitting_config_t caliConfig = {
+            .unit_id = unit,
+            .chan = channel,
+            .atten = atten,
+            .bitwidth = ADC_BITWIDTH_12,
+    };
+
+    // Create calibration curve fitting
+    const int64_t start = esp_timer_get_time();
+    adc_cali_handle_t caliHandle;
+    if (adc_cali_create_scheme_curve_fitting(&caliConfig, &caliHandle) != ESP_OK) return false;
+    const int64_t schemeTimeUs = esp_timer_get_time() - start;
+
+    *calibration = (AdcCalibration) {
+            .version = ADC_CALIBRATION_VERSION,
+            .unit = unit,
+            .channel = channel,
+            .atten = atten,
+            .table = {
+                    .pointCount = PWL_MAX_POINTS,
+                    .lowerEnd = PWL_END_CLAMP,
+                    .upperEnd = PWL_END_CLAMP,
+            },
+            .gain = ADC_CALIBRATION_GAIN_ONE,
+            .offsetMV = 0,
+            .deriveTimeUs = (uint32_t) schemeTimeUs,
+    };
+
+    // Sample the scheme at evenly spaced raw values
+    bool success = true;
+    for (int i = 0; i < PWL_MAX_POINTS; i++) {
+        const int raw = i * ADC_CALIBRATION_RAW_MAX / (PWL_MAX_POINTS - 1);
+        int voltage = 0;
+        success &= adc_cali_raw_to_voltage(caliHandle, raw, &voltage) == ESP_OK;
+        calibration->table.points[i] = (PwlPoint) {raw, voltage};
+    }
+
+    // How far is the table off in between the points?
+    int maxErrorMV = 0;
+    for (int raw = 0; success && raw <= ADC_CALIBRATION_RAW_MAX; raw++) {
+        int voltage = 0;
+        adc_cali_raw_to_voltage(caliHandle, raw, &voltage);
+        const int error = abs(pwlEvaluate(&calibration->table, raw) - voltage);
+        if (error > maxErrorMV) maxErrorMV = error;
+    }
+
+    adc_cali_delete_scheme_curve_fitting(caliHandle);
+
+    // Logging
+    if (success) loggerInfo("ADC%d channel %d: table max. deviation from the curve fitting scheme is %d mV", unit + 1, channel, maxErrorMV);
+
+    return success;
+}
+
+/* --- Function implementations --- */
+bool adcCalibrationInit(const char *key, const adc_unit_t unit, const adc_channel_t channel, const adc_atten_t atten, AdcCalibration *calibration) {
+    const int64_t start = esp_timer_get_time();
+
+    // Restore it
+    if (restore(key, calibration) && isMatching(calibration, unit, channel, atten)) {
+        const int64_t duration = esp_timer_get_time() - start;
+        bootSpentUs_ += duration;
+        if (calibration->deriveTimeUs > duration) bootSavedUs_ += calibration->deriveTimeUs - duration;
+
+        // Logging
+        loggerInfo("ADC calibration '%s' restored in %lld us (the curve fitting scheme took %lu us)", key, duration, (unsigned long) calibration->deriveTimeUs);
+
+        return true;
+    }
+
+    // Derive it
+    if (!derive(unit, channel, atten, calibration)) {
+        // Logging
+        loggerError("Couldn't derive the ADC calibration '%s'", key);
+
+        return false;
+    }
+    const int64_t duration = esp_timer_get_time() - start;
+    bootSpentUs_ += duration;
+
+    // Store it for the next boot
+    if (!store(key, calibration)) {
+        // Logging
+        loggerWarn("Couldn't store the ADC calibration '%s'", key);
+    }
+
+    // Logging
+    loggerInfo("ADC calibration '%s' derived in %lld us", key, duration);
+
+    return true;
+}
+
+int adcCalibrationRawToMilliVolts(const AdcCalibration *calibration, const int raw) {
+    const int32_t voltage = pwlEvaluate(&calibration->table, raw);
+    return fixedPointScale(voltage, calibration->gain, ADC_CALIBRATION_GAIN_ONE) + calibration->offsetMV;
+}
+
+bool adcCalibrationSetTrim(const char *key, AdcCalibration *calibration, const int32_t gain, const int32_t offsetMV) {
+    // Is the gain valid?
+    if (gain <= 0) return false;
+
+    calibration->gain = gain;
+    calibration->offsetMV = offsetMV;
+
+    // Logging
+    loggerInfo("ADC calibration '%s' trimmed: gain %ld/%d, offset %ld mV", key, (long) gain, ADC_CALIBRATION_GAIN_ONE, (long) offsetMV);
+
+    return store(key, calibration);
+}
+
+bool adcCalibrationErase(void) {
+    nvs_handle_t handle;
+    if (nvs_open(ADC_CALIBRATION_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) return false;
+
+    const bool success = nvs_erase_all(handle) == ESP_OK && nvs_commit(handle) == ESP_OK;
+    nvs_close(handle);
+
+    return success;
+}
+
+void adcCalibrationGetBootTime(int64_t *spentUs, int64_t *savedUs) {
+    *spentUs = bootSpentUs_;
+    *savedUs = bootSavedUs_;
+}
@@ -0,0 +1,60 @@
+/* --- Includes --- */
+#include "SensorManager/CanBus.h"
+
+// C includes
+#include <stddef.h>
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+#if !CONFIG_IDF_TARGET_LINUX
+static const CanBusBackend *backend_ = &canBusTwai;
+#else
+static const CanBusBackend *backend_ = NULL;
+#endif
+
+/* --- Function implementations --- */
+bool canBusSelect(const CanBusBackend *backend) {
+    // Is the backend complete?
+    if (backend == NULL || backend->init == NULL || backend->receive == NULL) {
+        // Logging
+        loggerError("Incomplete CAN backend!");
+
+        return false;
+    }
+
+    backend_ = backend;
+
+    // Logging
+    loggerInfo("Using the '%s' CAN backend", backend->name);
+
+    return true;
+}
+
+const CanBusBackend *canBusGetBackend(void) {
+    return backend_;
+}
+
+bool canBusInit(const CanFilter *filter) {
+    // Was a backend selected?
+    if (backend_ == NULL) {
+        // Logging
+        loggerCritical("No CAN backend selected!");
+
+        return false;
+    }
+
+    return backend_->init(filter);
+}
+
+bool canBusReceive(CanFrame *frame, const TickType_t timeout) {
+    if (backend_ == NULL) return false;
+
+    return backend_->receive(frame, timeout);
+}
+
+bool canBusFilterAccepts(const CanFilter *filter, const CanFrame *frame) {
+    if (frame->extended) return filter->mask == 0;
+
+    return (frame->id & filter->mask) == (filter->code & filter->mask);
+}
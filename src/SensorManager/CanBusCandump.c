@@ -0,0 +1,206 @@
+/* --- Includes --- */
+#include "SensorManager/CanBus.h"
+
+// C includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// One frame of the log
+typedef struct {
+    int64_t offsetUs;// From the first frame of the log
+    uint32_t id;
+    bool extended;
+    uint8_t length;
+    uint8_t data[8];
+} CandumpRecord;
+
+static FILE *file_ = NULL;
+static int lineNumber_ = 0;
+static int64_t firstFrameUs_ = -1;// Recorded time of the first frame
+
+// The next record which wasn't delivered yet and the one handed out last
+static CandumpRecord nextRecord_;
+static bool hasNextRecord_ = false;
+static CandumpRecord current_;
+
+// When the replay started [sensorHalGetTimeUs() time], set by the first receive
+static int64_t startUs_ = 0;
+static bool started_ = false;
+
+// The filter of the controller, applied to the log as well
+static CanFilter filter_ = {0, 0};
+
+//! \brief Parses the hex digits of a frame
+//! \param text The digits, two per byte, dots between the bytes are skipped
+//! \param record Where the data is written to
+//! \retval Boolean indicating if the data is valid
+static bool parseData(const char *text, CandumpRecord *record) {
+    record->length = 0;
+    while (*text != '\0' && *text != '\n' && *text != '\r' && *text != ' ') {
+        if (*text == '.') {
+            text++;
+            continue;
+        }
+
+        char byte[3] = {text[0], text[1], '\0'};
+        char *end = NULL;
+        const unsigned long value = strtoul(byte, &end, 16);
+        if (end != byte + 2 || record->length >= 8) return false;
+
+        record->data[record->length++] = (uint8_t) value;
+        text += 2;
+    }
+
+    return true;
+}
+
+//! \brief Reads the next valid record of the log, that passes the filter, into nextRecord_
+static void readNextRecord(void) {
+    hasNextRecord_ = false;
+    if (file_ == NULL) return;
+
+    char line[CAN_CANDUMP_MAX_LINE_LENGTH];
+    while (fgets(line, sizeof(line), file_) != NULL) {
+        lineNumber_++;
+
+        // Skip comments and empty lines
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+
+        // "(1436509052.249713) can0 123#DEADBEEF"
+        long long seconds = 0;
+        long microseconds = 0;
+        char frameText[CAN_CANDUMP_MAX_LINE_LENGTH];
+        const char *hash = NULL;
+        bool valid = sscanf(line, "(%lld.%ld) %*s %95s", &seconds, &microseconds, frameText) == 3;
+        if (valid) hash = strchr(frameText, '#');
+        valid &= hash != NULL;
+
+        CandumpRecord record = {0};
+        if (valid) {
+            // The number of digits tells standard and extended ids apart
+            const int idDigits = (int) (hash - frameText);
+            char *end = NULL;
+            record.id = strtoul(frameText, &end, 16);
+            record.extended = idDigits > 3;
+            valid &= end == hash && (idDigits == 3 || idDigits == 8);
+
+            // Remote frames ("123#R") and CAN FD frames ("123##1...") carry no classic data
+            if (valid && (hash[1] == 'R' || hash[1] == '#')) continue;
+            valid &= parseData(hash + 1, &record);
+        }
+
+        if (!valid) {
+            // Logging
+            loggerWarn("Skipping invalid candump line %d", lineNumber_);
+
+            continue;
+        }
+
+        const int64_t timeUs = seconds * 1000000LL + microseconds;
+        if (firstFrameUs_ < 0) firstFrameUs_ = timeUs;
+        record.offsetUs = timeUs - firstFrameUs_;
+
+        // The controller wouldn't have received it
+        const CanFrame frame = {.id = record.id, .extended = record.extended};
+        if (!canBusFilterAccepts(&filter_, &frame)) continue;
+
+        nextRecord_ = record;
+        hasNextRecord_ = true;
+        return;
+    }
+}
+
+/* --- Function implementations --- */
+bool canBusCandumpOpen(const char *path) {
+    canBusCandumpClose();
+
+    file_ = fopen(path, "r");
+    if (file_ == NULL) {
+        // Logging
+        loggerError("Couldn't open the candump log '%s'", path);
+
+        return false;
+    }
+
+    // Start from scratch
+    lineNumber_ = 0;
+    firstFrameUs_ = -1;
+    started_ = false;
+    readNextRecord();
+
+    return true;
+}
+
+void canBusCandumpClose(void) {
+    if (file_ != NULL) fclose(file_);
+    file_ = NULL;
+    hasNextRecord_ = false;
+}
+
+//! \brief See CanBusBackend
+static bool candumpInit(const CanFilter *filter) {
+    filter_ = *filter;
+
+    // The first frame was read before the filter was known
+    if (hasNextRecord_) {
+        const CanFrame frame = {.id = nextRecord_.id, .extended = nextRecord_.extended};
+        if (!canBusFilterAccepts(&filter_, &frame)) readNextRecord();
+    }
+
+    // Logging
+    if (file_ == NULL) loggerWarn("No candump log opened, the CAN bus stays silent");
+
+    return true;
+}
+
+//! \brief See CanBusBackend
+static bool candumpReceive(CanFrame *frame, const TickType_t timeout) {
+    // A virtual clock is only moved by sensorHalAdvanceTo(), waiting wouldn't help
+    const SensorHalBackend *hal = sensorHalGetBackend();
+    const bool virtualClock = hal != NULL && hal->advanceTo != NULL;
+
+    // The log starts now
+    int64_t nowUs = sensorHalGetTimeUs();
+    if (!started_) {
+        startUs_ = nowUs;
+        started_ = true;
+    }
+
+    // Is the next frame due?
+    if (!hasNextRecord_ || startUs_ + nextRecord_.offsetUs > nowUs) {
+        if (virtualClock || timeout == 0) return false;
+
+        // Sleep until it is due, but not longer than the timeout
+        TickType_t wait = timeout;
+        if (hasNextRecord_) {
+            const TickType_t due = pdMS_TO_TICKS((startUs_ + nextRecord_.offsetUs - nowUs) / 1000) + 1;
+            if (due < wait) wait = due;
+        }
+        vTaskDelay(wait);
+
+        nowUs = sensorHalGetTimeUs();
+        if (!hasNextRecord_ || startUs_ + nextRecord_.offsetUs > nowUs) return false;
+    }
+
+    // Hand out the record, it stays valid until the next receive
+    current_ = nextRecord_;
+    frame->id = current_.id;
+    frame->extended = current_.extended;
+    frame->length = current_.length;
+    frame->data = current_.data;
+    frame->timestampUs = startUs_ + current_.offsetUs;
+    readNextRecord();
+
+    return true;
+}
+
+const CanBusBackend canBusCandump = {
+        .name = "candump",
+        .init = candumpInit,
+        .receive = candumpReceive,
+};
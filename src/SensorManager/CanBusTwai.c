@@ -0,0 +1,86 @@
+/* --- Includes --- */
+#include "SensorManager/CanBus.h"
+
+// espidf includes
+#include <driver/gpio.h>
+#include <driver/twai.h>
+#include <esp_timer.h>
+
+/* --- Private Defines & Macros --- */
+
+// Position of the standard id in the single acceptance filter, below it are the RTR bit and the first two data bytes
+#define TWAI_FILTER_ID_SHIFT 21
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// The frame of the last receive, the CanFrame handed out points into it
+static twai_message_t message_;
+
+//! \brief Recovers from a bus-off, e.g. after the bus was shorted or the bit rate is wrong
+static void recoverBus(void) {
+    twai_status_info_t status;
+    if (twai_get_status_info(&status) != ESP_OK) return;
+
+    if (status.state == TWAI_STATE_BUS_OFF) {
+        // Logging
+        loggerWarn("CAN bus off, recovering");
+
+        twai_initiate_recovery();
+    } else if (status.state == TWAI_STATE_STOPPED) {
+        // The recovery is done
+        twai_start();
+    }
+}
+
+//! \brief See CanBusBackend
+static bool twaiInit(const CanFilter *filter) {
+    // The dashboard only listens, but it acknowledges, so it also works as the only other node on the bus
+    twai_general_config_t generalConfig = TWAI_GENERAL_CONFIG_DEFAULT(CAN_TWAI_GPIO_TX, CAN_TWAI_GPIO_RX, TWAI_MODE_NORMAL);
+    generalConfig.rx_queue_len = CAN_TWAI_RX_QUEUE_LENGTH;
+    generalConfig.tx_queue_len = 0;
+    const twai_timing_config_t timingConfig = CAN_TWAI_TIMING();
+
+    // The controller drops everything else, a mask bit of 1 is a don't care there
+    twai_filter_config_t filterConfig = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+    if (filter->mask != 0) {
+        filterConfig.acceptance_code = (filter->code & 0x7FF) << TWAI_FILTER_ID_SHIFT;
+        filterConfig.acceptance_mask = ~((filter->mask & 0x7FF) << TWAI_FILTER_ID_SHIFT);
+        filterConfig.single_filter = true;
+    }
+
+    if (twai_driver_install(&generalConfig, &timingConfig, &filterConfig) != ESP_OK || twai_start() != ESP_OK) {
+        // Logging
+        loggerError("Couldn't start the TWAI controller!");
+
+        return false;
+    }
+
+    return true;
+}
+
+//! \brief See CanBusBackend
+static bool twaiReceive(CanFrame *frame, const TickType_t timeout) {
+    if (twai_receive(&message_, timeout) != ESP_OK) {
+        // Nothing for a while, maybe the controller gave up
+        recoverBus();
+
+        return false;
+    }
+
+    // Remote frames carry no data
+    if (message_.rtr) return false;
+
+    frame->id = message_.identifier;
+    frame->extended = message_.extd;
+    frame->length = message_.data_length_code > 8 ? 8 : message_.data_length_code;
+    frame->data = message_.data;
+    frame->timestampUs = esp_timer_get_time();
+
+    return true;
+}
+
+const CanBusBackend canBusTwai = {
+        .name = "twai",
+        .init = twaiInit,
+        .receive = twaiReceive,
+};
@@ -0,0 +1,283 @@
+/* --- Includes --- */
+#include "SensorManager/CanSignals.h"
+
+// C includes
+#include <stddef.h>
+
+/* --- Private Defines & Macros --- */
+
+// Distinct frames of the benchmark, they are decoded over and over
+#define CAN_BENCHMARK_FRAME_COUNT 256
+
+// Seconds of full bus load the benchmark decodes
+#define CAN_BENCHMARK_SECONDS 10
+
+/* --- Private Variables, Typedefs etc. --- */
+
+//! \brief Returns the sort key of a frame, extended ids after the standard ones
+//! \param frameId The id
+//! \param extended Boolean indicating if it is a 29 bit id
+//! \retval The key
+static inline uint32_t frameKey(const uint32_t frameId, const bool extended) {
+    return (extended ? 1UL << 31 : 0) | frameId;
+}
+
+//! \brief Checks a signal and works out where its bits are
+//! \param signal The signal
+//! \param shift Where the position of its least significant bit is written to
+//! \param minLength Where the number of data bytes it needs is written to
+//! \retval Boolean indicating if it is valid
+static bool locateSignal(const CanSignal *signal, uint8_t *shift, uint8_t *minLength) {
+    if (signal->length < 1 || signal->length > 32 || signal->startBit > 63 || signal->factorDenominator <= 0 || signal->channel >= CAN_CHANNEL_COUNT ||
+        signal->minimum > signal->maximum || signal->frameId > (signal->extended ? 0x1FFFFFFFUL : 0x7FFUL))
+        return false;
+
+    int lsb = 0;
+    if (signal->byteOrder == CAN_BYTE_ORDER_INTEL) {
+        // Counted from the least significant bit of byte 0 upwards
+        lsb = signal->startBit;
+        if (lsb + signal->length > 64) return false;
+        *minLength = (lsb + signal->length - 1) / 8 + 1;
+    } else {
+        // The start bit is the most significant one, byte 0 is the most significant byte of the loaded data
+        const int msb = (7 - signal->startBit / 8) * 8 + signal->startBit % 8;
+        lsb = msb - signal->length + 1;
+        if (lsb < 0) return false;
+        *minLength = 8 - lsb / 8;
+    }
+    *shift = (uint8_t) lsb;
+
+    return true;
+}
+
+//! \brief Searches the signals of a frame
+//! \param decoder The decoder
+//! \param frame The frame
+//! \retval The signals of the frame or NULL if it has none
+static const CanDecoderFrame *findFrame(const CanDecoder *decoder, const CanFrame *frame) {
+    const uint32_t key = frameKey(frame->id, frame->extended);
+
+    int low = 0;
+    int high = decoder->frameCount - 1;
+    while (low <= high) {
+        const int middle = (low + high) / 2;
+        const CanDecoderFrame *candidate = &decoder->frames[middle];
+        const uint32_t candidateKey = frameKey(candidate->frameId, candidate->extended);
+        if (candidateKey == key) return candidate;
+        if (candidateKey < key) low = middle + 1;
+        else high = middle - 1;
+    }
+
+    return NULL;
+}
+
+/* --- Function implementations --- */
+bool canDecoderInit(CanDecoder *decoder, const CanSignal *signals, const int count) {
+    // Nothing received yet
+    *decoder = (CanDecoder) {.signals = signals};
+    portMUX_INITIALIZE(&decoder->lock);
+    if (count < 0 || count > CAN_DECODER_MAX_SIGNALS) return false;
+
+    // Is every signal valid?
+    for (int i = 0; i < count; i++) {
+        if (!locateSignal(&signals[i], &decoder->shift[i], &decoder->minLength[i])) {
+            // Logging
+            loggerError("Invalid CAN signal %d of frame 0x%lx", i, (unsigned long) signals[i].frameId);
+
+            return false;
+        }
+    }
+
+    // Sort them by frame, insertion sort keeps the order of the signals within a frame
+    for (int i = 0; i < count; i++) {
+        int j = i;
+        while (j > 0 && frameKey(signals[decoder->order[j - 1]].frameId, signals[decoder->order[j - 1]].extended) > frameKey(signals[i].frameId, signals[i].extended)) {
+            decoder->order[j] = decoder->order[j - 1];
+            j--;
+        }
+        decoder->order[j] = (uint8_t) i;
+    }
+
+    // One entry per frame
+    for (int i = 0; i < count; i++) {
+        const CanSignal *signal = &signals[decoder->order[i]];
+        CanDecoderFrame *last = decoder->frameCount > 0 ? &decoder->frames[decoder->frameCount - 1] : NULL;
+        if (last != NULL && last->frameId == signal->frameId && last->extended == signal->extended) {
+            last->signalCount++;
+        } else {
+            decoder->frames[decoder->frameCount++] = (CanDecoderFrame) {signal->frameId, signal->extended, (uint8_t) i, 1};
+        }
+    }
+
+    return true;
+}
+
+void canDecoderGetFilter(const CanDecoder *decoder, CanFilter *filter) {
+    // The bits every standard id agrees on have to match, the rest is don't care
+    uint32_t allSet = 0x7FF;
+    uint32_t anySet = 0;
+    for (int i = 0; i < decoder->frameCount; i++) {
+        // A single filter can't cover both kinds of ids
+        if (decoder->frames[i].extended) {
+            *filter = (CanFilter) {0, 0};
+            return;
+        }
+
+        allSet &= decoder->frames[i].frameId;
+        anySet |= decoder->frames[i].frameId;
+    }
+
+    const uint32_t mask = decoder->frameCount > 0 ? ~(allSet ^ anySet) & 0x7FF : 0;
+    *filter = (CanFilter) {allSet & mask, mask};
+}
+
+int canDecoderDecode(CanDecoder *decoder, const CanFrame *frame) {
+    // Does it carry any signal?
+    const CanDecoderFrame *entry = findFrame(decoder, frame);
+    if (entry == NULL) {
+        decoder->ignoredFrames++;
+        return 0;
+    }
+
+    // Load the data once in both byte orders, straight from the receive buffer
+    uint64_t intel = 0;
+    uint64_t motorola = 0;
+    for (int i = 0; i < 8; i++) {
+        const uint64_t byte = i < frame->length ? frame->data[i] : 0;
+        intel |= byte << (8 * i);
+        motorola = motorola << 8 | byte;
+    }
+
+    int decoded = 0;
+    for (int i = entry->firstSignal; i < entry->firstSignal + entry->signalCount; i++) {
+        const int index = decoder->order[i];
+        const CanSignal *signal = &decoder->signals[index];
+
+        // Is it in the frame?
+        if (frame->length < decoder->minLength[index]) {
+            decoder->shortFrames++;
+            continue;
+        }
+
+        // Cut out the raw bits and scale them
+        const uint64_t bits = signal->byteOrder == CAN_BYTE_ORDER_INTEL ? intel : motorola;
+        const uint64_t raw = (bits >> decoder->shift[index]) & ((1ULL << signal->length) - 1);
+        int64_t value = (int64_t) raw;
+        if (signal->isSigned && (raw & (1ULL << (signal->length - 1)))) value -= (int64_t) (1ULL << signal->length);
+        value = value * signal->factorNumerator / signal->factorDenominator + signal->offset;
+
+        // Is it plausible?
+        const bool outOfRange = value < signal->minimum || value > signal->maximum;
+        if (value < signal->minimum) value = signal->minimum;
+        if (value > signal->maximum) value = signal->maximum;
+
+        portENTER_CRITICAL(&decoder->lock);
+        CanSignalValue *latest = &decoder->values[signal->channel];
+        latest->value = (int32_t) value;
+        latest->timestampUs = frame->timestampUs;
+        latest->outOfRange = outOfRange;
+        latest->updates++;
+        portEXIT_CRITICAL(&decoder->lock);
+
+        decoded++;
+    }
+    decoder->decodedFrames++;
+
+    return decoded;
+}
+
+bool canDecoderGetValue(CanDecoder *decoder, const CAN_CHANNEL channel, CanSignalValue *value) {
+    if (channel >= CAN_CHANNEL_COUNT) return false;
+
+    portENTER_CRITICAL(&decoder->lock);
+    *value = decoder->values[channel];
+    portEXIT_CRITICAL(&decoder->lock);
+
+    return value->updates > 0;
+}
+
+bool canDecoder_test(void) {
+    // Both byte orders, signed, scaled and extended signals
+    static const CanSignal signals[] = {
+            {0x370, false, CAN_CHANNEL_SPEED, 0, 16, CAN_BYTE_ORDER_INTEL, false, 1, 10, 0, 0, 300},
+            {0x360, false, CAN_CHANNEL_RPM, 0, 16, CAN_BYTE_ORDER_INTEL, false, 1, 1, 0, 0, 10000},
+            {0x360, false, CAN_CHANNEL_WATER_TEMPERATURE, 23, 16, CAN_BYTE_ORDER_MOTOROLA, false, 1, 1, -400, -400, 1500},
+            {0x371, false, CAN_CHANNEL_FUEL_LEVEL, 4, 12, CAN_BYTE_ORDER_INTEL, true, 1, 1, 0, -100, 100},
+            {0x18FEF100, true, CAN_CHANNEL_OIL_PRESSURE, 0, 1, CAN_BYTE_ORDER_INTEL, false, 1, 1, 0, 0, 1},
+    };
+    static CanDecoder decoder;
+    bool passed = canDecoderInit(&decoder, signals, sizeof(signals) / sizeof(signals[0]));
+    passed &= decoder.frameCount == 4;
+
+    // 3000 rpm, 50.0 °C
+    const uint8_t engine[] = {0xB8, 0x0B, 0x03, 0x84, 0, 0, 0, 0};
+    passed &= canDecoderDecode(&decoder, &(CanFrame) {0x360, false, 8, engine, 100}) == 2;
+    // 1000.0 km/h is clamped
+    const uint8_t vehicle[] = {0x10, 0x27};
+    passed &= canDecoderDecode(&decoder, &(CanFrame) {0x370, false, 2, vehicle, 200}) == 1;
+    // -5 in bits 4 - 15
+    const uint8_t fuel[] = {0xB0, 0xFF};
+    passed &= canDecoderDecode(&decoder, &(CanFrame) {0x371, false, 2, fuel, 300}) == 1;
+    // The same id as standard frame carries nothing, the extended one does
+    const uint8_t oil[] = {0x01};
+    passed &= canDecoderDecode(&decoder, &(CanFrame) {0x18FEF100, false, 1, oil, 400}) == 0;
+    passed &= canDecoderDecode(&decoder, &(CanFrame) {0x18FEF100, true, 1, oil, 400}) == 1;
+    // Too short for the temperature
+    passed &= canDecoderDecode(&decoder, &(CanFrame) {0x360, false, 2, engine, 500}) == 1 && decoder.shortFrames == 1;
+
+    CanSignalValue value;
+    passed &= canDecoderGetValue(&decoder, CAN_CHANNEL_RPM, &value) && value.value == 3000 && value.timestampUs == 500 && value.updates == 2;
+    passed &= canDecoderGetValue(&decoder, CAN_CHANNEL_WATER_TEMPERATURE, &value) && value.value == 500 && !value.outOfRange;
+    passed &= canDecoderGetValue(&decoder, CAN_CHANNEL_SPEED, &value) && value.value == 300 && value.outOfRange;
+    passed &= canDecoderGetValue(&decoder, CAN_CHANNEL_FUEL_LEVEL, &value) && value.value == -5;
+    passed &= canDecoderGetValue(&decoder, CAN_CHANNEL_OIL_PRESSURE, &value) && value.value == 1;
+    passed &= decoder.ignoredFrames == 1;
+
+    // The filter has to pass every frame of the signals
+    CanFilter filter;
+    canDecoderGetFilter(&decoder, &filter);
+    passed &= filter.mask == 0;
+    passed &= canDecoderInit(&decoder, signals, 4);
+    canDecoderGetFilter(&decoder, &filter);
+    for (int i = 0; i < 4; i++) {
+        passed &= canBusFilterAccepts(&filter, &(CanFrame) {.id = signals[i].frameId});
+    }
+    passed &= !canBusFilterAccepts(&filter, &(CanFrame) {.id = 0x123});
+
+    // Invalid signals are rejected
+    static const CanSignal invalid[] = {{0x100, false, CAN_CHANNEL_RPM, 60, 8, CAN_BYTE_ORDER_INTEL, false, 1, 1, 0, 0, 255}};
+    passed &= !canDecoderInit(&decoder, invalid, 1);
+
+    // Benchmark: full bus load, a quarter of the frames carries no signal
+    static uint8_t data[CAN_BENCHMARK_FRAME_COUNT][8];
+    static CanFrame frames[CAN_BENCHMARK_FRAME_COUNT];
+    uint32_t random = 42;
+    for (int i = 0; i < CAN_BENCHMARK_FRAME_COUNT; i++) {
+        for (int j = 0; j < 8; j++) {
+            random = random * 1664525 + 1013904223;
+            data[i][j] = (uint8_t) (random >> 24);
+        }
+        const uint32_t ids[] = {0x360, 0x370, 0x371, 0x7DF};
+        frames[i] = (CanFrame) {ids[i % 4], false, 8, data[i], i};
+    }
+    canDecoderInit(&decoder, signals, sizeof(signals) / sizeof(signals[0]));
+
+    const int framesPerSecond = CAN_BITRATE_BPS / CAN_FRAME_MIN_BITS;
+    const int64_t start = esp_timer_get_time();
+    for (int i = 0; i < framesPerSecond * CAN_BENCHMARK_SECONDS; i++) {
+        canDecoderDecode(&decoder, &frames[i % CAN_BENCHMARK_FRAME_COUNT]);
+    }
+    const int64_t elapsedUs = esp_timer_get_time() - start;
+    passed &= decoder.decodedFrames + decoder.ignoredFrames == (uint32_t) (framesPerSecond * CAN_BENCHMARK_SECONDS);
+
+    // Logging
+    if (passed) {
+        loggerInfo("CAN decoder tests passed");
+    } else {
+        loggerError("CAN decoder tests FAILED");
+    }
+    loggerInfo("Decoded %d s of full bus load (%d frames/s) in %lld us, %lld ns per frame, %lld.%lld%% of a core", CAN_BENCHMARK_SECONDS, framesPerSecond, elapsedUs,
+               elapsedUs * 1000 / (framesPerSecond * CAN_BENCHMARK_SECONDS), elapsedUs / (CAN_BENCHMARK_SECONDS * 10000), elapsedUs / (CAN_BENCHMARK_SECONDS * 1000) % 10);
+
+    return passed;
+}
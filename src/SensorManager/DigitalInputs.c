@@ -0,0 +1,354 @@
+/* --- Includes --- */
+#include "SensorManager/DigitalInputs.h"
+
+#if !CONFIG_IDF_TARGET_LINUX
+// espidf includes
+#include <driver/gpio.h>
+#include <driver/gptimer.h>
+#include <esp_timer.h>
+#endif
+
+/* --- Private Defines & Macros --- */
+
+// The debounce timer counts in us
+#define DEBOUNCE_TIMER_RESOLUTION_HZ 1000000
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// Debounced states, written by the debounce timer ISR
+static volatile bool levels_[DIGITAL_INPUT_COUNT];
+
+#if !CONFIG_IDF_TARGET_LINUX
+// Printable names of the inputs
+static const char *inputNames_[DIGITAL_INPUT_COUNT] = {
+        [DIGITAL_INPUT_BLINKER_LEFT] = "left blinker",
+        [DIGITAL_INPUT_BLINKER_RIGHT] = "right blinker",
+        [DIGITAL_INPUT_BUTTON_1] = "button 1",
+        [DIGITAL_INPUT_BUTTON_2] = "button 2",
+        [DIGITAL_INPUT_BUTTON_3] = "button 3",
+};
+
+static const gpio_num_t gpios_[DIGITAL_INPUT_COUNT] = {
+        [DIGITAL_INPUT_BLINKER_LEFT] = GPIO_BLINKER_LEFT,
+        [DIGITAL_INPUT_BLINKER_RIGHT] = GPIO_BLINKER_RIGHT,
+        [DIGITAL_INPUT_BUTTON_1] = GPIO_BUTTON_1,
+        [DIGITAL_INPUT_BUTTON_2] = GPIO_BUTTON_2,
+        [DIGITAL_INPUT_BUTTON_3] = GPIO_BUTTON_3,
+};
+
+// Debounce stuff. Shared by the edge ISR and the debounce timer ISR, which may run on different cores
+static gptimer_handle_t debounceTimer_ = NULL;
+static portMUX_TYPE debounceLock_ = portMUX_INITIALIZER_UNLOCKED;
+static uint64_t debounceDeadlines_[DIGITAL_INPUT_COUNT];// Timer count when the level is sampled, 0 = not bouncing
+static int64_t firstEdgeUs_[DIGITAL_INPUT_COUNT];       // First edge of the current bounce [esp_timer time in us]
+static bool alarmArmed_ = false;
+
+// Debounced changes for the processing task
+static QueueHandle_t eventQueue_ = NULL;
+static StaticQueue_t eventQueueBuffer_;
+static uint8_t eventQueueStorage_[DIGITAL_INPUTS_QUEUE_LENGTH * sizeof(DigitalInputEvent)];
+static volatile uint32_t droppedEvents_ = 0;
+
+//! \brief Sets the alarm of the debounce timer. The debounce lock has to be taken
+//! \param count The timer count it fires at
+static void IRAM_ATTR armAlarm(const uint64_t count) {
+    const gptimer_alarm_config_t alarmConfig = {
+            .alarm_count = count,
+    };
+    gptimer_set_alarm_action(debounceTimer_, &alarmConfig);
+    alarmArmed_ = true;
+}
+
+//! \brief ISR of the inputs, triggered by the first edge of a change. The interrupt of the input stays
+//! disabled until the level is sampled, so the bouncing doesn't cause any further interrupts
+//! \param arg The DIGITAL_INPUT
+static void IRAM_ATTR edgeInterruptHandler(void *arg) {
+    const DIGITAL_INPUT input = (DIGITAL_INPUT) arg;
+
+    // Ignore the bouncing
+    gpio_intr_disable(gpios_[input]);
+
+    portENTER_CRITICAL_ISR(&debounceLock_);
+    firstEdgeUs_[input] = esp_timer_get_time();
+
+    // Sample the level once the debounce time is over
+    uint64_t count = 0;
+    gptimer_get_raw_count(debounceTimer_, &count);
+    debounceDeadlines_[input] = count + DIGITAL_INPUTS_DEBOUNCE_US;
+
+    // Every deadline is the same time after its edge, so an armed alarm is always due earlier
+    if (!alarmArmed_) armAlarm(debounceDeadlines_[input]);
+    portEXIT_CRITICAL_ISR(&debounceLock_);
+}
+
+//! \brief ISR of the debounce timer. Samples every input whose debounce time is over and queues the changes
+static bool IRAM_ATTR debounceAlarmHandler(gptimer_handle_t timer, const gptimer_alarm_event_data_t *eventData, void *userCtx) {
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    uint64_t nextDeadline = UINT64_MAX;
+
+    portENTER_CRITICAL_ISR(&debounceLock_);
+    for (int input = 0; input < DIGITAL_INPUT_COUNT; input++) {
+        // Is it bouncing?
+        if (debounceDeadlines_[input] == 0) continue;
+
+        // Not yet due?
+        if (debounceDeadlines_[input] > eventData->count_value) {
+            if (debounceDeadlines_[input] < nextDeadline) nextDeadline = debounceDeadlines_[input];
+            continue;
+        }
+
+        // Listen for edges again before sampling, so a change right after sampling isn't lost
+        debounceDeadlines_[input] = 0;
+        gpio_intr_enable(gpios_[input]);
+
+        // Did it really change or was it only a glitch?
+        const bool active = gpio_get_level(gpios_[input]) == 0;
+        if (active != levels_[input]) {
+            levels_[input] = active;
+
+            const DigitalInputEvent event = {
+                    .input = input,
+                    .active = active,
+                    .timeUs = firstEdgeUs_[input],
+            };
+            if (xQueueSendFromISR(eventQueue_, &event, &higherPriorityTaskWoken) != pdTRUE) droppedEvents_++;
+        }
+    }
+
+    // Wait for the next input which is still bouncing
+    if (nextDeadline != UINT64_MAX) {
+        armAlarm(nextDeadline);
+    } else {
+        alarmArmed_ = false;
+    }
+    portEXIT_CRITICAL_ISR(&debounceLock_);
+
+    return higherPriorityTaskWoken == pdTRUE;
+}
+#endif
+
+//! \brief Returns the lamp of an input
+//! \retval The lamp or NULL if it isn't a blinker
+static BlinkerLamp *getLamp(BlinkDetector *detector, const DIGITAL_INPUT input) {
+    if (input == DIGITAL_INPUT_BLINKER_LEFT) return &detector->left;
+    if (input == DIGITAL_INPUT_BLINKER_RIGHT) return &detector->right;
+    return NULL;
+}
+
+//! \brief Checks if a lamp flashes with a turn signal frequency
+//! \retval Boolean
+static bool isFlashing(const BlinkerLamp *lamp, const int64_t nowUs) {
+    // Did it flash at least twice?
+    if (lamp->previousFlashUs == 0) return false;
+
+    const int64_t periodUs = lamp->lastFlashUs - lamp->previousFlashUs;
+    return periodUs >= BLINK_PERIOD_MIN_US && periodUs <= BLINK_PERIOD_MAX_US && nowUs - lamp->lastFlashUs <= BLINK_TIMEOUT_US;
+}
+
+//! \brief Checks if a lamp is on for longer than a flash
+//! \retval Boolean
+static bool isSteady(const BlinkerLamp *lamp, const int64_t nowUs) {
+    return lamp->active && nowUs - lamp->lastChangeUs > BLINK_TIMEOUT_US;
+}
+
+//! \brief Returns the earlier of two timeouts which are still ahead
+//! \retval The timeout or -1 if both aren't
+static int64_t earliestTimeout(const int64_t timeoutUs, const int64_t otherUs, const int64_t nowUs) {
+    if (timeoutUs <= nowUs) return otherUs;
+    if (otherUs <= nowUs || timeoutUs < otherUs) return timeoutUs;
+    return otherUs;
+}
+
+/* --- Function implementations --- */
+bool digitalInputsInit(void) {
+#if !CONFIG_IDF_TARGET_LINUX
+    // Create the queue for the debounced changes
+    eventQueue_ = xQueueCreateStatic(DIGITAL_INPUTS_QUEUE_LENGTH, sizeof(DigitalInputEvent), eventQueueStorage_, &eventQueueBuffer_);
+    if (eventQueue_ == NULL) {
+        // Logging
+        loggerError("Couldn't create the digital input queue!");
+
+        return false;
+    }
+
+    // Start the debounce timer, it runs freely and only fires while an input is bouncing
+    const gptimer_config_t timerConfig = {
+            .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+            .direction = GPTIMER_COUNT_UP,
+            .resolution_hz = DEBOUNCE_TIMER_RESOLUTION_HZ,
+    };
+    const gptimer_event_callbacks_t timerCallbacks = {
+            .on_alarm = debounceAlarmHandler,
+    };
+    if (gptimer_new_timer(&timerConfig, &debounceTimer_) != ESP_OK || gptimer_register_event_callbacks(debounceTimer_, &timerCallbacks, NULL) != ESP_OK ||
+        gptimer_enable(debounceTimer_) != ESP_OK || gptimer_start(debounceTimer_) != ESP_OK) {
+        // Logging
+        loggerError("Couldn't start the debounce timer!");
+
+        return false;
+    }
+
+    // The sensor backend usually installed the ISR service already
+    const esp_err_t isrServiceResult = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    if (isrServiceResult != ESP_OK && isrServiceResult != ESP_ERR_INVALID_STATE) {
+        // Logging
+        loggerError("Couldn't install the ISR service. The digital inputs are unavailable!");
+
+        return false;
+    }
+
+    // Setup the gpios and their interrupts
+    bool success = true;
+    for (int input = 0; input < DIGITAL_INPUT_COUNT; input++) {
+        gpio_set_direction(gpios_[input], GPIO_MODE_INPUT);
+        gpio_set_pull_mode(gpios_[input], GPIO_PULLUP_ONLY);
+        levels_[input] = gpio_get_level(gpios_[input]) == 0;
+        gpio_set_intr_type(gpios_[input], GPIO_INTR_ANYEDGE);
+
+        if (gpio_isr_handler_add(gpios_[input], edgeInterruptHandler, (void *) input) != ESP_OK || gpio_intr_enable(gpios_[input]) != ESP_OK) {
+            success = false;
+
+            // Logging
+            loggerError("Couldn't enable the interrupt of the %s!", inputNames_[input]);
+        }
+    }
+
+    return success;
+#else
+    // Logging
+    loggerWarn("There are no digital inputs on this target");
+
+    return false;
+#endif
+}
+
+bool digitalInputsWaitForEvent(DigitalInputEvent *event, const TickType_t timeout) {
+#if !CONFIG_IDF_TARGET_LINUX
+    if (eventQueue_ != NULL) {
+        // Were changes lost? The state is still right, only the blink detection misses them
+        const uint32_t dropped = droppedEvents_;
+        if (dropped > 0) {
+            droppedEvents_ = 0;
+
+            // Logging
+            loggerWarn("%lu digital input changes were dropped, the queue was full", (unsigned long) dropped);
+        }
+
+        return xQueueReceive(eventQueue_, event, timeout) == pdTRUE;
+    }
+#endif
+
+    // Without inputs there is nothing to wait for
+    vTaskDelay(timeout);
+    return false;
+}
+
+bool digitalInputsIsActive(const DIGITAL_INPUT input) {
+    if (input >= DIGITAL_INPUT_COUNT) return false;
+
+    return levels_[input];
+}
+
+void blinkDetectorInit(BlinkDetector *detector) {
+    *detector = (BlinkDetector) {0};
+}
+
+void blinkDetectorFeed(BlinkDetector *detector, const DigitalInputEvent *event) {
+    // Is it a blinker?
+    BlinkerLamp *lamp = getLamp(detector, event->input);
+    if (lamp == NULL || lamp->active == event->active) return;
+
+    lamp->active = event->active;
+    lamp->lastChangeUs = event->timeUs;
+
+    // Remember the last two flashes for the period
+    if (event->active) {
+        lamp->previousFlashUs = lamp->lastFlashUs;
+        lamp->lastFlashUs = event->timeUs;
+    }
+}
+
+BLINKER_PATTERN blinkDetectorEvaluate(const BlinkDetector *detector, const int64_t nowUs) {
+    const bool leftFlashing = isFlashing(&detector->left, nowUs);
+    const bool rightFlashing = isFlashing(&detector->right, nowUs);
+
+    if (leftFlashing && rightFlashing) return BLINKER_PATTERN_HAZARD;
+    if (leftFlashing) return BLINKER_PATTERN_LEFT;
+    if (rightFlashing) return BLINKER_PATTERN_RIGHT;
+    if (isSteady(&detector->left, nowUs) || isSteady(&detector->right, nowUs)) return BLINKER_PATTERN_STEADY;
+    return BLINKER_PATTERN_OFF;
+}
+
+int64_t blinkDetectorNextTimeoutUs(const BlinkDetector *detector, const int64_t nowUs) {
+    int64_t timeoutUs = -1;
+
+    // Flashing stops or a lamp which is on becomes steady right after BLINK_TIMEOUT_US
+    const BlinkerLamp *lamps[] = {&detector->left, &detector->right};
+    for (int i = 0; i < 2; i++) {
+        if (lamps[i]->lastFlashUs != 0) timeoutUs = earliestTimeout(lamps[i]->lastFlashUs + BLINK_TIMEOUT_US + 1, timeoutUs, nowUs);
+        if (lamps[i]->active) timeoutUs = earliestTimeout(lamps[i]->lastChangeUs + BLINK_TIMEOUT_US + 1, timeoutUs, nowUs);
+    }
+
+    return timeoutUs > nowUs ? timeoutUs : -1;
+}
+
+bool digitalInputs_test(void) {
+    bool passed = true;
+    BlinkDetector detector;
+    blinkDetectorInit(&detector);
+
+    // Lets a lamp flash with 1.5Hz (on for half the period)
+    int64_t timeUs = 1000000;
+    const int64_t periodUs = 666000;
+    for (int flash = 0; flash < 3; flash++) {
+        blinkDetectorFeed(&detector, &(DigitalInputEvent) {DIGITAL_INPUT_BLINKER_LEFT, true, timeUs});
+        blinkDetectorFeed(&detector, &(DigitalInputEvent) {DIGITAL_INPUT_BLINKER_LEFT, false, timeUs + periodUs / 2});
+        timeUs += periodUs;
+    }
+    passed &= blinkDetectorEvaluate(&detector, timeUs) == BLINKER_PATTERN_LEFT;
+
+    // A button changes nothing
+    blinkDetectorFeed(&detector, &(DigitalInputEvent) {DIGITAL_INPUT_BUTTON_1, true, timeUs});
+    passed &= blinkDetectorEvaluate(&detector, timeUs) == BLINKER_PATTERN_LEFT;
+
+    // It stops once the next flash is overdue, the timeout says exactly when
+    const int64_t stopUs = blinkDetectorNextTimeoutUs(&detector, timeUs);
+    passed &= stopUs > timeUs && blinkDetectorEvaluate(&detector, stopUs - 1) == BLINKER_PATTERN_LEFT;
+    passed &= blinkDetectorEvaluate(&detector, stopUs) == BLINKER_PATTERN_OFF;
+    passed &= blinkDetectorNextTimeoutUs(&detector, stopUs) == -1;
+
+    // Both in sync -> hazard
+    timeUs = stopUs + 1000000;
+    for (int flash = 0; flash < 3; flash++) {
+        blinkDetectorFeed(&detector, &(DigitalInputEvent) {DIGITAL_INPUT_BLINKER_LEFT, true, timeUs});
+        blinkDetectorFeed(&detector, &(DigitalInputEvent) {DIGITAL_INPUT_BLINKER_RIGHT, true, timeUs + 2000});
+        blinkDetectorFeed(&detector, &(DigitalInputEvent) {DIGITAL_INPUT_BLINKER_LEFT, false, timeUs + periodUs / 2});
+        blinkDetectorFeed(&detector, &(DigitalInputEvent) {DIGITAL_INPUT_BLINKER_RIGHT, false, timeUs + periodUs / 2 + 2000});
+        timeUs += periodUs;
+    }
+    passed &= blinkDetectorEvaluate(&detector, timeUs) == BLINKER_PATTERN_HAZARD;
+
+    // A lamp which stays on is steady, not flashing
+    blinkDetectorInit(&detector);
+    blinkDetectorFeed(&detector, &(DigitalInputEvent) {DIGITAL_INPUT_BLINKER_RIGHT, true, timeUs});
+    passed &= blinkDetectorEvaluate(&detector, timeUs + BLINK_TIMEOUT_US) == BLINKER_PATTERN_OFF;
+    passed &= blinkDetectorEvaluate(&detector, blinkDetectorNextTimeoutUs(&detector, timeUs)) == BLINKER_PATTERN_STEADY;
+
+    // Flickering is no blinking
+    blinkDetectorInit(&detector);
+    for (int flash = 0; flash < 5; flash++) {
+        blinkDetectorFeed(&detector, &(DigitalInputEvent) {DIGITAL_INPUT_BLINKER_LEFT, true, timeUs});
+        blinkDetectorFeed(&detector, &(DigitalInputEvent) {DIGITAL_INPUT_BLINKER_LEFT, false, timeUs + 50000});
+        timeUs += 100000;
+    }
+    passed &= blinkDetectorEvaluate(&detector, timeUs) == BLINKER_PATTERN_OFF;
+
+    // Logging
+    if (passed) {
+        loggerInfo("Digital input tests passed");
+    } else {
+        loggerError("Digital input tests FAILED");
+    }
+
+    return passed;
+}
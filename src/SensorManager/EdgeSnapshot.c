@@ -0,0 +1,120 @@
+/* --- Includes --- */
+#include "SensorManager/EdgeSnapshot.h"
+
+/* --- Private Defines & Macros --- */
+
+// Step between the fake edges of the stress test. Both 32 bit halves of the timestamp change on
+// every edge, so a torn timestamp is always detected
+#define EDGE_SNAPSHOT_TEST_STEP ((1LL << 32) + 1)
+
+// How long the stress test waits for its writer to start [in ticks]
+#define EDGE_SNAPSHOT_TEST_START_TIMEOUT_TICKS 100
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// Shared with the writer task of the stress test
+static EdgeRecord testRecord_;
+static volatile bool testRunning_ = false;
+static volatile uint32_t testWrites_ = 0;
+
+/* --- Tasks --- */
+
+//! \brief Writes fake edges as fast as possible until the test is done
+static void taskHammerEdges(void *params) {
+    int64_t timeUs = 0;
+
+    while (testRunning_) {
+        timeUs += EDGE_SNAPSHOT_TEST_STEP;
+        edgeSnapshotRecord(&testRecord_, timeUs);
+        testWrites_++;
+    }
+
+    vTaskDelete(NULL);
+}
+
+/* --- Function implementations --- */
+void IRAM_ATTR edgeSnapshotRecord(EdgeRecord *record, const int64_t timeUs) {
+    // Odd -> a write is in progress
+    record->sequence++;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    record->previousEdgeUs = record->lastEdgeUs;
+    record->lastEdgeUs = timeUs;
+    record->edgeCount++;
+
+    // Even again -> the record is consistent
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    record->sequence++;
+}
+
+uint32_t edgeSnapshotRead(const EdgeRecord *record, EdgeSnapshot *snapshot) {
+    uint32_t retries = 0;
+
+    // ReSharper disable once CppDFAEndlessLoop
+    while (1) {
+        const uint32_t sequenceBefore = __atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE);
+
+        snapshot->lastEdgeUs = record->lastEdgeUs;
+        snapshot->previousEdgeUs = record->previousEdgeUs;
+        snapshot->edgeCount = record->edgeCount;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        const uint32_t sequenceAfter = record->sequence;
+
+        // No write started or finished in between?
+        if ((sequenceBefore & 1) == 0 && sequenceBefore == sequenceAfter) return retries;
+
+        // The writer is an ISR or runs on the other core, it is done within a few cycles
+        retries++;
+    }
+}
+
+bool edgeSnapshot_test(void) {
+    testRecord_ = (EdgeRecord) {0};
+    testWrites_ = 0;
+    testRunning_ = true;
+
+    // Start the writer on the other core
+    TaskHandle_t writer = NULL;
+    const BaseType_t otherCore = xPortGetCoreID() == 0 ? 1 : 0;
+    if (xTaskCreatePinnedToCore(taskHammerEdges, "taskHammerEdges", 2048, NULL, uxTaskPriorityGet(NULL), &writer, otherCore) != pdPASS) {
+        // Logging
+        loggerError("Edge snapshot test couldn't start the writer");
+
+        return false;
+    }
+
+    // The reads have to overlap the writes, wait until the writer runs
+    for (int i = 0; i < EDGE_SNAPSHOT_TEST_START_TIMEOUT_TICKS && testWrites_ == 0; i++) {
+        vTaskDelay(1);
+    }
+
+    // Read while the writer is busy and check the relations it guarantees
+    uint32_t tornReads = 0;
+    uint32_t retries = 0;
+    uint32_t lastCount = 0;
+    for (int i = 0; i < EDGE_SNAPSHOT_TEST_READS; i++) {
+        EdgeSnapshot snapshot;
+        retries += edgeSnapshotRead(&testRecord_, &snapshot);
+        if (snapshot.edgeCount < 2) continue;
+
+        const bool consistent = snapshot.lastEdgeUs - snapshot.previousEdgeUs == EDGE_SNAPSHOT_TEST_STEP && snapshot.lastEdgeUs == snapshot.edgeCount * EDGE_SNAPSHOT_TEST_STEP &&
+                                snapshot.edgeCount >= lastCount;
+        if (!consistent) tornReads++;
+        lastCount = snapshot.edgeCount;
+    }
+
+    // Stop the writer, it deletes itself
+    testRunning_ = false;
+    vTaskDelay(pdMS_TO_TICKS(10));
+
+    // Logging
+    const bool passed = tornReads == 0 && testWrites_ > 0;
+    if (passed) {
+        loggerInfo("Edge snapshot tests passed: %d reads, %lu writes, %lu retries", EDGE_SNAPSHOT_TEST_READS, (unsigned long) testWrites_, (unsigned long) retries);
+    } else {
+        loggerError("Edge snapshot tests FAILED: %lu torn of %d reads, %lu writes", (unsigned long) tornReads, EDGE_SNAPSHOT_TEST_READS, (unsigned long) testWrites_);
+    }
+
+    return passed;
+}
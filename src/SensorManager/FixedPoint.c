@@ -0,0 +1,116 @@
+/* --- Includes --- */
+#include "SensorManager/FixedPoint.h"
+
+// C includes
+#include <math.h>
+
+// Project includes
+#include "Logger/Logger.h"
+
+// espidf includes
+#include <esp_cpu.h>
+
+/* --- Private Defines & Macros --- */
+
+// How many conversions are timed by the benchmark
+#define FIXED_POINT_BENCHMARK_ITERATIONS 1000
+
+/* --- Private Variables, Typedefs etc. --- */
+
+/* --- Function implementations --- */
+int64_t fixedPointDivideRounded(const int64_t numerator, const int64_t denominator) {
+    if (numerator >= 0) return (numerator + denominator / 2) / denominator;
+    return (numerator - denominator / 2) / denominator;
+}
+
+int32_t fixedPointScale(const int32_t value, const int32_t numerator, const int32_t denominator) {
+    return (int32_t) fixedPointDivideRounded((int64_t) value * numerator, denominator);
+}
+
+int32_t fixedPointVoltageDividerR2(const int32_t supplyMV, const int32_t voltageMV, const int32_t r1) {
+    // No current through R2 -> open circuit
+    if (voltageMV >= supplyMV) return FIXED_POINT_RESISTANCE_INFINITE;
+    if (voltageMV <= 0) return 0;
+
+    // R2 = R1 * (vOut / (vIn - vOut)), R1 scaled from Ohms to Milliohms
+    const int64_t r2 = fixedPointDivideRounded((int64_t) r1 * 1000 * voltageMV, supplyMV - voltageMV);
+
+    // Does it still fit?
+    if (r2 >= FIXED_POINT_RESISTANCE_INFINITE) return FIXED_POINT_RESISTANCE_INFINITE;
+    return (int32_t) r2;
+}
+
+int32_t fixedPointFrequencyFromPeriod(const int64_t periodUs) {
+    // Is the period valid?
+    if (periodUs <= 0) return -1;
+
+    // 1s = 1000000us -> 1000000000 mHz * us
+    const int64_t frequency = fixedPointDivideRounded(1000000000LL, periodUs);
+
+    // Periods below 1us would overflow, clamp them
+    if (frequency > INT32_MAX) return INT32_MAX;
+    return (int32_t) frequency;
+}
+
+int32_t fixedPointMilliHzToHz(const int32_t frequencyMilliHz) {
+    return (int32_t) fixedPointDivideRounded(frequencyMilliHz, 1000);
+}
+
+bool fixedPoint_test(void) {
+    bool passed = true;
+
+    // Voltage divider: 3.3V, 240 Ohm R1, 1.65V -> 240 Ohm
+    passed &= fixedPointVoltageDividerR2(3300, 1650, 240) == 240000;
+    passed &= fixedPointVoltageDividerR2(3300, 3300, 240) == FIXED_POINT_RESISTANCE_INFINITE;
+    passed &= fixedPointVoltageDividerR2(3300, 0, 240) == 0;
+
+    // Frequency from period
+    passed &= fixedPointFrequencyFromPeriod(1000000) == 1000;
+    passed &= fixedPointFrequencyFromPeriod(3) == 333333333;
+    passed &= fixedPointFrequencyFromPeriod(0) == -1;
+    passed &= fixedPointMilliHzToHz(2500) == 3;
+
+    // Scaling
+    passed &= fixedPointScale(-15, 1, 10) == -2;
+    passed &= fixedPointScale(2000000, 1000, 3) == 666666667;
+
+    // Logging
+    if (passed) {
+        loggerInfo("Fixed-point tests passed");
+    } else {
+        loggerError("Fixed-point tests FAILED");
+    }
+
+    // Benchmark one update worth of math against the old float/double formulas:
+    // voltage divider, period -> frequency, internal temperature
+    volatile int32_t sink = 0;
+    volatile float floatSink = 0.0f;
+    volatile double doubleSink = 0.0;
+
+    const uint32_t floatStart = esp_cpu_get_cycle_count();
+    for (int i = 0; i < FIXED_POINT_BENCHMARK_ITERATIONS; i++) {
+        const float vOut = (float) (i % 3000) / 1000.0f;
+        floatSink = 240.0f * (vOut / (3.3f - vOut));
+        const float fT = (float) (1000 + i) / 1000.0f;
+        sink = (int) round(1000.0 / fT);
+        doubleSink = ((double) (i % 3000) - 540.0) / 10.0;
+    }
+    const uint32_t floatCycles = esp_cpu_get_cycle_count() - floatStart;
+
+    const uint32_t fixedStart = esp_cpu_get_cycle_count();
+    for (int i = 0; i < FIXED_POINT_BENCHMARK_ITERATIONS; i++) {
+        sink = fixedPointVoltageDividerR2(3300, i % 3000, 240);
+        sink = fixedPointFrequencyFromPeriod(1000 + i);
+        sink = (i % 3000) - 540;
+    }
+    const uint32_t fixedCycles = esp_cpu_get_cycle_count() - fixedStart;
+    (void) sink;
+    (void) floatSink;
+    (void) doubleSink;
+
+    // Logging
+    loggerInfo("Sensor math per update: float %lu cycles, fixed-point %lu cycles",
+               (unsigned long) (floatCycles / FIXED_POINT_BENCHMARK_ITERATIONS), (unsigned long) (fixedCycles / FIXED_POINT_BENCHMARK_ITERATIONS));
+
+    return passed;
+}
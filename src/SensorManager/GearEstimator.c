@@ -0,0 +1,115 @@
+/* --- Includes --- */
+#include "SensorManager/GearEstimator.h"
+
+// Project includes
+#include "Logger/Logger.h"
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+static const int32_t gearRatiosMilli_[GEAR_ESTIMATOR_GEAR_COUNT] = GEAR_ESTIMATOR_RATIOS_MILLI;
+
+//! \brief Checks if a measured ratio is within a tolerance around the ratio of a gear
+//! \param ratioQ8 The measured ratio
+//! \param gearRatioQ8 The ratio of the gear
+//! \param tolerancePercent The tolerance
+//! \retval Boolean
+static bool isWithin(const int32_t ratioQ8, const int32_t gearRatioQ8, const int32_t tolerancePercent) {
+    const int32_t tolerance = gearRatioQ8 * tolerancePercent / 100;
+    return ratioQ8 >= gearRatioQ8 - tolerance && ratioQ8 <= gearRatioQ8 + tolerance;
+}
+
+/* --- Function implementations --- */
+void gearEstimatorInit(GearEstimator *estimator) {
+    // rpm / (km/h) = 60 * gear ratio * final drive / (3.6 * tire circumference in m)
+    for (int gear = 0; gear < GEAR_ESTIMATOR_GEAR_COUNT; gear++) {
+        const int64_t numerator = 60LL * 256 * gearRatiosMilli_[gear] * GEAR_ESTIMATOR_FINAL_DRIVE_MILLI;
+        estimator->ratiosQ8[gear] = (int32_t) (numerator / (3600LL * GEAR_ESTIMATOR_TIRE_CIRCUMFERENCE_MM));
+    }
+
+    estimator->gear = GEAR_NEUTRAL;
+    estimator->candidate = GEAR_NEUTRAL;
+    estimator->candidateSamples = 0;
+}
+
+int gearEstimatorUpdate(GearEstimator *estimator, const int32_t rpm, const int32_t speedKmh) {
+    int detected;
+
+    if (rpm <= 0) {
+        // Engine off: standing or rolling with the clutch pressed
+        detected = speedKmh >= GEAR_ESTIMATOR_MIN_SPEED_KMH ? GEAR_CLUTCH : GEAR_NEUTRAL;
+    } else if (speedKmh < GEAR_ESTIMATOR_MIN_SPEED_KMH) {
+        // Standing with the engine running
+        detected = GEAR_NEUTRAL;
+    } else {
+        const int32_t ratioQ8 = (int32_t) (((int64_t) rpm << 8) / speedKmh);
+
+        // Keep the current gear as long as it fits roughly
+        const int current = estimator->gear;
+        if (current >= 1 && isWithin(ratioQ8, estimator->ratiosQ8[current - 1], GEAR_ESTIMATOR_STAY_TOLERANCE_PERCENT)) {
+            detected = current;
+        } else {
+            // No gear matches -> neutral at idle, otherwise the clutch is pressed
+            detected = rpm <= GEAR_ESTIMATOR_IDLE_RPM ? GEAR_NEUTRAL : GEAR_CLUTCH;
+            for (int gear = 0; gear < GEAR_ESTIMATOR_GEAR_COUNT; gear++) {
+                if (isWithin(ratioQ8, estimator->ratiosQ8[gear], GEAR_ESTIMATOR_ENTER_TOLERANCE_PERCENT)) detected = gear + 1;
+            }
+        }
+    }
+
+    // Only take a new state once it was seen a few times in a row
+    if (detected == estimator->gear) {
+        estimator->candidateSamples = 0;
+    } else if (detected == estimator->candidate && estimator->candidateSamples > 0) {
+        if (++estimator->candidateSamples >= GEAR_ESTIMATOR_CONFIRM_SAMPLES) {
+            estimator->gear = detected;
+            estimator->candidateSamples = 0;
+        }
+    } else {
+        estimator->candidate = detected;
+        estimator->candidateSamples = 1;
+    }
+
+    return estimator->gear;
+}
+
+bool gearEstimator_test(void) {
+    bool passed = true;
+    GearEstimator estimator;
+    gearEstimatorInit(&estimator);
+
+    // 3000rpm in every gear, the speeds come from the ratios
+    const int32_t speeds[GEAR_ESTIMATOR_GEAR_COUNT] = {24, 40, 57, 76, 93};
+    for (int gear = 0; gear < GEAR_ESTIMATOR_GEAR_COUNT; gear++) {
+        gearEstimatorUpdate(&estimator, 3000, speeds[gear]);
+        passed &= gearEstimatorUpdate(&estimator, 3000, speeds[gear]) == gear + 1;
+    }
+
+    // A single implausible sample doesn't change anything
+    passed &= gearEstimatorUpdate(&estimator, 5000, 93) == 5;
+
+    // 8% off is still 5th (hysteresis), but wouldn't be detected as 5th
+    passed &= gearEstimatorUpdate(&estimator, 3240, 93) == 5;
+    passed &= gearEstimatorUpdate(&estimator, 3240, 93) == 5;
+
+    // Clutch pressed while rolling
+    gearEstimatorUpdate(&estimator, 2000, 93);
+    passed &= gearEstimatorUpdate(&estimator, 2000, 93) == GEAR_CLUTCH;
+
+    // Rolling in neutral at idle
+    gearEstimatorUpdate(&estimator, 850, 60);
+    passed &= gearEstimatorUpdate(&estimator, 850, 60) == GEAR_NEUTRAL;
+
+    // Standing
+    gearEstimatorUpdate(&estimator, 850, 0);
+    passed &= gearEstimatorUpdate(&estimator, 850, 0) == GEAR_NEUTRAL;
+
+    // Logging
+    if (passed) {
+        loggerInfo("Gear estimator tests passed");
+    } else {
+        loggerError("Gear estimator tests FAILED");
+    }
+
+    return passed;
+}
@@ -0,0 +1,187 @@
+/* --- Includes --- */
+#include "SensorManager/Odometer.h"
+
+// C includes
+#include <stdio.h>
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+//! \brief Converts speed pulses to meters
+//! \param pulses The pulses
+//! \retval The distance [in m]
+static int32_t pulsesToMeters(const uint64_t pulses) {
+    return (int32_t) (pulses * 1000 / ODOMETER_PULSES_PER_KM);
+}
+
+#if !CONFIG_IDF_TARGET_LINUX
+
+//! \brief Writes the NVS key of a slot
+//! \param slot The slot
+//! \param key Where the key is written to (min. 8 characters)
+static void slotKey(const uint32_t slot, char *key) {
+    snprintf(key, 8, "slot%lu", (unsigned long) slot);
+}
+
+#endif// !CONFIG_IDF_TARGET_LINUX
+
+/* --- Function implementations --- */
+void odometerInit(Odometer *odometer, const uint32_t edgeCount, const int32_t storeIntervalMeters) {
+    *odometer = (Odometer) {
+            .lastEdgeCount = edgeCount,
+    };
+    odometerSetStoreInterval(odometer, storeIntervalMeters);
+}
+
+bool odometerUpdate(Odometer *odometer, const uint32_t edgeCount) {
+    // Unsigned subtraction, so a wrap around of the edge count doesn't matter
+    const uint32_t newPulses = edgeCount - odometer->lastEdgeCount;
+    odometer->lastEdgeCount = edgeCount;
+    odometer->totalPulses += newPulses;
+    odometer->tripPulses += newPulses;
+
+    return odometer->totalPulses - odometer->storedTotalPulses >= odometer->storeIntervalPulses;
+}
+
+bool odometerHasUnstoredChanges(const Odometer *odometer) {
+    return odometer->totalPulses != odometer->storedTotalPulses || odometer->tripResetPending;
+}
+
+bool odometerIsStopStoreDue(const Odometer *odometer) {
+    const uint64_t minPulses = (uint64_t) ODOMETER_STOP_STORE_MIN_M * ODOMETER_PULSES_PER_KM / 1000;
+    return odometer->totalPulses - odometer->storedTotalPulses >= minPulses || odometer->tripResetPending;
+}
+
+void odometerSetStoreInterval(Odometer *odometer, const int32_t storeIntervalMeters) {
+    const int64_t pulses = (int64_t) storeIntervalMeters * ODOMETER_PULSES_PER_KM / 1000;
+    odometer->storeIntervalPulses = pulses < 1 ? 1 : (uint32_t) pulses;
+}
+
+void odometerResetTrip(Odometer *odometer) {
+    odometer->tripPulses = 0;
+    odometer->tripResetPending = true;
+}
+
+int32_t odometerGetTotalMeters(const Odometer *odometer) {
+    return pulsesToMeters(odometer->totalPulses);
+}
+
+int32_t odometerGetTripMeters(const Odometer *odometer) {
+    return pulsesToMeters(odometer->tripPulses);
+}
+
+#if !CONFIG_IDF_TARGET_LINUX
+
+bool odometerStore(Odometer *odometer) {
+    // The next slot gets the next sequence, the older slots stay as a fallback
+    const OdometerRecord record = {
+            .version = ODOMETER_VERSION,
+            .sequence = odometer->sequence + 1,
+            .totalPulses = odometer->totalPulses,
+            .tripPulses = odometer->tripPulses,
+    };
+    char key[8];
+    slotKey(record.sequence % ODOMETER_SLOT_COUNT, key);
+
+    nvs_handle_t handle;
+    if (nvs_open(ODOMETER_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) return false;
+
+    const bool success = nvs_set_blob(handle, key, &record, sizeof(OdometerRecord)) == ESP_OK && nvs_commit(handle) == ESP_OK;
+    nvs_close(handle);
+
+    // Only count it as stored if it really is, otherwise the next update tries again
+    if (success) {
+        odometer->sequence = record.sequence;
+        odometer->storedTotalPulses = record.totalPulses;
+        odometer->tripResetPending = false;
+    }
+
+    return success;
+}
+
+bool odometerRestore(Odometer *odometer) {
+    nvs_handle_t handle;
+    if (nvs_open(ODOMETER_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) return false;
+
+    // Find the newest valid slot
+    bool found = false;
+    OdometerRecord newest = {0};
+    for (uint32_t slot = 0; slot < ODOMETER_SLOT_COUNT; slot++) {
+        char key[8];
+        slotKey(slot, key);
+
+        OdometerRecord record;
+        size_t size = sizeof(OdometerRecord);
+        if (nvs_get_blob(handle, key, &record, &size) != ESP_OK || size != sizeof(OdometerRecord) || record.version != ODOMETER_VERSION) continue;
+
+        // Signed difference, so the sequence may wrap around
+        if (!found || (int32_t) (record.sequence - newest.sequence) > 0) {
+            newest = record;
+            found = true;
+        }
+    }
+    nvs_close(handle);
+
+    if (!found) return false;
+
+    odometer->totalPulses = newest.totalPulses;
+    odometer->tripPulses = newest.tripPulses;
+    odometer->storedTotalPulses = newest.totalPulses;
+    odometer->sequence = newest.sequence;
+    odometer->tripResetPending = false;
+
+    // Logging
+    loggerInfo("Odometer restored from slot %lu: %ld m, trip %ld m", (unsigned long) (newest.sequence % ODOMETER_SLOT_COUNT), (long) odometerGetTotalMeters(odometer),
+               (long) odometerGetTripMeters(odometer));
+
+    return true;
+}
+
+#endif// !CONFIG_IDF_TARGET_LINUX
+
+bool odometer_test(void) {
+    bool passed = true;
+    Odometer odometer;
+
+    // Start shortly before the edge count wraps around
+    const uint32_t start = UINT32_MAX - 1000;
+    odometerInit(&odometer, start, 100);
+
+    // 98 m (356 pulses are 98.9 m, truncated) -> no store yet, 100 m -> store
+    passed &= !odometerUpdate(&odometer, start + 356);
+    passed &= odometerGetTotalMeters(&odometer) == 98;
+    passed &= odometerUpdate(&odometer, start + 360);
+    passed &= odometerGetTotalMeters(&odometer) == 100;
+
+    // After a store only the distance since then counts
+    odometer.storedTotalPulses = odometer.totalPulses;
+    passed &= !odometerHasUnstoredChanges(&odometer);
+    passed &= !odometerUpdate(&odometer, start + 700);
+
+    // A stop after 19 m isn't stored, after 20 m it is
+    odometer.storedTotalPulses = odometer.totalPulses - 68;
+    passed &= !odometerIsStopStoreDue(&odometer);
+    odometer.storedTotalPulses = odometer.totalPulses - 72;
+    passed &= odometerIsStopStoreDue(&odometer);
+
+    // 10 km across the wrap around, exactly
+    passed &= odometerUpdate(&odometer, start + 36000);
+    passed &= odometerGetTotalMeters(&odometer) == 10000 && odometerGetTripMeters(&odometer) == 10000;
+
+    // Trip reset keeps the odometer, but has to be stored
+    odometer.storedTotalPulses = odometer.totalPulses;
+    odometerResetTrip(&odometer);
+    passed &= odometerHasUnstoredChanges(&odometer) && odometerIsStopStoreDue(&odometer);
+    odometerUpdate(&odometer, start + 36000 + 3600);
+    passed &= odometerGetTotalMeters(&odometer) == 11000 && odometerGetTripMeters(&odometer) == 1000;
+
+    // Logging
+    if (passed) {
+        loggerInfo("Odometer tests passed");
+    } else {
+        loggerError("Odometer tests FAILED");
+    }
+
+    return passed;
+}
@@ -0,0 +1,184 @@
+/* --- Includes --- */
+#include "SensorManager/PiecewiseLinear.h"
+
+// Project includes
+#include "Logger/Logger.h"
+#include "SensorManager/FixedPoint.h"
+
+/* --- Private Defines & Macros --- */
+
+
+/* --- Private Variables, Typedefs etc. --- */
+
+//! \brief Interpolates (or extrapolates) on the segment between the points a and b
+//! \param a The first point of the segment
+//! \param b The second point of the segment, b.x > a.x
+//! \param x The input value
+//! \retval The interpolated value
+static int32_t interpolate(const PwlPoint *a, const PwlPoint *b, const int32_t x) {
+    const int64_t dx = (int64_t) x - a->x;
+    const int64_t dy = (int64_t) b->y - a->y;
+
+    return (int32_t) (a->y + fixedPointDivideRounded(dx * dy, (int64_t) b->x - a->x));
+}
+
+//! \brief Finds the segment x lies in
+//! \param table The table which is searched
+//! \param x The input value
+//! \retval Index i of the segment [i, i + 1]. Values outside the table map to the outermost segments
+static int findSegment(const PwlTable *table, const int32_t x) {
+    int low = 0;
+    int high = table->pointCount - 1;
+
+    // Binary search for the last point with points[i].x <= x
+    while (high - low > 1) {
+        const int mid = (low + high) / 2;
+        if (table->points[mid].x <= x) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+/* --- Function implementations --- */
+bool pwlIsValid(const PwlTable *table) {
+    // Check the amount of points
+    if (table == NULL || table->pointCount < 1 || table->pointCount > PWL_MAX_POINTS) return false;
+
+    // The x values have to be strictly increasing
+    for (int i = 1; i < table->pointCount; i++) {
+        if (table->points[i].x <= table->points[i - 1].x) return false;
+    }
+
+    return true;
+}
+
+int32_t pwlEvaluate(const PwlTable *table, const int32_t x) {
+    const PwlPoint *first = &table->points[0];
+    const PwlPoint *last = &table->points[table->pointCount - 1];
+
+    // A single point is a constant
+    if (table->pointCount == 1) return first->y;
+
+    // Below the first point
+    if (x <= first->x) {
+        if (table->lowerEnd == PWL_END_CLAMP) return first->y;
+        return interpolate(first, first + 1, x);
+    }
+
+    // Above the last point
+    if (x >= last->x) {
+        if (table->upperEnd == PWL_END_CLAMP) return last->y;
+        return interpolate(last - 1, last, x);
+    }
+
+    // Somewhere in between
+    const int segment = findSegment(table, x);
+    return interpolate(&table->points[segment], &table->points[segment + 1], x);
+}
+
+void pwlCalibrationBegin(PwlCalibration *calibration) {
+    // Clear everything
+    for (int i = 0; i < PWL_MAX_POINTS; i++) {
+        calibration->sumWeights[i] = 0;
+        calibration->sumWeightedResiduals[i] = 0;
+    }
+    calibration->sampleCount = 0;
+}
+
+void pwlCalibrationAddSample(PwlCalibration *calibration, const PwlTable *table, const int32_t x, const int32_t yReference) {
+    // How far off is the current table?
+    const int64_t residual = (int64_t) yReference - pwlEvaluate(table, x);
+
+    // Outside the table the residual belongs to the outermost point only
+    if (table->pointCount == 1 || x <= table->points[0].x) {
+        calibration->sumWeights[0] += PWL_CALIBRATION_WEIGHT_ONE;
+        calibration->sumWeightedResiduals[0] += PWL_CALIBRATION_WEIGHT_ONE * residual;
+    } else if (x >= table->points[table->pointCount - 1].x) {
+        calibration->sumWeights[table->pointCount - 1] += PWL_CALIBRATION_WEIGHT_ONE;
+        calibration->sumWeightedResiduals[table->pointCount - 1] += PWL_CALIBRATION_WEIGHT_ONE * residual;
+    } else {
+        // Inside, split it between both points depending on the distance (hat function)
+        const int segment = findSegment(table, x);
+        const PwlPoint *a = &table->points[segment];
+        const PwlPoint *b = &table->points[segment + 1];
+        const int64_t weightB = ((int64_t) x - a->x) * PWL_CALIBRATION_WEIGHT_ONE / ((int64_t) b->x - a->x);
+        const int64_t weightA = PWL_CALIBRATION_WEIGHT_ONE - weightB;
+
+        calibration->sumWeights[segment] += weightA;
+        calibration->sumWeightedResiduals[segment] += weightA * residual;
+        calibration->sumWeights[segment + 1] += weightB;
+        calibration->sumWeightedResiduals[segment + 1] += weightB * residual;
+    }
+
+    calibration->sampleCount++;
+}
+
+int pwlCalibrationApply(const PwlCalibration *calibration, PwlTable *table) {
+    int adjustedPoints = 0;
+
+    for (int i = 0; i < table->pointCount; i++) {
+        // Skip points which didn't see any samples
+        if (calibration->sumWeights[i] <= 0) continue;
+
+        // Move the point by its mean residual
+        table->points[i].y += (int32_t) fixedPointDivideRounded(calibration->sumWeightedResiduals[i], calibration->sumWeights[i]);
+        adjustedPoints++;
+    }
+
+    return adjustedPoints;
+}
+
+bool pwl_test(void) {
+    bool passed = true;
+
+    // A small table to test against
+    PwlTable table = {
+            .points = {{0, 0}, {10, 100}, {20, 150}},
+            .pointCount = 3,
+            .lowerEnd = PWL_END_CLAMP,
+            .upperEnd = PWL_END_CLAMP,
+    };
+    passed &= pwlIsValid(&table);
+
+    // Interior, breakpoints and rounding
+    passed &= pwlEvaluate(&table, 5) == 50;
+    passed &= pwlEvaluate(&table, 10) == 100;
+    passed &= pwlEvaluate(&table, 15) == 125;
+    passed &= pwlEvaluate(&table, 11) == 105;
+
+    // Both ends clamped ...
+    passed &= pwlEvaluate(&table, -5) == 0;
+    passed &= pwlEvaluate(&table, 25) == 150;
+
+    // ... and extrapolated
+    table.lowerEnd = PWL_END_EXTRAPOLATE;
+    table.upperEnd = PWL_END_EXTRAPOLATE;
+    passed &= pwlEvaluate(&table, -5) == -50;
+    passed &= pwlEvaluate(&table, 25) == 175;
+
+    // Learn y = 3x from a reference signal
+    PwlCalibration calibration;
+    pwlCalibrationBegin(&calibration);
+    for (int x = 0; x <= 20; x += 10) {
+        pwlCalibrationAddSample(&calibration, &table, x, 3 * x);
+    }
+    passed &= pwlCalibrationApply(&calibration, &table) == 3;
+    passed &= pwlEvaluate(&table, 15) == 45;
+
+    // Unsorted tables have to be rejected
+    table.points[1].x = 30;
+    passed &= !pwlIsValid(&table);
+
+    // Logging
+    if (passed) {
+        loggerInfo("Piecewise-linear tests passed");
+    } else {
+        loggerError("Piecewise-linear tests FAILED");
+    }
+
+    return passed;
+}
@@ -0,0 +1,92 @@
+/* --- Includes --- */
+#include "SensorManager/SensorHal.h"
+
+// C includes
+#include <stddef.h>
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+#if !CONFIG_IDF_TARGET_LINUX
+static const SensorHalBackend *backend_ = &sensorHalHardware;
+#else
+static const SensorHalBackend *backend_ = NULL;
+#endif
+
+/* --- Function implementations --- */
+bool sensorHalSelect(const SensorHalBackend *backend) {
+    // Is the backend complete?
+    if (backend == NULL || backend->init == NULL || backend->initAdc == NULL || backend->readMilliVolts == NULL || backend->initPulse == NULL ||
+        backend->enableEdges == NULL || backend->disableEdges == NULL || backend->getTimeUs == NULL) {
+        // Logging
+        loggerError("Incomplete sensor backend!");
+
+        return false;
+    }
+
+    backend_ = backend;
+
+    // Logging
+    loggerInfo("Using the '%s' sensor backend", backend->name);
+
+    return true;
+}
+
+const SensorHalBackend *sensorHalGetBackend(void) {
+    return backend_;
+}
+
+bool sensorHalInit(void) {
+    // Was a backend selected?
+    if (backend_ == NULL) {
+        // Logging
+        loggerCritical("No sensor backend selected!");
+
+        return false;
+    }
+
+    return backend_->init();
+}
+
+bool sensorHalInitAdc(const SENSOR_HAL_ADC channel) {
+    if (backend_ == NULL || channel >= SENSOR_HAL_ADC_COUNT) return false;
+
+    return backend_->initAdc(channel);
+}
+
+bool sensorHalReadMilliVolts(const SENSOR_HAL_ADC channel, int *voltageMV) {
+    if (backend_ == NULL || channel >= SENSOR_HAL_ADC_COUNT) return false;
+
+    return backend_->readMilliVolts(channel, voltageMV);
+}
+
+bool sensorHalInitPulse(const SENSOR_HAL_PULSE input) {
+    if (backend_ == NULL || input >= SENSOR_HAL_PULSE_COUNT) return false;
+
+    return backend_->initPulse(input);
+}
+
+bool sensorHalEnableEdges(const SENSOR_HAL_PULSE input, const SensorHalEdgeHandler handler) {
+    if (backend_ == NULL || input >= SENSOR_HAL_PULSE_COUNT || handler == NULL) return false;
+
+    return backend_->enableEdges(input, handler);
+}
+
+void sensorHalDisableEdges(const SENSOR_HAL_PULSE input) {
+    if (backend_ == NULL || input >= SENSOR_HAL_PULSE_COUNT) return;
+
+    backend_->disableEdges(input);
+}
+
+int64_t IRAM_ATTR sensorHalGetTimeUs(void) {
+    if (backend_ == NULL) return 0;
+
+    return backend_->getTimeUs();
+}
+
+bool sensorHalAdvanceTo(const int64_t timeUs) {
+    // Only the virtual backends have a clock to move
+    if (backend_ == NULL || backend_->advanceTo == NULL) return false;
+
+    return backend_->advanceTo(timeUs);
+}
@@ -0,0 +1,187 @@
+/* --- Includes --- */
+#include "SensorManager/SensorHal.h"
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// What happens next on a pulse input
+typedef struct {
+    int64_t nextEventUs;
+    bool nextIsEdge;// False = only check the frequency again, there was no edge to schedule
+    int64_t nextSpuriousEdgeUs;
+} PulseState;
+
+static SensorHalGeneratorConfig config_;
+static uint32_t randomState_ = 1;
+static int64_t clockUs_ = 0;
+static PulseState pulseStates_[SENSOR_HAL_PULSE_COUNT];
+static SensorHalEdgeHandler edgeHandlers_[SENSOR_HAL_PULSE_COUNT];
+
+//! \brief xorshift32, fast and the same on every platform
+//! \retval The next random number
+static uint32_t nextRandom(void) {
+    randomState_ ^= randomState_ << 13;
+    randomState_ ^= randomState_ >> 17;
+    randomState_ ^= randomState_ << 5;
+    return randomState_;
+}
+
+//! \brief Returns a uniformly distributed random number
+//! \param amplitude The limit
+//! \retval A number in [-amplitude, amplitude]
+static int32_t randomAround(const int32_t amplitude) {
+    if (amplitude <= 0) return 0;
+    return (int32_t) (nextRandom() % (uint32_t) (2 * amplitude + 1)) - amplitude;
+}
+
+//! \brief Checks if a periodic window is active. The window is at the end of every period
+//! \param timeUs The time to check
+//! \param everyUs The period, 0 = never
+//! \param lengthUs The length of the window
+//! \retval Boolean
+static bool isInWindow(const int64_t timeUs, const int64_t everyUs, const int64_t lengthUs) {
+    if (everyUs <= 0) return false;
+    return timeUs % everyUs >= everyUs - lengthUs;
+}
+
+//! \brief Plans the next event of a pulse input after the current time
+//! \param input The input
+static void scheduleNextEdge(const SENSOR_HAL_PULSE input) {
+    const SensorHalGeneratorPulse *pulse = &config_.pulse[input];
+    PulseState *state = &pulseStates_[input];
+
+    // Frequency at the current time
+    const int64_t frequency = pulse->frequencyMilliHz + (int64_t) pulse->rampMilliHzPerS * clockUs_ / 1000000;
+
+    // No signal, check again later
+    if (frequency <= 0) {
+        state->nextEventUs = clockUs_ + SENSOR_HAL_GENERATOR_IDLE_US;
+        state->nextIsEdge = false;
+        return;
+    }
+
+    // One period later, the jitter never moves an edge before the current time
+    int64_t periodUs = 1000000000LL / frequency + randomAround(pulse->jitterUs);
+    if (periodUs < 1) periodUs = 1;
+    state->nextEventUs = clockUs_ + periodUs;
+    state->nextIsEdge = true;
+}
+
+/* --- Function implementations --- */
+void sensorHalGeneratorConfigure(const SensorHalGeneratorConfig *config) {
+    config_ = *config;
+    randomState_ = config->seed != 0 ? config->seed : 1;
+    clockUs_ = 0;
+
+    // The first edge of every input comes one period after the start
+    for (int input = 0; input < SENSOR_HAL_PULSE_COUNT; input++) {
+        scheduleNextEdge(input);
+        pulseStates_[input].nextSpuriousEdgeUs = config->pulse[input].spuriousEdgeEveryUs > 0 ? config->pulse[input].spuriousEdgeEveryUs : INT64_MAX;
+    }
+}
+
+//! \brief See SensorHalBackend
+static bool generatorInit(void) {
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static bool generatorInitAdc(const SENSOR_HAL_ADC channel) {
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static bool generatorReadMilliVolts(const SENSOR_HAL_ADC channel, int *voltageMV) {
+    const SensorHalGeneratorAdc *adc = &config_.adc[channel];
+
+    // Ramp plus noise plus the spike, if one is active
+    int64_t voltage = adc->baseMV + (int64_t) adc->rampMVPerS * clockUs_ / 1000000 + randomAround(adc->noiseMV);
+    if (isInWindow(clockUs_, adc->spikeEveryUs, SENSOR_HAL_GENERATOR_SPIKE_US)) voltage += adc->spikeMV;
+
+    // An ADC can't read below 0
+    if (voltage < 0) voltage = 0;
+    *voltageMV = (int) voltage;
+
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static bool generatorInitPulse(const SENSOR_HAL_PULSE input) {
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static bool generatorEnableEdges(const SENSOR_HAL_PULSE input, const SensorHalEdgeHandler handler) {
+    edgeHandlers_[input] = handler;
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static void generatorDisableEdges(const SENSOR_HAL_PULSE input) {
+    edgeHandlers_[input] = NULL;
+}
+
+//! \brief See SensorHalBackend
+static int64_t generatorGetTimeUs(void) {
+    return clockUs_;
+}
+
+//! \brief See SensorHalBackend
+static bool generatorAdvanceTo(const int64_t timeUs) {
+    // ReSharper disable once CppDFAEndlessLoop
+    while (1) {
+        // Find the earliest event of all inputs
+        int input = -1;
+        bool spurious = false;
+        int64_t eventUs = timeUs + 1;
+        for (int i = 0; i < SENSOR_HAL_PULSE_COUNT; i++) {
+            if (pulseStates_[i].nextEventUs < eventUs) {
+                input = i;
+                spurious = false;
+                eventUs = pulseStates_[i].nextEventUs;
+            }
+            if (pulseStates_[i].nextSpuriousEdgeUs < eventUs) {
+                input = i;
+                spurious = true;
+                eventUs = pulseStates_[i].nextSpuriousEdgeUs;
+            }
+        }
+
+        // Nothing left until the new time?
+        if (input < 0) break;
+        clockUs_ = eventUs;
+
+        const SensorHalGeneratorPulse *pulse = &config_.pulse[input];
+        PulseState *state = &pulseStates_[input];
+        bool deliver;
+        if (spurious) {
+            // An ignition spike always gets through
+            deliver = true;
+            state->nextSpuriousEdgeUs += pulse->spuriousEdgeEveryUs;
+        } else {
+            // A regular edge, unless it is lost in a dropout
+            deliver = state->nextIsEdge && !isInWindow(clockUs_, pulse->dropoutEveryUs, pulse->dropoutLengthUs);
+            scheduleNextEdge(input);
+        }
+
+        if (deliver && edgeHandlers_[input] != NULL) edgeHandlers_[input](input, clockUs_);
+    }
+
+    if (timeUs > clockUs_) clockUs_ = timeUs;
+
+    // The signals go on forever
+    return true;
+}
+
+const SensorHalBackend sensorHalGenerator = {
+        .name = "generator",
+        .init = generatorInit,
+        .initAdc = generatorInitAdc,
+        .readMilliVolts = generatorReadMilliVolts,
+        .initPulse = generatorInitPulse,
+        .enableEdges = generatorEnableEdges,
+        .disableEdges = generatorDisableEdges,
+        .getTimeUs = generatorGetTimeUs,
+        .advanceTo = generatorAdvanceTo,
+};
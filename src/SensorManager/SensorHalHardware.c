@@ -0,0 +1,194 @@
+/* --- Includes --- */
+#include "SensorManager/SensorHalHardware.h"
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// How an analog input is wired
+typedef struct {
+    adc_unit_t unit;
+    adc_channel_t channel;
+    gpio_num_t gpio;
+    adc_atten_t atten;
+    const char *name;
+    const char *calibrationKey;// NVS key of the calibration
+} AdcInput;
+
+static const AdcInput adcInputs_[SENSOR_HAL_ADC_COUNT] = {
+        [SENSOR_HAL_ADC_OIL_PRESSURE] = {ADC_UNIT_2, ADC_CHANNEL_OIL_PRESSURE, GPIO_OIL_PRESSURE, ADC_ATTEN_DB_2_5, "oil pressure", "oil"},
+        [SENSOR_HAL_ADC_FUEL_LEVEL] = {ADC_UNIT_2, ADC_CHANNEL_FUEL_LEVEL, GPIO_FUEL_LEVEL, ADC_ATTEN_DB_2_5, "fuel level", "fuel"},
+        [SENSOR_HAL_ADC_WATER_TEMPERATURE] = {ADC_UNIT_2, ADC_CHANNEL_WATER_TEMPERATURE, GPIO_WATER_TEMPERATURE, ADC_ATTEN_DB_12, "water temperature", "water"},
+        [SENSOR_HAL_ADC_INT_TEMPERATURE] = {ADC_UNIT_1, ADC_CHANNEL_INT_TEMPERATURE, GPIO_INT_TEMPERATURE, ADC_ATTEN_DB_6, "internal temperature sensor", "int_temp"},
+};
+
+static const gpio_num_t pulseGpios_[SENSOR_HAL_PULSE_COUNT] = {
+        [SENSOR_HAL_PULSE_SPEED] = GPIO_SPEED,
+        [SENSOR_HAL_PULSE_RPM] = GPIO_RPM,
+};
+
+// ADC stuff
+static adc_oneshot_unit_handle_t adc1Handle_;
+static bool initAdc1Failed_ = false;
+static adc_oneshot_unit_handle_t adc2Handle_;
+static bool initAdc2Failed_ = false;
+static AdcCalibration calibrations_[SENSOR_HAL_ADC_COUNT];
+
+// Interrupt stuff
+static bool initIsrServiceFailed_ = false;
+static SensorHalEdgeHandler edgeHandlers_[SENSOR_HAL_PULSE_COUNT];
+
+//! \brief ISR of the pulse inputs, triggered everytime there is a falling edge
+//! \param arg The SENSOR_HAL_PULSE input
+static void IRAM_ATTR edgeInterruptHandler(void *arg) {
+    const SENSOR_HAL_PULSE input = (SENSOR_HAL_PULSE) arg;
+    edgeHandlers_[input](input, esp_timer_get_time());
+}
+
+//! \brief Returns the handle of an ADC unit
+//! \param unit The unit
+//! \retval The handle or NULL if the unit failed to initialize
+static adc_oneshot_unit_handle_t getUnitHandle(const adc_unit_t unit) {
+    if (unit == ADC_UNIT_1) return initAdc1Failed_ ? NULL : adc1Handle_;
+    return initAdc2Failed_ ? NULL : adc2Handle_;
+}
+
+/* --- Function implementations --- */
+
+//! \brief See SensorHalBackend
+static bool hardwareInit(void) {
+    // Initialize the ADC2
+    const adc_oneshot_unit_init_cfg_t adc2InitConfig = {
+            .unit_id = ADC_UNIT_2,
+            .ulp_mode = ADC_ULP_MODE_DISABLE};
+    if (adc_oneshot_new_unit(&adc2InitConfig, &adc2Handle_) != ESP_OK) {
+        // Init was NOT successful!
+        initAdc2Failed_ = true;
+
+        // Logging
+        loggerWarn("Failed to initialize ADC2!");
+
+        // Initialization failed
+        return false;
+    }
+
+    // Initialize the ADC1
+    const adc_oneshot_unit_init_cfg_t adc1InitConfig = {
+            .unit_id = ADC_UNIT_1,
+            .ulp_mode = ADC_ULP_MODE_DISABLE};
+    if (adc_oneshot_new_unit(&adc1InitConfig, &adc1Handle_) != ESP_OK) {
+        // Init was NOT successful!
+        initAdc1Failed_ = true;
+
+        // Logging
+        loggerWarn("Failed to initialize ADC1!");
+    }
+
+    // Install ISR service
+    if (gpio_install_isr_service(ESP_INTR_FLAG_IRAM) != ESP_OK) {
+        // Failed, so we cant install our speed/rpm ISR's
+        initIsrServiceFailed_ = true;
+
+        // Logging
+        loggerError("Couldn't install the ISR service. Speed and RPM are unavailable!");
+    }
+
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static bool hardwareInitAdc(const SENSOR_HAL_ADC channel) {
+    const AdcInput *input = &adcInputs_[channel];
+
+    // Is the unit available?
+    const adc_oneshot_unit_handle_t unitHandle = getUnitHandle(input->unit);
+    if (unitHandle == NULL) return false;
+
+    // Configure the GPIO
+    gpio_set_direction(input->gpio, GPIO_MODE_INPUT);
+    gpio_set_pull_mode(input->gpio, GPIO_PULLDOWN_ONLY);
+
+    // Create the config
+    const adc_oneshot_chan_cfg_t channelConfig = {
+            .bitwidth = ADC_BITWIDTH_12,
+            .atten = input->atten,
+    };
+    if (adc_oneshot_config_channel(unitHandle, input->channel, &channelConfig) != ESP_OK) {
+        // Logging
+        loggerError("Failed to initialize ADC%d channel: %d", input->unit + 1, input->channel);
+
+        return false;
+    }
+
+    // Restore the calibration from the last boot or derive it from the curve fitting scheme
+    if (!adcCalibrationInit(input->calibrationKey, input->unit, input->channel, input->atten, &calibrations_[channel])) {
+        // Logging
+        loggerError("Calibrating the %s channel FAILED", input->name);
+
+        return false;
+    }
+
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static bool hardwareReadMilliVolts(const SENSOR_HAL_ADC channel, int *voltageMV) {
+    // Try to read from the ADC
+    int rawAdcValue = 0;
+    if (adc_oneshot_read(getUnitHandle(adcInputs_[channel].unit), adcInputs_[channel].channel, &rawAdcValue) != ESP_OK) return false;
+
+    // Convert the ADC value to a voltage
+    *voltageMV = adcCalibrationRawToMilliVolts(&calibrations_[channel], rawAdcValue);
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static bool hardwareInitPulse(const SENSOR_HAL_PULSE input) {
+    // Setup gpio
+    gpio_set_direction(pulseGpios_[input], GPIO_MODE_INPUT);
+    gpio_set_pull_mode(pulseGpios_[input], GPIO_PULLDOWN_ONLY);
+    gpio_set_intr_type(pulseGpios_[input], GPIO_INTR_NEGEDGE);
+
+    // Without the ISR service there are no edges
+    return !initIsrServiceFailed_;
+}
+
+//! \brief See SensorHalBackend
+static bool hardwareEnableEdges(const SENSOR_HAL_PULSE input, const SensorHalEdgeHandler handler) {
+    // Was the init successfully?
+    if (initIsrServiceFailed_) return false;
+
+    edgeHandlers_[input] = handler;
+    return gpio_isr_handler_add(pulseGpios_[input], edgeInterruptHandler, (void *) input) == ESP_OK;
+}
+
+//! \brief See SensorHalBackend
+static void hardwareDisableEdges(const SENSOR_HAL_PULSE input) {
+    // Was the init successfully?
+    if (initIsrServiceFailed_) return;
+
+    gpio_isr_handler_remove(pulseGpios_[input]);
+}
+
+bool sensorHalHardwareSetTrim(const SENSOR_HAL_ADC channel, const int32_t gain, const int32_t offsetMV) {
+    if (channel >= SENSOR_HAL_ADC_COUNT) return false;
+
+    return adcCalibrationSetTrim(adcInputs_[channel].calibrationKey, &calibrations_[channel], gain, offsetMV);
+}
+
+//! \brief See SensorHalBackend
+static int64_t IRAM_ATTR hardwareGetTimeUs(void) {
+    return esp_timer_get_time();
+}
+
+const SensorHalBackend sensorHalHardware = {
+        .name = "hardware",
+        .init = hardwareInit,
+        .initAdc = hardwareInitAdc,
+        .readMilliVolts = hardwareReadMilliVolts,
+        .initPulse = hardwareInitPulse,
+        .enableEdges = hardwareEnableEdges,
+        .disableEdges = hardwareDisableEdges,
+        .getTimeUs = hardwareGetTimeUs,
+        .advanceTo = NULL,
+};
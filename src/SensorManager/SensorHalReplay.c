@@ -0,0 +1,165 @@
+/* --- Includes --- */
+#include "SensorManager/SensorHal.h"
+
+// C includes
+#include <stdio.h>
+
+/* --- Private Defines & Macros --- */
+
+// Longest line of a recording
+#define REPLAY_MAX_LINE_LENGTH 64
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// One line of the recording
+typedef struct {
+    int64_t timeUs;
+    char type;// 'E' = edge, 'A' = ADC voltage
+    int channel;
+    int voltageMV;
+} ReplayRecord;
+
+static FILE *file_ = NULL;
+static int lineNumber_ = 0;
+
+// The next record which wasn't delivered yet
+static ReplayRecord nextRecord_;
+static bool hasNextRecord_ = false;
+
+// Virtual clock and what the inputs look like at that time
+static int64_t clockUs_ = 0;
+static int voltagesMV_[SENSOR_HAL_ADC_COUNT];
+static SensorHalEdgeHandler edgeHandlers_[SENSOR_HAL_PULSE_COUNT];
+
+//! \brief Reads the next valid record of the recording into nextRecord_
+static void readNextRecord(void) {
+    hasNextRecord_ = false;
+    if (file_ == NULL) return;
+
+    char line[REPLAY_MAX_LINE_LENGTH];
+    while (fgets(line, sizeof(line), file_) != NULL) {
+        lineNumber_++;
+
+        // Skip comments and empty lines
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+
+        long long timeUs = 0;
+        ReplayRecord record = {0};
+        const int fields = sscanf(line, "%lld %c %d %d", &timeUs, &record.type, &record.channel, &record.voltageMV);
+        record.timeUs = timeUs;
+
+        // Is the record valid?
+        const bool validEdge = fields >= 3 && record.type == 'E' && record.channel >= 0 && record.channel < SENSOR_HAL_PULSE_COUNT;
+        const bool validVoltage = fields == 4 && record.type == 'A' && record.channel >= 0 && record.channel < SENSOR_HAL_ADC_COUNT;
+        if (!validEdge && !validVoltage) {
+            // Logging
+            loggerWarn("Skipping invalid replay record in line %d", lineNumber_);
+
+            continue;
+        }
+
+        nextRecord_ = record;
+        hasNextRecord_ = true;
+        return;
+    }
+}
+
+/* --- Function implementations --- */
+bool sensorHalReplayOpen(const char *path) {
+    sensorHalReplayClose();
+
+    file_ = fopen(path, "r");
+    if (file_ == NULL) {
+        // Logging
+        loggerError("Couldn't open the replay file '%s'", path);
+
+        return false;
+    }
+
+    // Start from scratch
+    lineNumber_ = 0;
+    clockUs_ = 0;
+    for (int i = 0; i < SENSOR_HAL_ADC_COUNT; i++) voltagesMV_[i] = 0;
+    readNextRecord();
+
+    return true;
+}
+
+void sensorHalReplayClose(void) {
+    if (file_ != NULL) fclose(file_);
+    file_ = NULL;
+    hasNextRecord_ = false;
+}
+
+//! \brief See SensorHalBackend
+static bool replayInit(void) {
+    // Logging
+    if (file_ == NULL) loggerWarn("No replay file opened, all inputs stay silent");
+
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static bool replayInitAdc(const SENSOR_HAL_ADC channel) {
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static bool replayReadMilliVolts(const SENSOR_HAL_ADC channel, int *voltageMV) {
+    *voltageMV = voltagesMV_[channel];
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static bool replayInitPulse(const SENSOR_HAL_PULSE input) {
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static bool replayEnableEdges(const SENSOR_HAL_PULSE input, const SensorHalEdgeHandler handler) {
+    edgeHandlers_[input] = handler;
+    return true;
+}
+
+//! \brief See SensorHalBackend
+static void replayDisableEdges(const SENSOR_HAL_PULSE input) {
+    edgeHandlers_[input] = NULL;
+}
+
+//! \brief See SensorHalBackend
+static int64_t replayGetTimeUs(void) {
+    return clockUs_;
+}
+
+//! \brief See SensorHalBackend
+static bool replayAdvanceTo(const int64_t timeUs) {
+    // Deliver everything up to the new time in order
+    while (hasNextRecord_ && nextRecord_.timeUs <= timeUs) {
+        // The edge handlers see the clock at the time of their edge
+        if (nextRecord_.timeUs > clockUs_) clockUs_ = nextRecord_.timeUs;
+
+        if (nextRecord_.type == 'E') {
+            if (edgeHandlers_[nextRecord_.channel] != NULL) edgeHandlers_[nextRecord_.channel](nextRecord_.channel, nextRecord_.timeUs);
+        } else {
+            voltagesMV_[nextRecord_.channel] = nextRecord_.voltageMV;
+        }
+
+        readNextRecord();
+    }
+
+    if (timeUs > clockUs_) clockUs_ = timeUs;
+
+    return hasNextRecord_;
+}
+
+const SensorHalBackend sensorHalReplay = {
+        .name = "replay",
+        .init = replayInit,
+        .initAdc = replayInitAdc,
+        .readMilliVolts = replayReadMilliVolts,
+        .initPulse = replayInitPulse,
+        .enableEdges = replayEnableEdges,
+        .disableEdges = replayDisableEdges,
+        .getTimeUs = replayGetTimeUs,
+        .advanceTo = replayAdvanceTo,
+};
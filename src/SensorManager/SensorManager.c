@@ -1,78 +1,207 @@
 /* --- Includes --- */
 #include "SensorManager/SensorManager.h"
 
+// C includes
+#include <time.h>
+
+// espidf includes
+#include <esp_cpu.h>
+
+#if !CONFIG_IDF_TARGET_LINUX
+// espidf includes
+#include <esp_system.h>
+#endif
+
 /* --- Private Defines & Macros --- */
 
+// How long the self test runs on the virtual clock and how often it updates
+#define SENSOR_MANAGER_TEST_DURATION_US (60 * 1000000LL)
+#define SENSOR_MANAGER_TEST_STEP_US (100 * 1000LL)
+
+// How many rpm conversions are timed by the benchmark
+#define SENSOR_MANAGER_RPM_BENCHMARK_ITERATIONS 1000
+
+// How long a restart waits for an update of the odometer that is running right now
+#define SENSOR_MANAGER_ODOMETER_SHUTDOWN_WAIT_MS 100
+
 /* --- Private Variables, Typedefs etc. --- */
-// ADC stuff
-static adc_oneshot_unit_handle_t adc2Handle_;
-static bool initAdc2Failed_ = false;
-static adc_oneshot_unit_handle_t adc1Handle_;
-static bool initAdc1Failed_ = false;
+// Subscribers of each sensor, unused slots are NULL
+static SensorSubscriber subscribers_[SENSOR_COUNT][SENSOR_MAX_SUBSCRIBERS];
+
+// Printable names of the sensors
+static const char *sensorNames_[SENSOR_COUNT] = {
+        [SENSOR_OIL_PRESSURE] = "Oil pressure",
+        [SENSOR_FUEL_LEVEL_PERCENT] = "Fuel level percent",
+        [SENSOR_FUEL_LEVEL_LITRE] = "Fuel level litre",
+        [SENSOR_WATER_TEMPERATURE] = "Water temperature",
+        [SENSOR_INTERNAL_TEMPERATURE] = "Internal temperature",
+        [SENSOR_SPEED] = "Speed",
+        [SENSOR_RPM] = "RPM",
+        [SENSOR_GEAR] = "Gear",
+        [SENSOR_BLINKER_LEFT] = "Left blinker",
+        [SENSOR_BLINKER_RIGHT] = "Right blinker",
+        [SENSOR_BLINKER_PATTERN] = "Blinker pattern",
+        [SENSOR_BUTTON_1] = "Button 1",
+        [SENSOR_BUTTON_2] = "Button 2",
+        [SENSOR_BUTTON_3] = "Button 3",
+        [SENSOR_SHIFT_LIGHT] = "Shift light",
+        [SENSOR_ODOMETER] = "Odometer",
+        [SENSOR_TRIP] = "Trip",
+};
+
+// Sensor backend stuff
+static bool initHalFailed_ = false;
 
 // Oil pressure stuff
 static bool oilPressure_ = false;
-static adc_cali_handle_t adc2OilCaliHandle_;
-static bool initAdc2OilChannelFailed_ = false;
-static void (*oilPressureCallback_)(void *) = NULL;
+static bool initOilChannelFailed_ = false;
 
 // Fuel level stuff
 static int fuelLevelInPercent_ = 0;
 static int fuelLevelInLitre_ = 0;
-static float fuelLevelResistance_ = 0.0f;
-static adc_cali_handle_t adc2FuelCaliHandle_;
-static bool initAdc2FuelChannelFailed_ = false;
-static void (*fuelLevelPercentCallback_)(void *) = NULL;
-static void (*fuelLevelLitreCallback_)(void *) = NULL;
+static int32_t fuelLevelResistance_ = 0;// mOhm
+static bool initFuelChannelFailed_ = false;
 
 // Water temperature stuff
-static float waterTemperature_ = 0.0f;
-static float waterTemperatureResistance_ = 0.0f;
-static adc_cali_handle_t adc2WaterCaliHandle_;
-static bool initAdc2WaterChannelFailed_ = false;
-static void (*waterTemperatureCallback_)(void *) = NULL;
+static int waterTemperature_ = 0;                // 0.1 °C
+static int32_t waterTemperatureResistance_ = 0;// mOhm
+static bool initWaterChannelFailed_ = false;
 
 // Speed stuff
-static int speedInHz_ = -1;
+static int speedInMilliHz_ = -1;
 static int speed_ = -1;
-static int64_t lastTimeOfFallingEdgeSpeed_ = 0;
-static int64_t timeOfFallingEdgeSpeed_ = 0;
+static EdgeRecord speedEdges_;
+static uint32_t speedEdgeCountAtStop_ = 0;
 static bool speedIsrActive_ = false;
 static bool initSpeedIsrFailed_ = false;
-static void (*speedCallback_)(void *) = NULL;
+
+// Odometer stuff. The speed task updates it, the other tasks only request changes. The lock is a mutex, not a
+// critical section, as it is held while the odometer is written to the NVS
+static Odometer odometer_;
+static SemaphoreHandle_t odometerLock_ = NULL;
+static StaticSemaphore_t odometerLockBuffer_;
+static int32_t odometerMeters_ = 0;// Copies for the other tasks, the pulses are 64 bit
+static int32_t tripMeters_ = 0;
+static bool odometerPersistent_ = false;
+static volatile bool tripResetRequested_ = false;
+static volatile int32_t odometerStoreIntervalMeters_ = ODOMETER_DEFAULT_STORE_INTERVAL_M;
 
 // RPM stuff
-static int rpmInHz_ = -1;
+static int rpmInMilliHz_ = -1;
 static int rpm_ = -1;
-static int64_t lastTimeOfFallingEdgeRPM_ = 0;
-static int64_t timeOfFallingEdgeRPM_ = 0;
+static EdgeRecord rpmEdges_;
+static uint32_t rpmEdgeCountAtStop_ = 0;
 static bool rpmIsrActive_ = false;
 static bool initRpmIsrFailed_ = false;
-static void (*rpmCallback_)(void *) = NULL;
+
+// Converts the rpm signal frequency [mHz] to rpm. The points are where the old multiplier ladder
+// changed its multiplier, so both agree on them and everything in between is interpolated
+static PwlTable rpmConversionTable_ = {
+        .points = {{0, 0}, {8000, 400}, {11000, 500}, {17000, 700}, {25000, 1000}, {56000, 1931}, {92000, 3000}, {123000, 4000}, {157000, 5000}, {188000, 5999}, {220000, 7000}, {262000, 8001}},
+        .pointCount = 12,
+        .lowerEnd = PWL_END_CLAMP,
+        .upperEnd = PWL_END_EXTRAPOLATE,
+};
+static PwlCalibration rpmCalibration_;
+static bool rpmCalibrationActive_ = false;
+
+// Shift light stuff, it gets the rpm of every single signal period
+static ShiftLight shiftLight_;
+static uint32_t shiftLightEdgeCount_ = 0;
+
+// Gear stuff. Speed and rpm are updated by different tasks, both update the estimator
+static GearEstimator gearEstimator_;
+static int gear_ = GEAR_NEUTRAL;
+static volatile bool gearEstimationEnabled_ = false;
+static portMUX_TYPE gearLock_ = portMUX_INITIALIZER_UNLOCKED;
+
+// Digital input stuff
+static const SENSOR digitalInputSensors_[DIGITAL_INPUT_COUNT] = {
+        [DIGITAL_INPUT_BLINKER_LEFT] = SENSOR_BLINKER_LEFT,
+        [DIGITAL_INPUT_BLINKER_RIGHT] = SENSOR_BLINKER_RIGHT,
+        [DIGITAL_INPUT_BUTTON_1] = SENSOR_BUTTON_1,
+        [DIGITAL_INPUT_BUTTON_2] = SENSOR_BUTTON_2,
+        [DIGITAL_INPUT_BUTTON_3] = SENSOR_BUTTON_3,
+};
+static BlinkDetector blinkDetector_;
+static BLINKER_PATTERN blinkerPattern_ = BLINKER_PATTERN_OFF;
+static bool initDigitalInputsFailed_ = false;
+
+// CAN stuff. Where the channels are in the frames, an example layout of an aftermarket ECU broadcast. Adjust it to the car
+static const CanSignal canSignals_[] = {
+        {0x360, false, CAN_CHANNEL_RPM, 0, 16, CAN_BYTE_ORDER_INTEL, false, 1, 1, 0, 0, 10000},                // 1 rpm
+        {0x361, false, CAN_CHANNEL_OIL_PRESSURE, 0, 1, CAN_BYTE_ORDER_INTEL, false, 1, 1, 0, 0, 1},            // Pressure switch
+        {0x362, false, CAN_CHANNEL_FUEL_LEVEL, 0, 8, CAN_BYTE_ORDER_INTEL, false, 100, 255, 0, 0, 100},        // 0 - 255 = empty - full
+        {0x370, false, CAN_CHANNEL_SPEED, 0, 16, CAN_BYTE_ORDER_INTEL, false, 1, 10, 0, 0, 300},               // 0.1 km/h
+        {0x3E0, false, CAN_CHANNEL_WATER_TEMPERATURE, 7, 16, CAN_BYTE_ORDER_MOTOROLA, false, 1, 1, -2732, -400, 1500},// 0.1 K
+};
+static CanDecoder canDecoder_;
+static uint32_t canChannels_ = CAN_DEFAULT_CHANNELS;
+static uint8_t canQualities_[CAN_CHANNEL_COUNT];// Of the last published samples
+static bool initCanFailed_ = false;
 
 // Internal temperature sensor stuff
-static int intTempRawAdcValue_ = 0;
 static int intTempVoltageMV_ = 0;
-static double internalTemperature_ = 0.0;
-static adc_cali_handle_t adc2IntTempCaliHandle_;
-static bool initAdc1IntTempChannelFailed_ = false;
-static void (*internalTemperatureCallback_)(void *) = NULL;
+static int internalTemperature_ = 0;// 0.1 °C
+static bool initIntTempChannelFailed_ = false;
 
 // Temporary stuff so I don't forget anything to implement
 static int tempSensor2_ = -1;
 
-//! \brief Calculates the resistance of a voltage divider
-//! \param preR1VoltageV The original voltage the divider works with [in Volts] e.g. 3.3V
-//! \param voltageMV The measured voltage between R1 and R2 [in Millivolts]
-//! \param r1 The resistance of R1
-//! \retval The calculated resistance of R2 as float
-float calculateVoltageDividerR2(const float preR1VoltageV, const int voltageMV, const int r1) {
-    const float vIn = preR1VoltageV;
-    const float vOut = (float) voltageMV / 1000.0f;
-    const float r = (float) r1;
+//! \brief Hands a new sample to every subscriber of the sensor
+//! \param sensorType The sensor the sample belongs to
+//! \param value The value in the fixed-point unit of the sensor
+//! \param unit The unit of the value
+//! \param timestampUs When the value was captured [sensorHalGetTimeUs() time in us]
+//! \param quality SAMPLE_QUALITY_* flags
+static void publishSample(const SENSOR sensorType, const int32_t value, const SENSOR_UNIT unit, const int64_t timestampUs, const uint8_t quality) {
+    // Build the sample on the stack, subscribers only get a pointer to it
+    const SensorSample sample = {
+            .id = sensorType,
+            .value = value,
+            .unit = unit,
+            .timestampUs = timestampUs,
+            .quality = quality,
+    };
+
+    // Call every subscriber
+    for (int i = 0; i < SENSOR_MAX_SUBSCRIBERS; i++) {
+        if (subscribers_[sensorType][i] != NULL) {
+            subscribers_[sensorType][i](&sample);
+        }
+    }
+}
+
+//! \brief Updates a channel from the CAN bus instead of its wired input and publishes it if it or its quality changed
+//! \param channel The channel
+//! \param sensorType The sensor it feeds
+//! \param unit The unit of the sensor
+//! \param value The current value, it is replaced by the latest one
+//! \param timestampUs Where the time of its frame is written to
+//! \param quality Where the SAMPLE_QUALITY_* flags are written to
+static void updateFromCan(const CAN_CHANNEL channel, const SENSOR sensorType, const SENSOR_UNIT unit, int *value, int64_t *timestampUs, uint8_t *quality) {
+    const int64_t nowUs = sensorHalGetTimeUs();
+    *timestampUs = nowUs;
+
+    // Was it received at all?
+    CanSignalValue latest;
+    if (initCanFailed_ || !canDecoderGetValue(&canDecoder_, channel, &latest)) {
+        *quality = SAMPLE_QUALITY_READ_FAILED;
+    } else {
+        *quality = latest.outOfRange ? SAMPLE_QUALITY_OUT_OF_RANGE : SAMPLE_QUALITY_OK;
+        *timestampUs = latest.timestampUs;
+
+        // Is its frame still sent?
+        if (nowUs - latest.timestampUs > CAN_SIGNAL_TIMEOUT_US) *quality |= SAMPLE_QUALITY_STALE;
+    }
 
-    // R2 = R1 * (voltageMV / (preR1VoltageV - voltageMV))
-    return r * (vOut / (vIn - vOut));
+    // Did it change?
+    const int oldValue = *value;
+    if (*quality != SAMPLE_QUALITY_READ_FAILED) *value = latest.value;
+    if (oldValue != *value || canQualities_[channel] != *quality) {
+        canQualities_[channel] = *quality;
+        publishSample(sensorType, *value, unit, *timestampUs, *quality);
+    }
 }
 
 //! \brief Calculates the fuel level in PERCENT from the measured R2 resistance.
@@ -81,240 +210,232 @@ float calculateVoltageDividerR2(const float preR1VoltageV, const int voltageMV,
 //! \retval The fuel level in PERCENT as int
 //! TODO: Implement the non-linear function!
 int calculateFuelLevelFromResistance() {
-    float resistance = fuelLevelResistance_;
+    int32_t resistance = fuelLevelResistance_;
 
     // Remove the resistance offset
-    resistance -= FUEL_LEVEL_OFFSET;
+    resistance -= FUEL_LEVEL_OFFSET_MILLIOHM;
 
     // Check if its < 0
-    if (resistance < 0.0f) resistance = 0.0f;
+    if (resistance < 0) resistance = 0;
 
     // Check if its > FUEL_LEVEL_TO_PERCENTAGE - FUEL_LEVEL_OFFSET
-    if (resistance > FUEL_LEVEL_TO_PERCENTAGE - FUEL_LEVEL_OFFSET) resistance = FUEL_LEVEL_TO_PERCENTAGE - FUEL_LEVEL_OFFSET;
+    if (resistance > FUEL_LEVEL_TO_PERCENTAGE_MILLIOHM - FUEL_LEVEL_OFFSET_MILLIOHM) resistance = FUEL_LEVEL_TO_PERCENTAGE_MILLIOHM - FUEL_LEVEL_OFFSET_MILLIOHM;
 
     // Then convert it to percent and return it
-    return (int) ((resistance / FUEL_LEVEL_TO_PERCENTAGE) * 100.0f);
+    return (int) ((int64_t) resistance * 100 / FUEL_LEVEL_TO_PERCENTAGE_MILLIOHM);
 }
 
-//! \brief Calculates the water temperature in degree Celsius from the measured R2 resistance.
+//! \brief Calculates the water temperature from the measured R2 resistance.
 //! It uses a non-linear function as the water temp sensor output is not proportional
 //! to the water temperature.
-//! \retval The water temperature in degree Celsius as float
+//! \retval The water temperature in 0.1 degree Celsius as int
 //! TODO: Implement the non-linear function!
-float calculateWaterTemperatureFromResistance() {
-    float resistance = waterTemperatureResistance_;
+int calculateWaterTemperatureFromResistance() {
+    int32_t resistance = waterTemperatureResistance_;
+
+    // Open circuit, nothing sensible to calculate
+    if (resistance == FIXED_POINT_RESISTANCE_INFINITE) return 0;
 
     // Remove the resistance offset
-    resistance -= FUEL_LEVEL_OFFSET;
+    resistance -= FUEL_LEVEL_OFFSET_MILLIOHM;
 
     // Check if its < 0
-    if (resistance < 0.0f) resistance = 0.0f;
+    if (resistance < 0) resistance = 0;
 
-    // Then convert it to percent and return it
-    return (resistance / FUEL_LEVEL_TO_PERCENTAGE * 100.0f);
+    // Then convert it and return it
+    return fixedPointScale(resistance, 1000, FUEL_LEVEL_TO_PERCENTAGE_MILLIOHM);
 }
 
 //! \brief Calculates the speed in kmh from the measured frequency.
+//! The speed signal has ODOMETER_PULSES_PER_KM pulses per km, the odometer counts the same pulses
 //! \retval The speed in kmh
-//! TODO: Implement actual conversion
-float calculateSpeedFromFrequency() {
-    return speedInHz_;
+int calculateSpeedFromFrequency() {
+    // Pulses per second * 3600 s per h / pulses per km = km per h
+    return fixedPointScale(speedInMilliHz_, 3600, 1000 * ODOMETER_PULSES_PER_KM);
 }
 
 //! \brief Calculates the rpm from the measured frequency.
 //! \retval The rpm's
 int calculateRpmFromFrequency() {
-    double multiplier = 0.0;
+    // Is there a valid frequency?
+    if (rpmInMilliHz_ <= 0) return -1;
 
-    // Get the multiplier
-    if (rpmInHz_ <= 0)
-        return -1;
-    if (rpmInHz_ <= 8)
-        multiplier = 50.0;
-    else if (rpmInHz_ <= 11)
-        multiplier = 45.45;
-    else if (rpmInHz_ <= 17)
-        multiplier = 41.18;
-    else if (rpmInHz_ <= 25)
-        multiplier = 40.0;
-    else if (rpmInHz_ <= 56)
-        multiplier = 34.48;
-    else if (rpmInHz_ <= 92)
-        multiplier = 32.61;
-    else if (rpmInHz_ <= 123)
-        multiplier = 32.52;
-    else if (rpmInHz_ <= 157)
-        multiplier = 31.85;
-    else if (rpmInHz_ <= 188)
-        multiplier = 31.91;
-    else if (rpmInHz_ <= 220)
-        multiplier = 31.82;
-    else if (rpmInHz_ <= 262)
-        multiplier = 30.54;
-
-    // Calculate the rpm and return it
-    return (int) ((double) rpmInHz_ * multiplier);
-}
-
-//! \brief ISR for the speed, triggered everytime there is a falling edge
-static void IRAM_ATTR speedInterruptHandler() {
-    lastTimeOfFallingEdgeSpeed_ = timeOfFallingEdgeSpeed_;
-    timeOfFallingEdgeSpeed_ = esp_timer_get_time();
-}
-
-//! \brief ISR for the rpm, triggered everytime there is a falling edge
-static void IRAM_ATTR rpmInterruptHandler() {
-    lastTimeOfFallingEdgeRPM_ = timeOfFallingEdgeRPM_;
-    timeOfFallingEdgeRPM_ = esp_timer_get_time();
+    // Convert it with the calibration table
+    return pwlEvaluate(&rpmConversionTable_, rpmInMilliHz_);
 }
 
-/* --- Function implementations --- */
-int sensorManagerInit(void) {
-    // Initialize the ADC2
-    const adc_oneshot_unit_init_cfg_t adc2InitConfig = {
-            .unit_id = ADC_UNIT_2,
-            .ulp_mode = ADC_ULP_MODE_DISABLE};
-    if (adc_oneshot_new_unit(&adc2InitConfig, &adc2Handle_) != ESP_OK) {
-        // Init was NOT successful!
-        initAdc2Failed_ = true;
-
-        // Logging
-        loggerWarn("Failed to initialize ADC2!");
+//! \brief Classifies the gear from an rpm and the latest speed and publishes it if it changed
+//! \param rpm The rpm
+//! \param timestampUs When the newer of both values was captured
+//! \param quality The quality of the newer value
+static void updateGear(const int32_t rpm, const int64_t timestampUs, const uint8_t quality) {
+    // Is it enabled?
+    if (!gearEstimationEnabled_) return;
+
+    // Constant time, so the lock is held only briefly
+    portENTER_CRITICAL(&gearLock_);
+    const int oldGear = gear_;
+    gear_ = gearEstimatorUpdate(&gearEstimator_, rpm, speed_);
+    const int newGear = gear_;
+    portEXIT_CRITICAL(&gearLock_);
 
-        // Initialization failed
-        return 0;
+    // Did it change?
+    if (oldGear != newGear) {
+        publishSample(SENSOR_GEAR, newGear, UNIT_GEAR, timestampUs, quality);
     }
+}
 
-    /* --- Configure the oil pressure ADC2 channel --- */
-
-    // Configure oil pressure GPIO
-    gpio_set_direction(GPIO_OIL_PRESSURE, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(GPIO_OIL_PRESSURE, GPIO_PULLDOWN_ONLY);
-
-    // Create the config
-    const adc_oneshot_chan_cfg_t adc2OilConfig = {
-            .bitwidth = ADC_BITWIDTH_12,
-            .atten = ADC_ATTEN_DB_2_5,
-    };
-    initAdc2OilChannelFailed_ = adc_oneshot_config_channel(adc2Handle_, ADC_CHANNEL_OIL_PRESSURE, &adc2OilConfig) != ESP_OK;
+//! \brief Returns a boolean indicating if the gear follows the rpm edges in sensorManagerUpdateShiftLight().
+//! Otherwise the speed and rpm updates classify it
+static bool isGearOnEdges(void) {
+    return !(canChannels_ & CAN_CHANNEL_BIT(CAN_CHANNEL_RPM)) && !initHalFailed_ && !initRpmIsrFailed_;
+}
 
-    // Logging
-    if (initAdc2OilChannelFailed_) {
-        loggerError("Failed to initialize ADC2 channel: %d", ADC_CHANNEL_OIL_PRESSURE);
+//! \brief Calculates the frequency of a pulse signal from its last two falling edges. The time since
+//! the last edge is an upper bound for the frequency, so the value decays as soon as an edge is overdue
+//! and drops to 0 once a whole expected period passed without one.
+//! \param edges The falling edges of the signal
+//! \param edgeCountAtStop The edge count when the signal was detected as stopped. Updated on a stop
+//! \param timestampUs Set to the time the returned value is valid for
+//! \param quality SAMPLE_QUALITY_ESTIMATED is added if the value is only the upper bound
+//! \retval The frequency in mHz, 0 if the signal stopped
+static int32_t measurePulseFrequency(const EdgeRecord *edges, uint32_t *edgeCountAtStop, int64_t *timestampUs, uint8_t *quality) {
+    // Copy the edges first, the ISR may write them at any time
+    EdgeSnapshot snapshot;
+    edgeSnapshotRead(edges, &snapshot);
+    const int64_t lastEdgeUs = snapshot.lastEdgeUs;
+
+    const int64_t now = sensorHalGetTimeUs();
+    *timestampUs = now;
+
+    // A period needs two edges after the signal (re)started
+    if (snapshot.edgeCount - *edgeCountAtStop < 2) return 0;
+
+    const int64_t period = lastEdgeUs - snapshot.previousEdgeUs;
+    const int64_t timeSinceLastEdge = now - lastEdgeUs;
+
+    // The next edge didn't even come one expected period late -> stopped
+    if (period <= 0 || timeSinceLastEdge >= 2 * period) {
+        *edgeCountAtStop = snapshot.edgeCount;
+        return 0;
     }
 
-    // Create the calibration curve config
-    const adc_cali_curve_fitting_config_t oilCaliConfig = {
-            .unit_id = ADC_UNIT_2,
-            .chan = ADC_CHANNEL_OIL_PRESSURE,
-            .atten = ADC_ATTEN_DB_2_5,
-            .bitwidth = ADC_BITWIDTH_12,
-    };
-
-    // Create calibration curve fitting
-    if (adc_cali_create_scheme_curve_fitting(&oilCaliConfig, &adc2OilCaliHandle_) != ESP_OK) {
-        // Mark the oil channel as failed
-        initAdc2OilChannelFailed_ = true;
-
-        // Logging
-        loggerError("'adc_cali_create_scheme_curve_fitting' for the oil pressure channel FAILED");
+    // The next edge is overdue, so the frequency is at most 1 / time since the last edge
+    if (timeSinceLastEdge > period) {
+        *quality |= SAMPLE_QUALITY_ESTIMATED;
+        return fixedPointFrequencyFromPeriod(timeSinceLastEdge);
     }
 
-    /* --- Configure the oil pressure ADC2 channel --- */
-
-    /* --- Configure the fuel level ADC2 channel --- */
-
-    // Configure oil pressure GPIO
-    gpio_set_direction(GPIO_FUEL_LEVEL, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(GPIO_FUEL_LEVEL, GPIO_PULLDOWN_ONLY);
-
-    // Create the config
-    const adc_oneshot_chan_cfg_t adc2FuelConfig = {
-            .bitwidth = ADC_BITWIDTH_12,
-            .atten = ADC_ATTEN_DB_2_5,
-    };
-    initAdc2FuelChannelFailed_ = adc_oneshot_config_channel(adc2Handle_, ADC_CHANNEL_FUEL_LEVEL, &adc2FuelConfig) != ESP_OK;
+    // Regular measurement, it belongs to the last edge
+    *timestampUs = lastEdgeUs;
+    return fixedPointFrequencyFromPeriod(period);
+}
 
-    // Logging
-    if (initAdc2FuelChannelFailed_) {
-        loggerError("Failed to initialize ADC2 channel: %d", ADC_CHANNEL_FUEL_LEVEL);
-    }
+//! \brief Edge handler for the speed, called everytime there is a falling edge. Runs in the ISR on the hardware
+static void IRAM_ATTR speedEdgeHandler(const SENSOR_HAL_PULSE input, const int64_t timeUs) {
+    edgeSnapshotRecord(&speedEdges_, timeUs);
+}
 
-    // Create the calibration curve config
-    const adc_cali_curve_fitting_config_t fuelCaliConfig = {
-            .unit_id = ADC_UNIT_2,
-            .chan = ADC_CHANNEL_FUEL_LEVEL,
-            .atten = ADC_ATTEN_DB_2_5,
-            .bitwidth = ADC_BITWIDTH_12,
-    };
+//! \brief Edge handler for the rpm, called everytime there is a falling edge. Runs in the ISR on the hardware
+static void IRAM_ATTR rpmEdgeHandler(const SENSOR_HAL_PULSE input, const int64_t timeUs) {
+    edgeSnapshotRecord(&rpmEdges_, timeUs);
+}
 
-    // Create calibration curve fitting
-    if (adc_cali_create_scheme_curve_fitting(&fuelCaliConfig, &adc2FuelCaliHandle_) != ESP_OK) {
-        // Mark the fuel channel as failed
-        initAdc2FuelChannelFailed_ = true;
+//! \brief Stores the odometer if it is persistent and something changed since the last store. Must be called
+//! with the odometer lock taken
+static void storeOdometer(void) {
+#if !CONFIG_IDF_TARGET_LINUX
+    if (!odometerPersistent_ || !odometerHasUnstoredChanges(&odometer_)) return;
 
+    if (!odometerStore(&odometer_)) {
         // Logging
-        loggerError("'adc_cali_create_scheme_curve_fitting' for the fuel level channel FAILED");
+        loggerWarn("Couldn't store the odometer");
     }
+#endif
+}
 
-    /* --- Configure the fuel level ADC2 channel --- */
-
-    /* --- Configure the water temperature ADC2 channel --- */
-
-    // Configure oil pressure GPIO
-    gpio_set_direction(GPIO_WATER_TEMPERATURE, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(GPIO_WATER_TEMPERATURE, GPIO_PULLDOWN_ONLY);
-
-    // Create the config
-    const adc_oneshot_chan_cfg_t adc2WaterConfig = {
-            .bitwidth = ADC_BITWIDTH_12,
-            .atten = ADC_ATTEN_DB_12,
-    };
-    initAdc2WaterChannelFailed_ = adc_oneshot_config_channel(adc2Handle_, ADC_CHANNEL_WATER_TEMPERATURE, &adc2WaterConfig) != ESP_OK;
+#if !CONFIG_IDF_TARGET_LINUX
+//! \brief Stores the odometer on a software restart, called by esp_restart() on the task restarting. A power
+//! loss doesn't call it
+static void storeOdometerOnShutdown(void) {
+    // The speed task may be updating or storing it on the other core right now
+    if (xSemaphoreTake(odometerLock_, pdMS_TO_TICKS(SENSOR_MANAGER_ODOMETER_SHUTDOWN_WAIT_MS)) != pdTRUE) {
+        // Logging
+        loggerWarn("The odometer is busy, it isn't stored on the restart");
 
-    // Logging
-    if (initAdc2WaterChannelFailed_) {
-        loggerError("Failed to initialize ADC2 channel: %d", ADC_CHANNEL_WATER_TEMPERATURE);
+        return;
     }
+    storeOdometer();
+    xSemaphoreGive(odometerLock_);
+}
+#endif
+
+//! \brief Adds the new speed edges to the odometer, publishes the distances and stores them if needed
+//! \param stopped Boolean indicating if the vehicle just stopped
+//! \param timestampUs When the speed was captured [sensorHalGetTimeUs() time in us]
+static void updateOdometer(const bool stopped, const int64_t timestampUs) {
+    EdgeSnapshot snapshot;
+    edgeSnapshotRead(&speedEdges_, &snapshot);
+
+    // A restart may store it meanwhile
+    xSemaphoreTake(odometerLock_, portMAX_DELAY);
+
+    // Apply the requests of the other tasks
+    const bool tripReset = tripResetRequested_;
+    if (tripReset) {
+        tripResetRequested_ = false;
+        odometerResetTrip(&odometer_);
+    }
+    odometerSetStoreInterval(&odometer_, odometerStoreIntervalMeters_);
+
+    // Integrate the new edges
+    const bool storeDue = odometerUpdate(&odometer_, snapshot.edgeCount);
+    const int32_t oldTotal = odometerMeters_;
+    const int32_t oldTrip = tripMeters_;
+    odometerMeters_ = odometerGetTotalMeters(&odometer_);
+    tripMeters_ = odometerGetTripMeters(&odometer_);
+
+    // Store after the interval and once the vehicle stopped, as it is usually switched off then. Not on
+    // every stop though, a short distance isn't worth a flash write
+    if (storeDue || (stopped && odometerIsStopStoreDue(&odometer_))) storeOdometer();
+    xSemaphoreGive(odometerLock_);
+
+    // Publish the distances in steps, they change on nearly every update. A reset trip is published right away
+    if (odometerMeters_ / ODOMETER_PUBLISH_STEP_M != oldTotal / ODOMETER_PUBLISH_STEP_M) {
+        publishSample(SENSOR_ODOMETER, odometerMeters_, UNIT_METER, timestampUs, SAMPLE_QUALITY_OK);
+    }
+    if (tripReset || tripMeters_ / ODOMETER_PUBLISH_STEP_M != oldTrip / ODOMETER_PUBLISH_STEP_M) {
+        publishSample(SENSOR_TRIP, tripMeters_, UNIT_METER, timestampUs, SAMPLE_QUALITY_OK);
+    }
+}
 
-    // Create the calibration curve config
-    const adc_cali_curve_fitting_config_t waterCaliConfig = {
-            .unit_id = ADC_UNIT_2,
-            .chan = ADC_CHANNEL_WATER_TEMPERATURE,
-            .atten = ADC_ATTEN_DB_12,
-            .bitwidth = ADC_BITWIDTH_12,
-    };
-
-    // Create calibration curve fitting
-    if (adc_cali_create_scheme_curve_fitting(&waterCaliConfig, &adc2WaterCaliHandle_) != ESP_OK) {
-        // Mark the water channel as failed
-        initAdc2WaterChannelFailed_ = true;
+/* --- Function implementations --- */
+int sensorManagerInit(void) {
+    // Initialize the sensor backend (e.g. the ADC units)
+    if (!sensorHalInit()) {
+        // Init was NOT successful!
+        initHalFailed_ = true;
 
         // Logging
-        loggerError("'adc_cali_create_scheme_curve_fitting' for the water temperature channel FAILED");
-    }
-
-    /* --- Configure the water temperature ADC2 channel --- */
+        loggerWarn("Failed to initialize the sensor backend!");
 
-    /* --- Configure the speed interrupt --- */
+        // Initialization failed
+        return 0;
+    }
 
-    // Setup gpio
-    gpio_set_direction(GPIO_SPEED, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(GPIO_SPEED, GPIO_PULLDOWN_ONLY);
-    gpio_set_intr_type(GPIO_SPEED, GPIO_INTR_NEGEDGE);
+    // Nothing measured yet
+    shiftLightInit(&shiftLight_);
 
-    // Install ISR service
-    if (gpio_install_isr_service(ESP_INTR_FLAG_IRAM) != ESP_OK) {
-        // Failed, so we cant install our speed/rpm ISR's
-        initSpeedIsrFailed_ = true;
-        initRpmIsrFailed_ = true;
+    // Configure the analog inputs
+    initOilChannelFailed_ = !sensorHalInitAdc(SENSOR_HAL_ADC_OIL_PRESSURE);
+    initFuelChannelFailed_ = !sensorHalInitAdc(SENSOR_HAL_ADC_FUEL_LEVEL);
+    initWaterChannelFailed_ = !sensorHalInitAdc(SENSOR_HAL_ADC_WATER_TEMPERATURE);
+    initIntTempChannelFailed_ = !sensorHalInitAdc(SENSOR_HAL_ADC_INT_TEMPERATURE);
 
-        // Logging
-        loggerError("Couldn't install the ISR service. Speed and RPM are unavailable!");
-    }
+    /* --- Configure the speed interrupt --- */
 
     // Activate the ISR for measuring the frequency for the speed
-    if (!initSpeedIsrFailed_ && sensorManagerEnableSpeedISR()) {
+    if (sensorHalInitPulse(SENSOR_HAL_PULSE_SPEED) && sensorManagerEnableSpeedISR()) {
         // Everything worked
         speedIsrActive_ = true;
         initSpeedIsrFailed_ = false;
@@ -329,15 +450,37 @@ int sensorManagerInit(void) {
 
     /* --- Configure the speed interrupt --- */
 
-    /* --- Configure the rpm interrupt --- */
+    /* --- Restore the odometer --- */
+
+    // Only the board stores it, the other backends start at 0 everytime
+    if (odometerLock_ == NULL) odometerLock_ = xSemaphoreCreateMutexStatic(&odometerLockBuffer_);
+    EdgeSnapshot speedSnapshot;
+    edgeSnapshotRead(&speedEdges_, &speedSnapshot);
+    odometerInit(&odometer_, speedSnapshot.edgeCount, odometerStoreIntervalMeters_);
+#if !CONFIG_IDF_TARGET_LINUX
+    if (sensorHalGetBackend() == &sensorHalHardware) {
+        odometerPersistent_ = true;
+        if (!odometerRestore(&odometer_)) {
+            // Logging
+            loggerWarn("No stored odometer found, it starts at 0");
+        }
+        odometerMeters_ = odometerGetTotalMeters(&odometer_);
+        tripMeters_ = odometerGetTripMeters(&odometer_);
 
-    // Setup gpio
-    gpio_set_direction(GPIO_RPM, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(GPIO_RPM, GPIO_PULLDOWN_ONLY);
-    gpio_set_intr_type(GPIO_RPM, GPIO_INTR_NEGEDGE);
+        // Store it on a software restart as well, e.g. after an update
+        if (esp_register_shutdown_handler(storeOdometerOnShutdown) != ESP_OK) {
+            // Logging
+            loggerWarn("Couldn't register the odometer shutdown handler");
+        }
+    }
+#endif
+
+    /* --- Restore the odometer --- */
+
+    /* --- Configure the rpm interrupt --- */
 
     // Activate the ISR for measuring the frequency for the rpm
-    if (!initRpmIsrFailed_ && sensorManagerEnableRpmISR()) {
+    if (sensorHalInitPulse(SENSOR_HAL_PULSE_RPM) && sensorManagerEnableRpmISR()) {
         // Everything worked
         rpmIsrActive_ = true;
         initRpmIsrFailed_ = false;
@@ -352,113 +495,128 @@ int sensorManagerInit(void) {
 
     /* --- Configure the rpm interrupt --- */
 
-    /* --- Configure the internal temperature sensor --- */
-
-    // Setup gpio
-    gpio_set_direction(GPIO_NUM_7, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(GPIO_NUM_7, GPIO_PULLDOWN_ONLY);
+    /* --- Configure the digital inputs --- */
 
-    // Initialize the ADC2
-    const adc_oneshot_unit_init_cfg_t adc1InitConfig = {
-            .unit_id = ADC_UNIT_1,
-            .ulp_mode = ADC_ULP_MODE_DISABLE};
-    if (adc_oneshot_new_unit(&adc1InitConfig, &adc1Handle_) != ESP_OK) {
-        // Init was NOT successful!
-        initAdc1Failed_ = true;
+    // Only the board has them, the other backends don't simulate them
+    blinkDetectorInit(&blinkDetector_);
+#if !CONFIG_IDF_TARGET_LINUX
+    if (sensorHalGetBackend() == &sensorHalHardware && !digitalInputsInit()) {
+        // It failed
+        initDigitalInputsFailed_ = true;
 
         // Logging
-        loggerWarn("Failed to initialize ADC1!");
+        loggerError("Failed to initialize the digital inputs!");
     }
+#endif
 
-    // Create the channel config
-    const adc_oneshot_chan_cfg_t adc2IntTempConfig = {
-            .bitwidth = ADC_BITWIDTH_12,
-            .atten = ADC_ATTEN_DB_6,
-    };
-    initAdc1IntTempChannelFailed_ = adc_oneshot_config_channel(adc1Handle_, ADC_CHANNEL_INT_TEMPERATURE, &adc2IntTempConfig) != ESP_OK;
+    /* --- Configure the digital inputs --- */
 
-    // Logging
-    if (initAdc1IntTempChannelFailed_) {
-        loggerError("Failed to initialize ADC2 channel: %d", ADC_CHANNEL_INT_TEMPERATURE);
-    }
-
-    // Create the calibration curve config
-    const adc_cali_curve_fitting_config_t intTempCaliConfig = {
-            .unit_id = ADC_UNIT_1,
-            .chan = ADC_CHANNEL_INT_TEMPERATURE,
-            .atten = ADC_ATTEN_DB_6,
-            .bitwidth = ADC_BITWIDTH_12,
-    };
+    /* --- Configure the CAN bus --- */
 
-    // Create calibration curve fitting
-    if (adc_cali_create_scheme_curve_fitting(&intTempCaliConfig, &adc2IntTempCaliHandle_) != ESP_OK) {
-        // Mark the oil channel as failed
-        initAdc1IntTempChannelFailed_ = true;
+    // Only if a channel comes from it, the controller only receives the frames of the signals
+    if (canChannels_ != 0) {
+        CanFilter filter;
+        initCanFailed_ = !canDecoderInit(&canDecoder_, canSignals_, sizeof(canSignals_) / sizeof(canSignals_[0]));
+        if (!initCanFailed_) {
+            canDecoderGetFilter(&canDecoder_, &filter);
+            initCanFailed_ = !canBusInit(&filter);
+        }
 
         // Logging
-        loggerError("'adc_cali_create_scheme_curve_fitting' for the internal temperature sensor channel FAILED");
+        if (initCanFailed_) loggerError("Failed to initialize the CAN bus!");
     }
 
-    /* --- Configure the internal temperature sensor --- */
+    /* --- Configure the CAN bus --- */
 
     // Return result
-    if (initAdc2Failed_ || initAdc2OilChannelFailed_ || initAdc2FuelChannelFailed_ || initAdc2WaterChannelFailed_ || initSpeedIsrFailed_ || initRpmIsrFailed_ || initAdc1IntTempChannelFailed_)
+    if (initOilChannelFailed_ || initFuelChannelFailed_ || initWaterChannelFailed_ || initSpeedIsrFailed_ || initRpmIsrFailed_ || initIntTempChannelFailed_ ||
+        initDigitalInputsFailed_ || initCanFailed_)
         return 2;// Initialization succeeded with errors
     return 1;    // Initialization succeeded
 }
 
-void sensorManagerRegisterCallback(const SENSOR sensorType, void callback(void *)) {
-    switch (sensorType) {
-        case (SENSOR_OIL_PRESSURE):
-            // Save the cb function
-            oilPressureCallback_ = callback;
-            break;
-        case (SENSOR_FUEL_LEVEL_PERCENT):
-            // Save the cb function
-            fuelLevelPercentCallback_ = callback;
-            break;
-        case (SENSOR_FUEL_LEVEL_LITRE):
-            // Save the cb function
-            fuelLevelLitreCallback_ = callback;
-            break;
-        case (SENSOR_WATER_TEMPERATURE):
-            // Save the cb function
-            waterTemperatureCallback_ = callback;
-            break;
-        case (SENSOR_INTERNAL_TEMPERATURE):
-            // Save the cb function
-            internalTemperatureCallback_ = callback;
-            break;
-        case (SENSOR_SPEED):
-            // Save the cb function
-            speedCallback_ = callback;
-            break;
-        case (SENSOR_RPM):
-            // Save the cb function
-            rpmCallback_ = callback;
-            break;
+void sensorManagerSetCanChannels(const uint32_t channels) {
+    canChannels_ = channels & (CAN_CHANNEL_BIT(CAN_CHANNEL_COUNT) - 1);
+}
+
+bool sensorManagerUsesCan(void) {
+    return canChannels_ != 0 && !initCanFailed_;
+}
+
+void sensorManagerUpdateCan(void) {
+    // Was the init successfully?
+    if (!sensorManagerUsesCan()) return;
+
+    // Wait for the next frame, its data is decoded where the backend received it
+    CanFrame frame;
+    if (canBusReceive(&frame, pdMS_TO_TICKS(CAN_RECEIVE_TIMEOUT_MS))) canDecoderDecode(&canDecoder_, &frame);
+}
+
+bool sensorManagerSubscribe(const SENSOR sensorType, const SensorSubscriber subscriber) {
+    // Is the sensor valid?
+    if (sensorType >= SENSOR_COUNT || subscriber == NULL) return false;
+
+    // Search a free slot
+    for (int i = 0; i < SENSOR_MAX_SUBSCRIBERS; i++) {
+        if (subscribers_[sensorType][i] == NULL) {
+            subscribers_[sensorType][i] = subscriber;
+            return true;
+        }
     }
+
+    // Logging
+    loggerError("No free subscriber slot for sensor: %d", sensorType);
+
+    return false;
+}
+
+bool sensorManagerUnsubscribe(const SENSOR sensorType, const SensorSubscriber subscriber) {
+    // Is the sensor valid?
+    if (sensorType >= SENSOR_COUNT) return false;
+
+    // Search the subscriber
+    for (int i = 0; i < SENSOR_MAX_SUBSCRIBERS; i++) {
+        if (subscribers_[sensorType][i] == subscriber) {
+            subscribers_[sensorType][i] = NULL;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const char *sensorManagerGetSensorName(const SENSOR sensorType) {
+    // Is the sensor valid?
+    if (sensorType >= SENSOR_COUNT) return "Unknown";
+
+    return sensorNames_[sensorType];
 }
 
 void sensorManagerUpdateOilPressure(void) {
+    // Does it come from the CAN bus?
+    if (canChannels_ & CAN_CHANNEL_BIT(CAN_CHANNEL_OIL_PRESSURE)) {
+        int oilPressure = oilPressure_;
+        int64_t timestampUs = 0;
+        uint8_t quality = SAMPLE_QUALITY_OK;
+        updateFromCan(CAN_CHANNEL_OIL_PRESSURE, SENSOR_OIL_PRESSURE, UNIT_BOOLEAN, &oilPressure, &timestampUs, &quality);
+        oilPressure_ = oilPressure != 0;
+        return;
+    }
+
     // Was the init successfully?
-    if (initAdc2Failed_ || initAdc2OilChannelFailed_) return;
+    if (initHalFailed_ || initOilChannelFailed_) return;
 
     // Temporary containers
-    int rawAdcValue = 0;
     int voltage = 0;
+    uint8_t quality = SAMPLE_QUALITY_OK;
 
-    // Try to read from the ADC
-    if (adc_oneshot_read(adc2Handle_, ADC_CHANNEL_OIL_PRESSURE, &rawAdcValue) != ESP_OK) {
+    // Try to read the voltage from the ADC
+    if (!sensorHalReadMilliVolts(SENSOR_HAL_ADC_OIL_PRESSURE, &voltage)) {
         // Log that it failed
+        quality |= SAMPLE_QUALITY_READ_FAILED;
         loggerWarn("Failed to read the oil pressure from the ADC!");
     }
-
-    // Try to convert the ADC value to a voltage
-    if (adc_cali_raw_to_voltage(adc2OilCaliHandle_, rawAdcValue, &voltage) != ESP_OK) {
-        // Log that it failed
-        loggerWarn("Failed to calculate the voltage from the ADC value!");
-    }
+    const int64_t timestampUs = sensorHalGetTimeUs();
 
     // Check the thresholds
     const bool oldOilPressureValue = oilPressure_;
@@ -466,13 +624,7 @@ void sensorManagerUpdateOilPressure(void) {
 
     // Did it change?
     if (oldOilPressureValue != oilPressure_) {
-        // Callback
-        if (oilPressureCallback_ != NULL) {
-            oilPressureCallback_((void *) &oilPressure_);
-        }
-
-        // Logging
-        loggerInfo("Oil pressure changed! From: '%d' to '%d'", oldOilPressureValue, oilPressure_);
+        publishSample(SENSOR_OIL_PRESSURE, oilPressure_, UNIT_BOOLEAN, timestampUs, quality);
     }
 }
 
@@ -481,27 +633,31 @@ bool sensorManagerHasOilPressure(void) {
 }
 
 void sensorManagerUpdateFuelLevel(void) {
+    // Does it come from the CAN bus?
+    if (canChannels_ & CAN_CHANNEL_BIT(CAN_CHANNEL_FUEL_LEVEL)) {
+        int64_t timestampUs = 0;
+        uint8_t quality = SAMPLE_QUALITY_OK;
+        updateFromCan(CAN_CHANNEL_FUEL_LEVEL, SENSOR_FUEL_LEVEL_PERCENT, UNIT_PERCENT, &fuelLevelInPercent_, &timestampUs, &quality);
+        return;
+    }
+
     // Was the init successfully?
-    if (initAdc2Failed_ || initAdc2FuelChannelFailed_) return;
+    if (initHalFailed_ || initFuelChannelFailed_) return;
 
     // Temporary containers
-    int rawAdcValue = 0;
     int voltage = 0;
+    uint8_t quality = SAMPLE_QUALITY_OK;
 
-    // Try to read from the ADC
-    if (adc_oneshot_read(adc2Handle_, ADC_CHANNEL_FUEL_LEVEL, &rawAdcValue) != ESP_OK) {
+    // Try to read the voltage from the ADC
+    if (!sensorHalReadMilliVolts(SENSOR_HAL_ADC_FUEL_LEVEL, &voltage)) {
         // Log that it failed
+        quality |= SAMPLE_QUALITY_READ_FAILED;
         loggerWarn("Failed to read the fuel level from the ADC!");
     }
-
-    // Try to convert the ADC value to a voltage
-    if (adc_cali_raw_to_voltage(adc2FuelCaliHandle_, rawAdcValue, &voltage) != ESP_OK) {
-        // Log that it failed
-        loggerWarn("Failed to calculate the voltage from the ADC value!");
-    }
+    const int64_t timestampUs = sensorHalGetTimeUs();
 
     // Calculate resistance
-    fuelLevelResistance_ = calculateVoltageDividerR2(OIL_FUEL_WATER_VOLTAGE_V, voltage, OIL_FUEL_R1);
+    fuelLevelResistance_ = fixedPointVoltageDividerR2(OIL_FUEL_WATER_VOLTAGE_MV, voltage, OIL_FUEL_R1);
 
     // Calculate the fuel level from the calculated resistance
     const int oldFuelLevelValue = fuelLevelInPercent_;
@@ -509,18 +665,8 @@ void sensorManagerUpdateFuelLevel(void) {
 
     // Did it change?
     if (oldFuelLevelValue != fuelLevelInPercent_) {
-        // Callback 1
-        if (fuelLevelPercentCallback_ != NULL) {
-            fuelLevelPercentCallback_((void *) fuelLevelInPercent_);
-        }
-
-        // Callback 2
-        if (fuelLevelLitreCallback_ != NULL) {
-            fuelLevelLitreCallback_((void *) fuelLevelInLitre_);// TODO: Calculate Litres
-        }
-
-        // Logging
-        loggerInfo("Fuel level changed! From: '%d percent' to '%d percent'", oldFuelLevelValue, fuelLevelInPercent_);
+        publishSample(SENSOR_FUEL_LEVEL_PERCENT, fuelLevelInPercent_, UNIT_PERCENT, timestampUs, quality);
+        publishSample(SENSOR_FUEL_LEVEL_LITRE, fuelLevelInLitre_, UNIT_LITRE, timestampUs, quality);// TODO: Calculate Litres
     }
 }
 
@@ -529,45 +675,43 @@ int sensorManagerGetFuelLevel(void) {
 }
 
 void sensorManagerUpdateWaterTemperature(void) {
+    // Does it come from the CAN bus?
+    if (canChannels_ & CAN_CHANNEL_BIT(CAN_CHANNEL_WATER_TEMPERATURE)) {
+        int64_t timestampUs = 0;
+        uint8_t quality = SAMPLE_QUALITY_OK;
+        updateFromCan(CAN_CHANNEL_WATER_TEMPERATURE, SENSOR_WATER_TEMPERATURE, UNIT_DECI_CELSIUS, &waterTemperature_, &timestampUs, &quality);
+        return;
+    }
+
     // Was the init successfully?
-    if (initAdc2Failed_ || initAdc2WaterChannelFailed_) return;
+    if (initHalFailed_ || initWaterChannelFailed_) return;
 
     // Temporary containers
-    int rawAdcValue = 0;
     int voltage = 0;
+    uint8_t quality = SAMPLE_QUALITY_OK;
 
-    // Try to read from the ADC
-    if (adc_oneshot_read(adc2Handle_, ADC_CHANNEL_WATER_TEMPERATURE, &rawAdcValue) != ESP_OK) {
+    // Try to read the voltage from the ADC
+    if (!sensorHalReadMilliVolts(SENSOR_HAL_ADC_WATER_TEMPERATURE, &voltage)) {
         // Log that it failed
+        quality |= SAMPLE_QUALITY_READ_FAILED;
         loggerWarn("Failed to read the water temperature from the ADC!");
     }
-
-    // Try to convert the ADC value to a voltage
-    if (adc_cali_raw_to_voltage(adc2WaterCaliHandle_, rawAdcValue, &voltage) != ESP_OK) {
-        // Log that it failed
-        loggerWarn("Failed to calculate the voltage from the ADC value!");
-    }
+    const int64_t timestampUs = sensorHalGetTimeUs();
 
     // Calculate resistance
-    waterTemperatureResistance_ = calculateVoltageDividerR2(OIL_FUEL_WATER_VOLTAGE_V, voltage, WATER_R1);
+    waterTemperatureResistance_ = fixedPointVoltageDividerR2(OIL_FUEL_WATER_VOLTAGE_MV, voltage, WATER_R1);
 
     // Calculate the water temperature from the calculated resistance
-    const float oldWaterTemperatureValue = waterTemperature_;
+    const int oldWaterTemperatureValue = waterTemperature_;
     waterTemperature_ = calculateWaterTemperatureFromResistance();
 
     // Did it change?
     if (oldWaterTemperatureValue != waterTemperature_) {
-        // Callback
-        if (waterTemperatureCallback_ != NULL) {
-            waterTemperatureCallback_((void *) &waterTemperature_);
-        }
-
-        // Logging
-        loggerInfo("Water temperature changed! From: '%d °C' to '%d °C'", oldWaterTemperatureValue, waterTemperature_);
+        publishSample(SENSOR_WATER_TEMPERATURE, waterTemperature_, UNIT_DECI_CELSIUS, timestampUs, quality);
     }
 }
 
-float sensorManagerGetWaterTemperature(void) {
+int sensorManagerGetWaterTemperature(void) {
     return waterTemperature_;
 }
 
@@ -575,77 +719,109 @@ bool sensorManagerEnableSpeedISR() {
     // Was the init successfully?
     if (initSpeedIsrFailed_) return false;
 
-    return (gpio_isr_handler_add(GPIO_SPEED, speedInterruptHandler, NULL) == ESP_OK);
+    return sensorHalEnableEdges(SENSOR_HAL_PULSE_SPEED, speedEdgeHandler);
 }
 
 void sensorManagerDisableSpeedISR() {
     // Was the init successfully?
     if (initSpeedIsrFailed_) return;
 
-    gpio_isr_handler_remove(GPIO_SPEED);
+    sensorHalDisableEdges(SENSOR_HAL_PULSE_SPEED);
 }
 
 void sensorManagerUpdateSpeed(void) {
-    // Calculate how much time between the two falling edges was
-    const int64_t time = timeOfFallingEdgeSpeed_ - lastTimeOfFallingEdgeSpeed_;
-
-    // Convert the time to seconds
-    const float fT = (float) time / 1000.0f;
+    // Does it come from the CAN bus? The odometer only counts the wired edges
+    if (canChannels_ & CAN_CHANNEL_BIT(CAN_CHANNEL_SPEED)) {
+        int64_t timestampUs = 0;
+        uint8_t quality = SAMPLE_QUALITY_OK;
+        updateFromCan(CAN_CHANNEL_SPEED, SENSOR_SPEED, UNIT_KMH, &speed_, &timestampUs, &quality);
+        if (!isGearOnEdges()) updateGear(rpm_, timestampUs, quality);
+        return;
+    }
 
-    // Then save the speed frequency (rounded)
-    speedInHz_ = (int) round(1000.0 / fT);
-
-    // Is the speed value valid?
-    if (speedInHz_ >= 500) speedInHz_ = 0;
+    // Measure the frequency from the falling edges
+    uint8_t quality = SAMPLE_QUALITY_OK;
+    int64_t timestampUs = 0;
+    speedInMilliHz_ = measurePulseFrequency(&speedEdges_, &speedEdgeCountAtStop_, &timestampUs, &quality);
 
     // Convert the frequency to actual speed
     const int oldSpeed = speed_;
-    speed_ = (int) calculateSpeedFromFrequency();
+    speed_ = calculateSpeedFromFrequency();
+
+    // Is the speed value valid?
+    if (speed_ > SPEED_MAX_KMH) {
+        speed_ = 0;
+        quality |= SAMPLE_QUALITY_OUT_OF_RANGE;
+    }
 
     // Is it >1
     if (speed_ < 0) speed_ = 0;
 
     if (oldSpeed != speed_ || 1) {
-        // Callback
-        if (speedCallback_ != NULL) {
-            speedCallback_((void *) speed_);// Problem hier
-        }
-
-        // Logging
-        loggerInfo("Speed changed! From: '%d kmh' to '%d kmh'", oldSpeed, speed_);
+        publishSample(SENSOR_SPEED, speed_, UNIT_KMH, timestampUs, quality);
     }
+
+    // Classify the gear with the new speed, unless the next rpm edge does
+    if (!isGearOnEdges()) updateGear(rpm_, timestampUs, quality);
+
+    // Integrate the distance
+    updateOdometer(oldSpeed > 0 && speed_ == 0, timestampUs);
 }
 
 int sensorManagerGetSpeed(void) {
     return speed_;
 }
 
+int32_t sensorManagerGetOdometer(void) {
+    return odometerMeters_;
+}
+
+int32_t sensorManagerGetTrip(void) {
+    return tripMeters_;
+}
+
+void sensorManagerResetTrip(void) {
+    tripResetRequested_ = true;
+}
+
+void sensorManagerSetOdometerStoreInterval(const int32_t storeIntervalMeters) {
+    odometerStoreIntervalMeters_ = storeIntervalMeters;
+}
+
 bool sensorManagerEnableRpmISR() {
     // Was the init successfully?
     if (initRpmIsrFailed_) return false;
 
-    return gpio_isr_handler_add(GPIO_RPM, rpmInterruptHandler, NULL) == ESP_OK;
+    return sensorHalEnableEdges(SENSOR_HAL_PULSE_RPM, rpmEdgeHandler);
 }
 
 void sensorManagerDisableRpmISR() {
     // Was the init successfully?
     if (initRpmIsrFailed_) return;
 
-    gpio_isr_handler_remove(GPIO_RPM);
+    sensorHalDisableEdges(SENSOR_HAL_PULSE_RPM);
 }
 
 void sensorManagerUpdateRPM(void) {
-    // Calculate how much time between the two falling edges was
-    const int64_t time = timeOfFallingEdgeRPM_ - lastTimeOfFallingEdgeRPM_;
-
-    // Convert the time to seconds
-    const float fT = (float) time / 1000.0f;
+    // Does it come from the CAN bus?
+    if (canChannels_ & CAN_CHANNEL_BIT(CAN_CHANNEL_RPM)) {
+        int64_t timestampUs = 0;
+        uint8_t quality = SAMPLE_QUALITY_OK;
+        updateFromCan(CAN_CHANNEL_RPM, SENSOR_RPM, UNIT_RPM, &rpm_, &timestampUs, &quality);
+        updateGear(rpm_, timestampUs, quality);
+        return;
+    }
 
-    // Then save the rpm frequency (rounded)
-    rpmInHz_ = (int) round(1000.0 / fT);
+    // Measure the frequency from the falling edges
+    uint8_t quality = SAMPLE_QUALITY_OK;
+    int64_t timestampUs = 0;
+    rpmInMilliHz_ = measurePulseFrequency(&rpmEdges_, &rpmEdgeCountAtStop_, &timestampUs, &quality);
 
     // Is the rpm value valid?
-    if (rpmInHz_ >= 300) rpmInHz_ = -1;
+    if (rpmInMilliHz_ >= RPM_MAX_FREQUENCY_MILLIHZ) {
+        rpmInMilliHz_ = -1;
+        quality |= SAMPLE_QUALITY_OUT_OF_RANGE;
+    }
 
     // Convert the frequency to actual rpm
     const int oldRpm = rpm_;
@@ -655,14 +831,11 @@ void sensorManagerUpdateRPM(void) {
     if (rpm_ < 0) rpm_ = 0;
 
     if (oldRpm != rpm_) {
-        // Callback
-        if (rpmCallback_ != NULL) {
-            rpmCallback_((void *) rpm_);
-        }
-
-        // Logging
-        loggerInfo("RPM changed! From: '%d RPM' to '%d RPM'", oldRpm, rpm_);
+        publishSample(SENSOR_RPM, rpm_, UNIT_RPM, timestampUs, quality);
     }
+
+    // The edges classify the gear, only a stopped engine has none left to do it
+    if (rpm_ == 0) updateGear(rpm_, timestampUs, quality);
 }
 
 int sensorManagerGetRPM(void) {
@@ -671,21 +844,254 @@ int sensorManagerGetRPM(void) {
 
 void sensorManagerUpdateInternalTemperature(void) {
     // Was the init successfully?
-    if (initAdc2Failed_ || initAdc1IntTempChannelFailed_) return;
+    if (initHalFailed_ || initIntTempChannelFailed_) return;
 
-    // Try to get a reading from the ADC
-    if (adc_oneshot_read(adc1Handle_, ADC_CHANNEL_INT_TEMPERATURE, &intTempRawAdcValue_) != ESP_OK) {
+    // Try to get a reading (mV) from the ADC
+    uint8_t quality = SAMPLE_QUALITY_OK;
+    if (!sensorHalReadMilliVolts(SENSOR_HAL_ADC_INT_TEMPERATURE, &intTempVoltageMV_)) {
         // Logging
+        quality |= SAMPLE_QUALITY_READ_FAILED;
         loggerError("Failed to read the internal temperature from the ADC!");
     }
-
-    // Convert the adc raw value to a voltage (mV)
-    adc_cali_raw_to_voltage(adc2IntTempCaliHandle_, intTempRawAdcValue_, &intTempVoltageMV_);
+    const int64_t timestampUs = sensorHalGetTimeUs();
 
     // Then calculate the temperature from the voltage
-    internalTemperature_ = ((double) intTempVoltageMV_ - 540.0) / 10.0;
+    const int oldInternalTemperature = internalTemperature_;
+    internalTemperature_ = intTempVoltageMV_ - INT_TEMPERATURE_OFFSET_MV;
+
+    // Did it change?
+    if (oldInternalTemperature != internalTemperature_) {
+        publishSample(SENSOR_INTERNAL_TEMPERATURE, internalTemperature_, UNIT_DECI_CELSIUS, timestampUs, quality);
+    }
 }
 
-double sensorManagerGetInternalTemperature(void) {
+int sensorManagerGetInternalTemperature(void) {
     return internalTemperature_;
-}
\ No newline at end of file
+}
+
+void sensorManagerUpdateShiftLight(const int64_t leadUs) {
+    // Was the init successfully?
+    if (initHalFailed_ || initRpmIsrFailed_) return;
+
+    // Is there a new period? A single one is noisy, the slope fit over the recent ones averages it
+    EdgeSnapshot snapshot;
+    edgeSnapshotRead(&rpmEdges_, &snapshot);
+    if (snapshot.edgeCount != shiftLightEdgeCount_ && snapshot.edgeCount - rpmEdgeCountAtStop_ >= 2) {
+        const int32_t frequency = fixedPointFrequencyFromPeriod(snapshot.lastEdgeUs - snapshot.previousEdgeUs);
+        if (frequency > 0 && frequency < RPM_MAX_FREQUENCY_MILLIHZ) {
+            const int32_t rpm = pwlEvaluate(&rpmConversionTable_, frequency);
+            shiftLightFeed(&shiftLight_, snapshot.lastEdgeUs, rpm);
+
+            // The gear from the same period, the speed changes much slower than the rpm during a shift
+            updateGear(rpm, snapshot.lastEdgeUs, SAMPLE_QUALITY_OK);
+        }
+    }
+    shiftLightEdgeCount_ = snapshot.edgeCount;
+
+    // Did it switch?
+    const int64_t now = sensorHalGetTimeUs();
+    const bool wasActive = shiftLight_.active;
+    if (shiftLightUpdate(&shiftLight_, now, leadUs) != wasActive) {
+        publishSample(SENSOR_SHIFT_LIGHT, shiftLight_.active, UNIT_BOOLEAN, now, SAMPLE_QUALITY_OK);
+    }
+}
+
+bool sensorManagerIsShiftLightActive(void) {
+    return shiftLight_.active;
+}
+
+void sensorManagerUpdateDigitalInputs(void) {
+    // Wait for the next change, but only until the blink pattern could change on its own
+    TickType_t timeout = portMAX_DELAY;
+    const int64_t startUs = sensorHalGetTimeUs();
+    const int64_t timeoutUs = blinkDetectorNextTimeoutUs(&blinkDetector_, startUs);
+    if (timeoutUs >= 0) {
+        const int64_t tickUs = portTICK_PERIOD_MS * 1000;
+        timeout = (TickType_t) ((timeoutUs - startUs + tickUs - 1) / tickUs);
+    }
+
+    // Publish the change right away, the GUI follows the lamps directly
+    DigitalInputEvent event;
+    if (digitalInputsWaitForEvent(&event, timeout)) {
+        publishSample(digitalInputSensors_[event.input], event.active, UNIT_BOOLEAN, event.timeUs, SAMPLE_QUALITY_OK);
+        blinkDetectorFeed(&blinkDetector_, &event);
+    }
+
+    // Did the pattern change?
+    const int64_t now = sensorHalGetTimeUs();
+    const BLINKER_PATTERN pattern = blinkDetectorEvaluate(&blinkDetector_, now);
+    if (pattern != blinkerPattern_) {
+        blinkerPattern_ = pattern;
+        publishSample(SENSOR_BLINKER_PATTERN, pattern, UNIT_PATTERN, now, SAMPLE_QUALITY_OK);
+    }
+}
+
+bool sensorManagerIsDigitalInputActive(const DIGITAL_INPUT input) {
+    return digitalInputsIsActive(input);
+}
+
+BLINKER_PATTERN sensorManagerGetBlinkerPattern(void) {
+    return blinkerPattern_;
+}
+
+void sensorManagerSetGearEstimation(const bool enabled) {
+    // Start over in neutral
+    portENTER_CRITICAL(&gearLock_);
+    gearEstimatorInit(&gearEstimator_);
+    gear_ = GEAR_NEUTRAL;
+    portEXIT_CRITICAL(&gearLock_);
+
+    gearEstimationEnabled_ = enabled;
+}
+
+int sensorManagerGetGear(void) {
+    return gear_;
+}
+
+void sensorManagerBeginRpmCalibration(void) {
+    // Reset the collected samples
+    pwlCalibrationBegin(&rpmCalibration_);
+    rpmCalibrationActive_ = true;
+
+    // Logging
+    loggerInfo("Rpm calibration started");
+}
+
+bool sensorManagerAddRpmCalibrationPoint(const int referenceRpm) {
+    // Is a calibration running and is there a valid frequency?
+    if (!rpmCalibrationActive_ || rpmInMilliHz_ <= 0) return false;
+
+    // Pair the measured frequency with the known rpm
+    pwlCalibrationAddSample(&rpmCalibration_, &rpmConversionTable_, rpmInMilliHz_, referenceRpm);
+
+    return true;
+}
+
+bool sensorManagerFinishRpmCalibration(void) {
+    // Is a calibration running?
+    if (!rpmCalibrationActive_) return false;
+    rpmCalibrationActive_ = false;
+
+    // Apply the learned values
+    const int adjustedPoints = pwlCalibrationApply(&rpmCalibration_, &rpmConversionTable_);
+
+    // Logging
+    loggerInfo("Rpm calibration finished! Adjusted %d of %d points with %d samples", adjustedPoints, rpmConversionTable_.pointCount, rpmCalibration_.sampleCount);
+
+    return adjustedPoints > 0;
+}
+
+//! \brief The if/else ladder the rpm was converted with before, used as benchmark reference
+//! \param hz The frequency in Hz
+//! \retval The rpm
+static int benchmarkLadderReference(const int hz) {
+    double multiplier = 0.0;
+
+    if (hz <= 0) return -1;
+    if (hz <= 8) multiplier = 50.0;
+    else if (hz <= 11) multiplier = 45.45;
+    else if (hz <= 17) multiplier = 41.18;
+    else if (hz <= 25) multiplier = 40.0;
+    else if (hz <= 56) multiplier = 34.48;
+    else if (hz <= 92) multiplier = 32.61;
+    else if (hz <= 123) multiplier = 32.52;
+    else if (hz <= 157) multiplier = 31.85;
+    else if (hz <= 188) multiplier = 31.91;
+    else if (hz <= 220) multiplier = 31.82;
+    else if (hz <= 262) multiplier = 30.54;
+
+    return (int) ((double) hz * multiplier);
+}
+
+//! \brief Times the rpm conversion with the table in use against the old if/else ladder
+static void benchmarkRpmConversion(void) {
+    volatile int32_t sink = 0;
+
+    const uint32_t ladderStart = esp_cpu_get_cycle_count();
+    for (int i = 0; i < SENSOR_MANAGER_RPM_BENCHMARK_ITERATIONS; i++) {
+        sink = benchmarkLadderReference(i % 300);
+    }
+    const uint32_t ladderCycles = esp_cpu_get_cycle_count() - ladderStart;
+
+    const uint32_t tableStart = esp_cpu_get_cycle_count();
+    for (int i = 0; i < SENSOR_MANAGER_RPM_BENCHMARK_ITERATIONS; i++) {
+        sink = pwlEvaluate(&rpmConversionTable_, (i % 300) * 1000);
+    }
+    const uint32_t tableCycles = esp_cpu_get_cycle_count() - tableStart;
+    (void) sink;
+
+    // Logging
+    loggerInfo("Rpm conversion: ladder %lu cycles/call, table %lu cycles/call", (unsigned long) (ladderCycles / SENSOR_MANAGER_RPM_BENCHMARK_ITERATIONS),
+               (unsigned long) (tableCycles / SENSOR_MANAGER_RPM_BENCHMARK_ITERATIONS));
+}
+
+bool sensorManager_test(void) {
+    // 100Hz speed signal (100km/h at 3600 pulses per km) with jitter and a dropout, 92Hz rpm signal (3000rpm) with ignition spikes,
+    // oil pressure switch closed (150mV), half full tank
+    const SensorHalGeneratorConfig config = {
+            .seed = 42,
+            .adc = {
+                    [SENSOR_HAL_ADC_OIL_PRESSURE] = {.baseMV = 150, .noiseMV = 20},
+                    [SENSOR_HAL_ADC_FUEL_LEVEL] = {.baseMV = 640, .noiseMV = 10},
+                    [SENSOR_HAL_ADC_WATER_TEMPERATURE] = {.baseMV = 1200, .rampMVPerS = 5, .noiseMV = 10, .spikeMV = 800, .spikeEveryUs = 1000000},
+                    [SENSOR_HAL_ADC_INT_TEMPERATURE] = {.baseMV = 790},
+            },
+            .pulse = {
+                    [SENSOR_HAL_PULSE_SPEED] = {.frequencyMilliHz = 100000, .jitterUs = 50, .dropoutEveryUs = 20000000, .dropoutLengthUs = 3000000},
+                    [SENSOR_HAL_PULSE_RPM] = {.frequencyMilliHz = 92000, .spuriousEdgeEveryUs = 5000000},
+            },
+    };
+    sensorHalGeneratorConfigure(&config);
+
+    // Restart everything on the generator
+    bool passed = sensorHalSelect(&sensorHalGenerator) && sensorManagerInit() == 1;
+    speedEdgeCountAtStop_ = speedEdges_.edgeCount;
+    rpmEdgeCountAtStop_ = rpmEdges_.edgeCount;
+
+    // Run it
+    const int expectedSpeed = fixedPointScale(100, 3600, ODOMETER_PULSES_PER_KM);
+    int speedUpdates = 0;
+    int speedStops = 0;
+    int rpmInRange = 0;
+    int rpmUpdates = 0;
+    const clock_t start = clock();
+    for (int64_t timeUs = SENSOR_MANAGER_TEST_STEP_US; timeUs <= SENSOR_MANAGER_TEST_DURATION_US; timeUs += SENSOR_MANAGER_TEST_STEP_US) {
+        sensorHalAdvanceTo(timeUs);
+
+        sensorManagerUpdateOilPressure();
+        sensorManagerUpdateFuelLevel();
+        sensorManagerUpdateWaterTemperature();
+        sensorManagerUpdateInternalTemperature();
+        sensorManagerUpdateSpeed();
+        sensorManagerUpdateRPM();
+
+        // The dropouts have to be detected as a stop, everything else is the signal
+        speedUpdates++;
+        if (speed_ == 0) speedStops++;
+        else passed &= speed_ >= expectedSpeed - 1 && speed_ <= expectedSpeed + 1;
+
+        // A spurious edge only disturbs one update
+        rpmUpdates++;
+        if (rpm_ >= 2990 && rpm_ <= 3010) rpmInRange++;
+    }
+    const clock_t elapsed = clock() - start;
+
+    passed &= oilPressure_;
+    passed &= internalTemperature_ == 250;
+    passed &= speedStops > 0 && speedStops < speedUpdates / 4;
+    passed &= rpmInRange >= rpmUpdates - rpmUpdates / 20;
+
+    // Logging
+    if (passed) {
+        loggerInfo("SensorManager pipeline tests passed");
+    } else {
+        loggerError("SensorManager pipeline tests FAILED");
+    }
+    loggerInfo("Simulated %lld s of sensor data in %ld ms (speed stopped %d/%d, rpm in range %d/%d)",
+               SENSOR_MANAGER_TEST_DURATION_US / 1000000, (long) (elapsed * 1000 / CLOCKS_PER_SEC), speedStops, speedUpdates, rpmInRange, rpmUpdates);
+
+    // The rpm table in use against the old ladder
+    benchmarkRpmConversion();
+
+    return passed;
+}
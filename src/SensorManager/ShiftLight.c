@@ -0,0 +1,129 @@
+/* --- Includes --- */
+#include "SensorManager/ShiftLight.h"
+
+// Project includes
+#include "Logger/Logger.h"
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+/* --- Function implementations --- */
+void shiftLightInit(ShiftLight *light) {
+    *light = (ShiftLight) {0};
+}
+
+void shiftLightFeed(ShiftLight *light, const int64_t timeUs, const int32_t rpm) {
+    // Overwrite the oldest one
+    light->newest = (light->newest + 1) % SHIFT_LIGHT_HISTORY;
+    light->timesUs[light->newest] = timeUs;
+    light->rpms[light->newest] = rpm;
+    if (light->count < SHIFT_LIGHT_HISTORY) light->count++;
+}
+
+int32_t shiftLightGetSlope(const ShiftLight *light, const int64_t nowUs) {
+    // Least squares with the times relative to now, so everything fits into 64 bit
+    int64_t n = 0, sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+    for (int i = 0; i < light->count; i++) {
+        const int index = (light->newest - i + SHIFT_LIGHT_HISTORY) % SHIFT_LIGHT_HISTORY;
+        const int64_t x = light->timesUs[index] - nowUs;
+        if (-x > SHIFT_LIGHT_MAX_AGE_US) break;
+
+        n++;
+        sumX += x;
+        sumY += light->rpms[index];
+        sumXX += x * x;
+        sumXY += x * light->rpms[index];
+    }
+
+    // Does it span any time?
+    const int64_t denominator = n * sumXX - sumX * sumX;
+    if (n < 3 || denominator <= 0) return 0;
+
+    // rpm/us -> rpm/s
+    return (int32_t) ((n * sumXY - sumX * sumY) * 1000000 / denominator);
+}
+
+int64_t shiftLightPredictRedlineUs(const ShiftLight *light, const int64_t nowUs) {
+    // Does it rise fast enough to be predicted?
+    const int32_t slope = shiftLightGetSlope(light, nowUs);
+    if (slope < SHIFT_LIGHT_MIN_SLOPE_RPM_PER_S) return -1;
+
+    // Where is it now? The newest measurement is already a bit old
+    const int64_t newestUs = light->timesUs[light->newest];
+    const int64_t rpm = light->rpms[light->newest] + (int64_t) slope * (nowUs - newestUs) / 1000000;
+    if (rpm >= SHIFT_LIGHT_REDLINE_RPM) return nowUs;
+
+    return nowUs + (SHIFT_LIGHT_REDLINE_RPM - rpm) * 1000000 / slope;
+}
+
+bool shiftLightUpdate(ShiftLight *light, const int64_t nowUs, int64_t leadUs) {
+    // Nothing measured lately -> the engine stopped
+    if (light->count == 0 || nowUs - light->timesUs[light->newest] > SHIFT_LIGHT_MAX_AGE_US) {
+        light->active = false;
+        return light->active;
+    }
+
+    if (leadUs > SHIFT_LIGHT_MAX_LEAD_US) leadUs = SHIFT_LIGHT_MAX_LEAD_US;
+    const int32_t rpm = light->rpms[light->newest];
+    const int64_t redlineUs = shiftLightPredictRedlineUs(light, nowUs);
+
+    if (rpm >= SHIFT_LIGHT_REDLINE_RPM || (redlineUs >= 0 && redlineUs - nowUs <= leadUs)) {
+        // At the redline or it will be there once the light is visible
+        light->active = true;
+    } else if (rpm < SHIFT_LIGHT_REDLINE_RPM - SHIFT_LIGHT_RELEASE_RPM) {
+        // Shifted or let off the throttle
+        light->active = false;
+    }
+
+    return light->active;
+}
+
+bool shiftLight_test(void) {
+    bool passed = true;
+    ShiftLight light;
+    shiftLightInit(&light);
+
+    // 4000 rpm/s from 5000 rpm, one measurement every 5ms
+    int64_t timeUs = 1000000;
+    int32_t rpm = 5000;
+    while (rpm < 6400) {
+        shiftLightFeed(&light, timeUs, rpm + (timeUs / 5000 % 2 ? 30 : -30));
+        timeUs += 5000;
+        rpm += 20;
+    }
+    const int32_t slope = shiftLightGetSlope(&light, timeUs);
+    passed &= slope > 3800 && slope < 4200;
+
+    // 600 rpm to go -> ~150ms, so a 100ms lead isn't enough yet but a 200ms one is
+    const int64_t redlineUs = shiftLightPredictRedlineUs(&light, timeUs);
+    passed &= redlineUs - timeUs > 130000 && redlineUs - timeUs < 170000;
+    passed &= !shiftLightUpdate(&light, timeUs, 100000);
+    passed &= shiftLightUpdate(&light, timeUs, 200000);
+
+    // Stays on until the rpm drops (shifted)
+    shiftLightFeed(&light, timeUs + 5000, 4500);
+    passed &= !shiftLightUpdate(&light, timeUs + 5000, 200000);
+
+    // Steady just below the redline -> nothing predicted, at the redline -> on
+    shiftLightInit(&light);
+    for (int i = 0; i < SHIFT_LIGHT_HISTORY; i++) {
+        shiftLightFeed(&light, timeUs, 6900);
+        timeUs += 5000;
+    }
+    passed &= shiftLightPredictRedlineUs(&light, timeUs) == -1 && !shiftLightUpdate(&light, timeUs, 200000);
+    shiftLightFeed(&light, timeUs, 7050);
+    passed &= shiftLightUpdate(&light, timeUs, 0);
+
+    // No more measurements -> off
+    passed &= !shiftLightUpdate(&light, timeUs + SHIFT_LIGHT_MAX_AGE_US + 1, 0);
+
+    // Logging
+    if (passed) {
+        loggerInfo("Shift light tests passed");
+    } else {
+        loggerError("Shift light tests FAILED");
+    }
+
+    return passed;
+}
@@ -0,0 +1,391 @@
+/* --- Includes --- */
+#include "Settings/Settings.h"
+
+// Project includes, they define the defaults
+#include "Core/Core.h"
+#include "GUI/GUI.h"
+
+// C includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* --- Private Defines & Macros --- */
+
+// The setting has no partner it must not be above
+#define SETTING_NONE SETTING_COUNT
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// Description of a setting
+typedef struct {
+    const char *name;// Key in the NVS and the override file, at most 15 characters
+    int32_t defaultValue;
+    int32_t minValue;
+    int32_t maxValue;
+    SETTING notAbove;// The min interval of a pair must not be above its max interval
+} SettingDescriptor;
+
+static const SettingDescriptor descriptors_[SETTING_COUNT] = {
+        [SETTING_OIL_PRESSURE_INTERVAL_MIN_MS] = {"oil_min_ms", OIL_PRESSURE_UPDATE_INTERVAL_MIN_MS, 10, 60 * 1000, SETTING_OIL_PRESSURE_INTERVAL_MAX_MS},
+        [SETTING_OIL_PRESSURE_INTERVAL_MAX_MS] = {"oil_max_ms", OIL_PRESSURE_UPDATE_INTERVAL_MAX_MS, 10, 600 * 1000, SETTING_NONE},
+        [SETTING_FUEL_LEVEL_INTERVAL_MIN_MS] = {"fuel_min_ms", FUEL_LEVEL_UPDATE_INTERVAL_MIN_MS, 10, 60 * 1000, SETTING_FUEL_LEVEL_INTERVAL_MAX_MS},
+        [SETTING_FUEL_LEVEL_INTERVAL_MAX_MS] = {"fuel_max_ms", FUEL_LEVEL_UPDATE_INTERVAL_MAX_MS, 10, 600 * 1000, SETTING_NONE},
+        [SETTING_WATER_TEMPERATURE_INTERVAL_MIN_MS] = {"water_min_ms", WATER_TEMPERATURE_UPDATE_INTERVAL_MIN_MS, 10, 60 * 1000, SETTING_WATER_TEMPERATURE_INTERVAL_MAX_MS},
+        [SETTING_WATER_TEMPERATURE_INTERVAL_MAX_MS] = {"water_max_ms", WATER_TEMPERATURE_UPDATE_INTERVAL_MAX_MS, 10, 600 * 1000, SETTING_NONE},
+        [SETTING_INTERNAL_TEMPERATURE_INTERVAL_MIN_MS] = {"itemp_min_ms", INTERNAL_TEMPERATURE_UPDATE_INTERVAL_MIN_MS, 10, 60 * 1000, SETTING_INTERNAL_TEMPERATURE_INTERVAL_MAX_MS},
+        [SETTING_INTERNAL_TEMPERATURE_INTERVAL_MAX_MS] = {"itemp_max_ms", INTERNAL_TEMPERATURE_UPDATE_INTERVAL_MAX_MS, 10, 600 * 1000, SETTING_NONE},
+        [SETTING_SPEED_INTERVAL_MIN_MS] = {"speed_min_ms", SPEED_UPDATE_INTERVAL_MIN_MS, 10, 60 * 1000, SETTING_SPEED_INTERVAL_MAX_MS},
+        [SETTING_SPEED_INTERVAL_MAX_MS] = {"speed_max_ms", SPEED_UPDATE_INTERVAL_MAX_MS, 10, 600 * 1000, SETTING_NONE},
+        [SETTING_RPM_INTERVAL_MIN_MS] = {"rpm_min_ms", RPM_UPDATE_INTERVAL_MIN_MS, 10, 60 * 1000, SETTING_RPM_INTERVAL_MAX_MS},
+        [SETTING_RPM_INTERVAL_MAX_MS] = {"rpm_max_ms", RPM_UPDATE_INTERVAL_MAX_MS, 10, 600 * 1000, SETTING_NONE},
+        [SETTING_SHIFT_LIGHT_INTERVAL_MS] = {"shift_ms", SHIFT_LIGHT_UPDATE_INTERVAL_MS, 1, 1000, SETTING_NONE},
+        [SETTING_SYSTEM_MONITOR_INTERVAL_MS] = {"monitor_ms", SYSTEM_MONITOR_SAMPLE_INTERVAL_MS, 1000, 600 * 1000, SETTING_NONE},
+        [SETTING_STATISTICS_DUMP_INTERVAL_MS] = {"stats_ms", STATISTICS_DUMP_INTERVAL_MS, 1000, 3600 * 1000, SETTING_NONE},
+        [SETTING_ADC_ACQUISITION_PRIORITY] = {"adc_prio", ADC_ACQUISITION_PRIORITY_LEVEL, 0, 10, SETTING_NONE},
+        [SETTING_SPEED_PRIORITY] = {"speed_prio", SPEED_PRIORITY_LEVEL, 0, 10, SETTING_NONE},
+        [SETTING_RPM_PRIORITY] = {"rpm_prio", RPM_PRIORITY_LEVEL, 0, 10, SETTING_NONE},
+        [SETTING_SHIFT_LIGHT_PRIORITY] = {"shift_prio", SHIFT_LIGHT_PRIORITY_LEVEL, 0, 10, SETTING_NONE},
+        [SETTING_SCHEDULER_TASK_PRIORITY] = {"sched_prio", SCHEDULER_PRIORITY_LEVEL, 1, configMAX_PRIORITIES - 1, SETTING_NONE},
+        [SETTING_GUI_SPI_SPEED_HZ] = {"spi_hz", GUI_SPI_SPEED, 1000000, 80000000, SETTING_NONE},
+        [SETTING_GUI_REFRESH_PERIOD_MS] = {"refresh_ms", LV_DEF_REFR_PERIOD, 1, 1000, SETTING_NONE},
+        [SETTING_LOGGING_LEVEL] = {"log_level", LOGGING_LEVEL, 0, 4, SETTING_NONE},
+        [SETTING_CAN_CHANNELS] = {"can_channels", CAN_DEFAULT_CHANNELS, 0, CAN_CHANNEL_BIT(CAN_CHANNEL_COUNT) - 1, SETTING_NONE},
+};
+
+// The current values. An aligned 32 bit read is atomic, so they are read without the lock
+static volatile int32_t values_[SETTING_COUNT];
+
+// Protects the writes, a value and its partner have to be checked together
+static portMUX_TYPE valuesLock_ = portMUX_INITIALIZER_UNLOCKED;
+
+// The subscribers of every setting
+static SettingsSubscriber subscribers_[SETTING_COUNT][SETTINGS_MAX_SUBSCRIBERS] = {0};
+
+//! \brief Checks if a value is within the range of a setting
+//! \retval Boolean indicating if it is
+static bool isInRange(const SETTING setting, const int32_t value) {
+    return value >= descriptors_[setting].minValue && value <= descriptors_[setting].maxValue;
+}
+
+//! \brief Checks if a value fits the other values: a min interval must not be above its max interval
+//! \param values The values the setting would be part of
+//! \retval Boolean indicating if it fits
+static bool fitsPartners(const volatile int32_t *values, const SETTING setting, const int32_t value) {
+    // Is it a min interval?
+    const SETTING notAbove = descriptors_[setting].notAbove;
+    if (notAbove != SETTING_NONE && value > values[notAbove]) return false;
+
+    // Is it a max interval?
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        if (descriptors_[i].notAbove == setting && values[i] > value) return false;
+    }
+
+    return true;
+}
+
+//! \brief Finds a setting by its name
+//! \retval The setting or SETTING_NONE if there is no such setting
+static SETTING findSetting(const char *name) {
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        if (strcmp(descriptors_[i].name, name) == 0) return i;
+    }
+
+    return SETTING_NONE;
+}
+
+//! \brief Calls every subscriber of a setting
+static void notifySubscribers(const SETTING setting, const int32_t value) {
+    for (int i = 0; i < SETTINGS_MAX_SUBSCRIBERS; i++) {
+        if (subscribers_[setting][i] != NULL) {
+            subscribers_[setting][i](setting, value);
+        }
+    }
+}
+
+//! \brief Stores a value in the NVS
+//! \retval Boolean indicating if it worked
+static bool storeValue(const SETTING setting, const int32_t value) {
+    nvs_handle_t handle;
+    if (nvs_open(SETTINGS_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) return false;
+
+    const bool success = nvs_set_i32(handle, descriptors_[setting].name, value) == ESP_OK && nvs_commit(handle) == ESP_OK;
+    nvs_close(handle);
+
+    return success;
+}
+
+//! \brief Loads the values stored in the NVS, values out of range are skipped
+//! \param values Where they are written to
+static void loadStoredValues(int32_t *values) {
+    nvs_handle_t handle;
+    if (nvs_open(SETTINGS_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) return;
+
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        int32_t value;
+        if (nvs_get_i32(handle, descriptors_[i].name, &value) != ESP_OK) continue;
+
+        if (isInRange(i, value)) {
+            values[i] = value;
+        } else {
+            // Logging
+            loggerWarn("Stored setting %s=%ld is out of range, using %ld", descriptors_[i].name, (long) value, (long) values[i]);
+        }
+    }
+    nvs_close(handle);
+}
+
+//! \brief Parses a line of the override file
+//! \param line The line, it is modified
+//! \param name Set to the name
+//! \param value Set to the value
+//! \retval Boolean indicating if it is a "name=value" line
+static bool parseLine(char *line, char **name, int32_t *value) {
+    // Split it at the '='
+    char *separator = strchr(line, '=');
+    if (separator == NULL) return false;
+    *separator = '\0';
+
+    // The name without the surrounding spaces
+    while (*line == ' ') line++;
+    char *end = separator;
+    while (end > line && end[-1] == ' ') end--;
+    *end = '\0';
+    *name = line;
+
+    // The whole rest has to be the number
+    char *numberEnd;
+    const long number = strtol(separator + 1, &numberEnd, 0);
+    while (*numberEnd == ' ' || *numberEnd == '\r' || *numberEnd == '\n') numberEnd++;
+
+    *value = (int32_t) number;
+    return **name != '\0' && numberEnd != separator + 1 && *numberEnd == '\0';
+}
+
+//! \brief Reads the override file, values out of range or unknown names are skipped
+//! \param values Where they are written to
+//! \param read Set for every value that was read
+//! \retval The number of values read or -1 if there is no such file
+static int loadOverrideFile(int32_t *values, bool *read) {
+    // Is there a file at all?
+    if (!fileManagerDoesFileExists(SETTINGS_OVERRIDE_FILE, LOCATION_SDCARD)) return -1;
+
+    FILE *file = fileManagerOpenFile(SETTINGS_OVERRIDE_FILE, "r", LOCATION_SDCARD);
+    if (file == NULL) return -1;
+
+    int count = 0;
+    int lineNumber = 0;
+    char line[SETTINGS_LINE_LENGTH];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+
+        // Skip comments and empty lines
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+
+        char *name;
+        int32_t value;
+        if (!parseLine(line, &name, &value)) {
+            // Logging
+            loggerWarn("%s:%d is no 'name=value' line, skipped", SETTINGS_OVERRIDE_FILE, lineNumber);
+
+            continue;
+        }
+
+        const SETTING setting = findSetting(name);
+        if (setting == SETTING_NONE || !isInRange(setting, value)) {
+            // Logging
+            loggerWarn("%s:%d: unknown setting or out of range: %s=%ld", SETTINGS_OVERRIDE_FILE, lineNumber, name, (long) value);
+
+            continue;
+        }
+
+        values[setting] = value;
+        read[setting] = true;
+        count++;
+    }
+    fclose(file);
+
+    return count;
+}
+
+/* --- Function implementations --- */
+void settingsInit(void) {
+    // Defaults first, every source after that overrides them
+    int32_t values[SETTING_COUNT];
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        values[i] = descriptors_[i].defaultValue;
+    }
+    loadStoredValues(values);
+
+    // A pair that doesn't fit together falls back to its defaults as a whole
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        const SETTING notAbove = descriptors_[i].notAbove;
+        if (notAbove == SETTING_NONE || values[i] <= values[notAbove]) continue;
+
+        // Logging
+        loggerWarn("Setting %s=%ld is above %s=%ld, using the defaults of both", descriptors_[i].name, (long) values[i], descriptors_[notAbove].name,
+                   (long) values[notAbove]);
+
+        values[i] = descriptors_[i].defaultValue;
+        values[notAbove] = descriptors_[notAbove].defaultValue;
+    }
+
+    portENTER_CRITICAL(&valuesLock_);
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        values_[i] = values[i];
+    }
+    portEXIT_CRITICAL(&valuesLock_);
+}
+
+int32_t settingsGet(const SETTING setting) {
+    return values_[setting];
+}
+
+bool settingsSet(const SETTING setting, const int32_t value, const bool persist) {
+    // Is the setting valid?
+    if (setting >= SETTING_COUNT) return false;
+
+    // Check and set it together with its partner
+    bool valid = isInRange(setting, value);
+    bool changed = false;
+    portENTER_CRITICAL(&valuesLock_);
+    valid = valid && fitsPartners(values_, setting, value);
+    if (valid) {
+        changed = values_[setting] != value;
+        values_[setting] = value;
+    }
+    portEXIT_CRITICAL(&valuesLock_);
+
+    if (!valid) {
+        // Logging
+        loggerWarn("Setting %s=%ld is out of range or doesn't fit its partner", descriptors_[setting].name, (long) value);
+
+        return false;
+    }
+
+    // Logging
+    if (changed) loggerInfo("Setting %s=%ld", descriptors_[setting].name, (long) value);
+
+    const bool stored = !persist || storeValue(setting, value);
+    if (!stored) {
+        // Logging
+        loggerError("Couldn't store the setting %s", descriptors_[setting].name);
+    }
+
+    // Outside of the lock, subscribers may take long or set other settings
+    if (changed) notifySubscribers(setting, value);
+
+    return stored;
+}
+
+bool settingsSetByName(const char *name, const int32_t value, const bool persist) {
+    const SETTING setting = findSetting(name);
+    if (setting == SETTING_NONE) {
+        // Logging
+        loggerWarn("Unknown setting: %s", name);
+
+        return false;
+    }
+
+    return settingsSet(setting, value, persist);
+}
+
+int settingsReloadOverrideFile(void) {
+    // Only the values of the file change
+    int32_t values[SETTING_COUNT];
+    bool read[SETTING_COUNT] = {false};
+    if (loadOverrideFile(values, read) < 0) return -1;
+
+    // Max intervals first, so the min intervals are checked against the new ones
+    int applied = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < SETTING_COUNT; i++) {
+            const bool isMinInterval = descriptors_[i].notAbove != SETTING_NONE;
+            if (!read[i] || isMinInterval != (pass == 1)) continue;
+
+            if (settingsSet(i, values[i], false)) applied++;
+        }
+    }
+
+    // Logging
+    loggerInfo("Applied %d settings from %s", applied, SETTINGS_OVERRIDE_FILE);
+
+    return applied;
+}
+
+bool settingsApplyCommand(char *command) {
+    // Read the file again, e.g. after it was edited on another device
+    if (strcmp(command, "reload") == 0) return settingsReloadOverrideFile() >= 0;
+
+    // Back to the defaults from the next boot on
+    if (strcmp(command, "erase") == 0) return settingsErase();
+
+    // Keep the value for the next boot as well?
+    const bool persist = strncmp(command, SETTINGS_SAVE_COMMAND, strlen(SETTINGS_SAVE_COMMAND)) == 0;
+    if (persist) command += strlen(SETTINGS_SAVE_COMMAND);
+
+    char *name;
+    int32_t value;
+    if (!parseLine(command, &name, &value)) {
+        // Logging
+        loggerWarn("Unknown command: %s, expected 'name=value', 'save name=value', 'reload' or 'erase'", command);
+
+        return false;
+    }
+
+    return settingsSetByName(name, value, persist);
+}
+
+bool settingsErase(void) {
+    nvs_handle_t handle;
+    if (nvs_open(SETTINGS_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) return false;
+
+    const bool success = nvs_erase_all(handle) == ESP_OK && nvs_commit(handle) == ESP_OK;
+    nvs_close(handle);
+
+    // Logging
+    if (success) {
+        loggerInfo("Erased the stored settings, the defaults are used from the next boot on");
+    } else {
+        loggerError("Couldn't erase the stored settings");
+    }
+
+    return success;
+}
+
+bool settingsGetStored(const SETTING setting, int32_t *value) {
+    // Is the setting valid?
+    if (setting >= SETTING_COUNT) return false;
+
+    nvs_handle_t handle;
+    if (nvs_open(SETTINGS_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) return false;
+
+    const bool success = nvs_get_i32(handle, descriptors_[setting].name, value) == ESP_OK;
+    nvs_close(handle);
+
+    return success;
+}
+
+const char *settingsGetName(const SETTING setting) {
+    if (setting >= SETTING_COUNT) return "unknown";
+
+    return descriptors_[setting].name;
+}
+
+bool settingsSubscribe(const SETTING setting, const SettingsSubscriber subscriber) {
+    // Is the setting valid?
+    if (setting >= SETTING_COUNT || subscriber == NULL) return false;
+
+    // Search a free slot
+    for (int i = 0; i < SETTINGS_MAX_SUBSCRIBERS; i++) {
+        if (subscribers_[setting][i] == NULL) {
+            subscribers_[setting][i] = subscriber;
+            return true;
+        }
+    }
+
+    // Logging
+    loggerError("No free subscriber slot for setting: %s", descriptors_[setting].name);
+
+    return false;
+}
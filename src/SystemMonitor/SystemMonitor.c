@@ -0,0 +1,180 @@
+/* --- Includes --- */
+#include "SystemMonitor/SystemMonitor.h"
+
+// C includes
+#include <string.h>
+
+/* --- Private Defines & Macros --- */
+
+// Room for the state of all tasks, uxTaskGetSystemState() fails if there are more
+#define SYSTEM_MONITOR_STATUS_BUFFER_LENGTH (SYSTEM_MONITOR_MAX_TASKS + 8)
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// A task which was seen at least once
+typedef struct {
+    UBaseType_t taskNumber;// Unique, unlike the handle which may be reused
+    char name[configMAX_TASK_NAME_LEN];
+    uint32_t lastRunTime;// Run time counter at the last sample
+} TrackedTask;
+
+static TrackedTask trackedTasks_[SYSTEM_MONITOR_MAX_TASKS];
+static volatile int trackedTaskCount_ = 0;
+
+// Rolling history, head_ is where the next sample is written
+static SystemMonitorSample history_[SYSTEM_MONITOR_HISTORY_LENGTH];
+static int head_ = 0;
+static int sampleCount_ = 0;
+
+// Protects the history, it is read by other tasks
+static portMUX_TYPE historyLock_ = portMUX_INITIALIZER_UNLOCKED;
+
+// State of the last sample
+static uint32_t lastTotalRunTime_ = 0;
+static int64_t lastSampleUs_ = 0;
+
+// Only used while sampling, too large for the stack
+static TaskStatus_t taskStatus_[SYSTEM_MONITOR_STATUS_BUFFER_LENGTH];
+
+// Capabilities and printable names of the heaps
+static const uint32_t heapCaps_[SYSTEM_MONITOR_HEAP_COUNT] = {
+        [SYSTEM_MONITOR_HEAP_INTERNAL] = MALLOC_CAP_INTERNAL,
+        [SYSTEM_MONITOR_HEAP_DMA] = MALLOC_CAP_DMA,
+        [SYSTEM_MONITOR_HEAP_PSRAM] = MALLOC_CAP_SPIRAM,
+};
+static const char *heapNames_[SYSTEM_MONITOR_HEAP_COUNT] = {
+        [SYSTEM_MONITOR_HEAP_INTERNAL] = "internal",
+        [SYSTEM_MONITOR_HEAP_DMA] = "DMA",
+        [SYSTEM_MONITOR_HEAP_PSRAM] = "PSRAM",
+};
+
+//! \brief Finds a task in the tracked tasks or starts tracking it
+//! \param status The state of the task
+//! \retval The index or -1 if all slots are taken
+static int trackTask(const TaskStatus_t *status) {
+    for (int i = 0; i < trackedTaskCount_; i++) {
+        if (trackedTasks_[i].taskNumber == status->xTaskNumber) return i;
+    }
+    if (trackedTaskCount_ >= SYSTEM_MONITOR_MAX_TASKS) return -1;
+
+    // New task, its run time so far counts for the first interval
+    TrackedTask *task = &trackedTasks_[trackedTaskCount_];
+    task->taskNumber = status->xTaskNumber;
+    strncpy(task->name, status->pcTaskName, configMAX_TASK_NAME_LEN - 1);
+    task->name[configMAX_TASK_NAME_LEN - 1] = '\0';
+    task->lastRunTime = 0;
+
+    // Publish it only once the name is there
+    return trackedTaskCount_++;
+}
+
+/* --- Function implementations --- */
+void systemMonitorSample(void) {
+    SystemMonitorSample sample = {0};
+    sample.timestampUs = esp_timer_get_time();
+    sample.intervalUs = sample.timestampUs - lastSampleUs_;
+    lastSampleUs_ = sample.timestampUs;
+
+    // Get the state of every task
+    uint32_t totalRunTime = 0;
+    const UBaseType_t statusCount = uxTaskGetSystemState(taskStatus_, SYSTEM_MONITOR_STATUS_BUFFER_LENGTH, &totalRunTime);
+    if (statusCount == 0) {
+        // Logging
+        loggerWarn("System monitor: more than %d tasks, couldn't get their state", SYSTEM_MONITOR_STATUS_BUFFER_LENGTH);
+    }
+
+    // The counters are 32 bit, the unsigned differences survive a wrap around
+    const uint32_t totalDelta = totalRunTime - lastTotalRunTime_;
+    lastTotalRunTime_ = totalRunTime;
+
+    // Tasks which don't exist (anymore) stay marked
+    for (int i = 0; i < SYSTEM_MONITOR_MAX_TASKS; i++) {
+        sample.tasks[i].loadPermille = SYSTEM_MONITOR_NO_TASK;
+    }
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        sample.coreLoadPermille[core] = SYSTEM_MONITOR_NO_TASK;
+    }
+
+    for (UBaseType_t i = 0; i < statusCount; i++) {
+        const TaskStatus_t *status = &taskStatus_[i];
+        const int index = trackTask(status);
+        if (index < 0) continue;
+
+        // Load over the interval
+        TrackedTask *task = &trackedTasks_[index];
+        const uint32_t runDelta = status->ulRunTimeCounter - task->lastRunTime;
+        task->lastRunTime = status->ulRunTimeCounter;
+        const uint64_t load = totalDelta > 0 ? (uint64_t) runDelta * 1000 / totalDelta : 0;
+        sample.tasks[index].loadPermille = load < SYSTEM_MONITOR_NO_TASK ? (uint16_t) load : SYSTEM_MONITOR_NO_TASK - 1;
+
+        // A core is busy whenever it doesn't run its idle task
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            if (status->xHandle == xTaskGetIdleTaskHandleForCore(core)) sample.coreLoadPermille[core] = load < 1000 ? (uint16_t) (1000 - load) : 0;
+        }
+
+        // The high water mark is in bytes on this port
+        sample.tasks[index].stackFreeBytes = status->usStackHighWaterMark < UINT16_MAX ? (uint16_t) status->usStackHighWaterMark : UINT16_MAX;
+
+        // Where it runs, so the load of a core can be split up into its tasks
+        const BaseType_t core = xTaskGetCoreID(status->xHandle);
+        sample.tasks[index].core = core >= 0 && core < portNUM_PROCESSORS ? (int8_t) core : SYSTEM_MONITOR_ANY_CORE;
+    }
+    sample.taskCount = (uint8_t) trackedTaskCount_;
+
+    // Get the state of every heap
+    for (int i = 0; i < SYSTEM_MONITOR_HEAP_COUNT; i++) {
+        multi_heap_info_t info;
+        heap_caps_get_info(&info, heapCaps_[i]);
+        sample.heaps[i] = (SystemMonitorHeap) {
+                .freeBytes = info.total_free_bytes,
+                .minimumFreeBytes = info.minimum_free_bytes,
+                .largestFreeBlock = info.largest_free_block,
+        };
+    }
+
+    // Add it to the history
+    portENTER_CRITICAL(&historyLock_);
+    history_[head_] = sample;
+    head_ = (head_ + 1) % SYSTEM_MONITOR_HISTORY_LENGTH;
+    if (sampleCount_ < SYSTEM_MONITOR_HISTORY_LENGTH) sampleCount_++;
+    portEXIT_CRITICAL(&historyLock_);
+}
+
+bool systemMonitorGetSample(const int age, SystemMonitorSample *sample) {
+    portENTER_CRITICAL(&historyLock_);
+    const bool found = age >= 0 && age < sampleCount_;
+    if (found) *sample = history_[(head_ - 1 - age + SYSTEM_MONITOR_HISTORY_LENGTH) % SYSTEM_MONITOR_HISTORY_LENGTH];
+    portEXIT_CRITICAL(&historyLock_);
+
+    return found;
+}
+
+const char *systemMonitorGetTaskName(const int task) {
+    if (task < 0 || task >= trackedTaskCount_) return NULL;
+
+    return trackedTasks_[task].name;
+}
+
+void systemMonitorDump(void) {
+    SystemMonitorSample sample;
+    if (!systemMonitorGetSample(0, &sample)) return;
+
+    // Logging
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        if (sample.coreLoadPermille[core] == SYSTEM_MONITOR_NO_TASK) continue;
+
+        loggerInfo("Core %d: load=%u.%u%%", core, sample.coreLoadPermille[core] / 10, sample.coreLoadPermille[core] % 10);
+    }
+    for (int i = 0; i < SYSTEM_MONITOR_HEAP_COUNT; i++) {
+        const SystemMonitorHeap *heap = &sample.heaps[i];
+        loggerInfo("Heap %s: free=%lu min=%lu largest=%lu", heapNames_[i], (unsigned long) heap->freeBytes, (unsigned long) heap->minimumFreeBytes,
+                   (unsigned long) heap->largestFreeBlock);
+    }
+    for (int i = 0; i < sample.taskCount; i++) {
+        const SystemMonitorTask *task = &sample.tasks[i];
+        if (task->loadPermille == SYSTEM_MONITOR_NO_TASK) continue;
+
+        loggerInfo("Task %s: core=%d load=%u.%u%% stack free=%u bytes", systemMonitorGetTaskName(i), task->core, task->loadPermille / 10,
+                   task->loadPermille % 10, task->stackFreeBytes);
+    }
+}
@@ -0,0 +1,180 @@
+/* --- Includes --- */
+#include "Telemetry/Telemetry.h"
+
+// Project includes
+#include "macros.h"
+
+// espidf includes
+#include <driver/usb_serial_jtag.h>
+#include <driver/usb_serial_jtag_vfs.h>
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// Id of the event bus subscriber
+static int subscriberId_ = -1;
+
+// Counters, written by the task and read by the statistics dump
+static TelemetryStats stats_;
+static portMUX_TYPE statsLock_ = portMUX_INITIALIZER_UNLOCKED;
+
+// State of the last dump, for the bandwidth in between
+static TelemetryStats lastDumpStats_;
+static int64_t lastDumpUs_ = 0;
+
+// The encoded frame, only used by the task
+static uint8_t wire_[TELEMETRY_MAX_FRAME_SIZE];
+
+// Task handler
+TaskHandle_t taskTelemetryHandler_ = NULL;
+
+//! \brief Writes an encoded frame to the port, all or nothing
+//! \param data The frame
+//! \param length The number of bytes
+//! \retval Boolean indicating if it was written
+static bool writeFrame(const uint8_t *data, const size_t length) {
+    // Never wait, the samples keep coming no matter if a host reads them
+    return usb_serial_jtag_write_bytes(data, length, 0) == (int) length;
+}
+
+//! \brief Encodes and writes a frame, then counts it
+//! \param frame The frame
+static void sendFrame(TelemetryFrame *frame) {
+    const size_t length = telemetryFrameEncode(frame, wire_);
+    const bool written = writeFrame(wire_, length);
+
+    portENTER_CRITICAL(&statsLock_);
+    if (written) {
+        stats_.frames++;
+        stats_.samples += frame->count;
+        stats_.bytes += length;
+    } else {
+        stats_.droppedFrames++;
+        stats_.droppedSamples += frame->count;
+    }
+    portEXIT_CRITICAL(&statsLock_);
+}
+
+/* --- Tasks --- */
+
+//! \brief Task, which batches the samples into frames. A frame is sent once it is full or its first sample
+//! waited TELEMETRY_FLUSH_INTERVAL_MS
+void taskSendTelemetry(void *params) {
+    uint16_t sequence = 0;
+    TelemetryFrame frame;
+    telemetryFrameBegin(&frame, sequence);
+    TickType_t firstSampleTick = 0;
+
+    // ReSharper disable once CppDFAEndlessLoop
+    while (1) {
+        // Wait for the next sample, but not longer than the first one of the frame may wait
+        TickType_t timeout = portMAX_DELAY;
+        if (frame.count > 0) {
+            const TickType_t waited = xTaskGetTickCount() - firstSampleTick;
+            timeout = waited < pdMS_TO_TICKS(TELEMETRY_FLUSH_INTERVAL_MS) ? pdMS_TO_TICKS(TELEMETRY_FLUSH_INTERVAL_MS) - waited : 0;
+        }
+
+        SensorSample sample;
+        if (eventBusReceive(subscriberId_, &sample, timeout)) {
+            if (frame.count == 0) firstSampleTick = xTaskGetTickCount();
+            telemetryFrameAdd(&frame, &sample);
+
+            // Is there room for more?
+            if (frame.count < TELEMETRY_MAX_SAMPLES_PER_FRAME) continue;
+        } else if (frame.count == 0) {
+            continue;
+        }
+
+        // The sequence counts dropped frames as well, so the host sees the gap
+        sendFrame(&frame);
+        telemetryFrameBegin(&frame, ++sequence);
+    }
+}
+
+/* --- Function implementations --- */
+bool telemetryInit(const int queueLength, const UBaseType_t taskPriority, const BaseType_t core) {
+    // Frames and text have to go through the same driver, otherwise a log line may end up inside a frame
+    usb_serial_jtag_driver_config_t config = USB_SERIAL_JTAG_DRIVER_CONFIG_DEFAULT();
+    config.tx_buffer_size = TELEMETRY_TX_BUFFER_SIZE;
+    config.rx_buffer_size = TELEMETRY_RX_BUFFER_SIZE;
+    if (usb_serial_jtag_driver_install(&config) != ESP_OK) {
+        // Logging
+        loggerError("Couldn't install the USB-Serial-JTAG driver, there is no telemetry");
+
+        return false;
+    }
+    usb_serial_jtag_vfs_use_driver();
+
+    // Every sample, the oldest ones are dropped if the port can't keep up
+    subscriberId_ = eventBusSubscribe("Telemetry", EVENT_BUS_ALL_TOPICS, queueLength, EVENT_BUS_DROP_OLDEST);
+    if (subscriberId_ < 0) return false;
+
+    lastDumpUs_ = esp_timer_get_time();
+    if (TASK_CREATE(taskSendTelemetry, "taskSendTelemetry", 4096, NULL, taskPriority, &taskTelemetryHandler_, core) != pdPASS) {
+        // Logging
+        loggerError("Couldn't create the telemetry task!");
+
+        return false;
+    }
+
+    // Logging
+    loggerInfo("Telemetry started, up to %d samples per frame", TELEMETRY_MAX_SAMPLES_PER_FRAME);
+
+    return true;
+}
+
+bool telemetryReadLine(char *line, const size_t size) {
+    size_t length = 0;
+    bool tooLong = false;
+
+    // Wait for the bytes one by one, the host types slowly compared to the port
+    while (1) {
+        char c;
+        if (usb_serial_jtag_read_bytes(&c, 1, portMAX_DELAY) != 1) continue;
+
+        // Done?
+        if (c == '\n') break;
+        if (c == '\r') continue;
+
+        if (length + 1 < size) {
+            line[length++] = c;
+        } else {
+            tooLong = true;
+        }
+    }
+    line[length] = '\0';
+
+    return !tooLong;
+}
+
+void telemetryGetStats(TelemetryStats *stats) {
+    portENTER_CRITICAL(&statsLock_);
+    *stats = stats_;
+    portEXIT_CRITICAL(&statsLock_);
+}
+
+void telemetryDump(void) {
+    TelemetryStats stats;
+    telemetryGetStats(&stats);
+    const int64_t now = esp_timer_get_time();
+
+    // Bandwidth since the last dump
+    const int64_t elapsedUs = now - lastDumpUs_;
+    const uint32_t bytes = stats.bytes - lastDumpStats_.bytes;
+    const uint32_t samples = stats.samples - lastDumpStats_.samples;
+    const uint32_t bytesPerS = elapsedUs > 0 ? (uint32_t) (bytes * 1000000LL / elapsedUs) : 0;
+    const uint32_t samplesPerS = elapsedUs > 0 ? (uint32_t) (samples * 1000000LL / elapsedUs) : 0;
+    lastDumpStats_ = stats;
+    lastDumpUs_ = now;
+
+    // Overhead of the header, the CRC, COBS and the delimiters over the bare samples since the last dump. The
+    // totals wrap around on a long drive, the differences don't
+    const uint64_t sampleBytes = (uint64_t) samples * TELEMETRY_SAMPLE_SIZE;
+    const uint32_t overheadPercent = sampleBytes > 0 && bytes >= sampleBytes ? (uint32_t) (((uint64_t) bytes - sampleBytes) * 100 / sampleBytes) : 0;
+
+    // Logging
+    loggerInfo("Telemetry: %lu frames, %lu samples, %lu bytes, %lu%% overhead, %lu samples/s, %lu B/s, dropped %lu frames with %lu samples",
+               (unsigned long) stats.frames, (unsigned long) stats.samples, (unsigned long) stats.bytes, (unsigned long) overheadPercent,
+               (unsigned long) samplesPerS, (unsigned long) bytesPerS, (unsigned long) stats.droppedFrames, (unsigned long) stats.droppedSamples);
+}
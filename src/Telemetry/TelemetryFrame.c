@@ -0,0 +1,168 @@
+/* --- Includes --- */
+#include "Telemetry/TelemetryFrame.h"
+
+// C includes
+#include <string.h>
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+//! \brief Appends a little endian value to the payload
+//! \param frame The frame
+//! \param value The value
+//! \param size The number of bytes
+static void appendLittleEndian(TelemetryFrame *frame, const uint32_t value, const int size) {
+    for (int i = 0; i < size; i++) {
+        frame->payload[frame->length++] = (uint8_t) (value >> (8 * i));
+    }
+}
+
+//! \brief COBS decodes data, only used by the tests
+//! \param input The encoded data without the delimiters
+//! \param length The number of bytes
+//! \param output At least length bytes
+//! \retval The number of bytes written to output or 0 if the data is invalid
+static size_t cobsDecode(const uint8_t *input, const size_t length, uint8_t *output) {
+    size_t read = 0;
+    size_t written = 0;
+    while (read < length) {
+        const uint8_t code = input[read++];
+        if (code == 0 || read + code - 1 > length) return 0;
+
+        for (int i = 1; i < code; i++) {
+            output[written++] = input[read++];
+        }
+
+        // A code below 0xFF stands for a zero, except at the end
+        if (code < 0xFF && read < length) output[written++] = 0;
+    }
+
+    return written;
+}
+
+/* --- Function implementations --- */
+void telemetryFrameBegin(TelemetryFrame *frame, const uint16_t sequence) {
+    frame->length = 0;
+    frame->count = 0;
+
+    appendLittleEndian(frame, TELEMETRY_FRAME_VERSION, 1);
+    appendLittleEndian(frame, sequence, 2);
+    appendLittleEndian(frame, 0, 1);// The count is set when it is added to
+}
+
+bool telemetryFrameAdd(TelemetryFrame *frame, const SensorSample *sample) {
+    // Is there room left?
+    if (frame->count >= TELEMETRY_MAX_SAMPLES_PER_FRAME) return false;
+
+    appendLittleEndian(frame, sample->id, 1);
+    appendLittleEndian(frame, sample->unit, 1);
+    appendLittleEndian(frame, sample->quality, 1);
+    appendLittleEndian(frame, (uint32_t) sample->timestampUs, 4);// The receiver unwraps it
+    appendLittleEndian(frame, (uint32_t) sample->value, 4);
+    frame->payload[TELEMETRY_HEADER_SIZE - 1] = ++frame->count;
+
+    return true;
+}
+
+size_t telemetryFrameEncode(TelemetryFrame *frame, uint8_t *output) {
+    // The CRC covers the whole payload
+    appendLittleEndian(frame, telemetryCrc16(frame->payload, frame->length), TELEMETRY_CRC_SIZE);
+
+    // A delimiter on both sides, so text written in between can't merge with a frame
+    size_t length = 0;
+    output[length++] = 0;
+    length += telemetryCobsEncode(frame->payload, frame->length, output + length);
+    output[length++] = 0;
+
+    return length;
+}
+
+uint16_t telemetryCrc16(const uint8_t *data, const size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t) data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+size_t telemetryCobsEncode(const uint8_t *input, const size_t length, uint8_t *output) {
+    // Every block starts with the distance to the next zero
+    size_t codeIndex = 0;
+    size_t written = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < length; i++) {
+        if (input[i] != 0) {
+            output[written++] = input[i];
+            code++;
+        }
+
+        // End the block at a zero or once it is full
+        if (input[i] == 0 || code == 0xFF) {
+            output[codeIndex] = code;
+            code = 1;
+            codeIndex = written++;
+
+            // A full block at the very end doesn't need another one
+            if (input[i] != 0 && i + 1 == length) return written - 1;
+        }
+    }
+    output[codeIndex] = code;
+
+    return written;
+}
+
+bool telemetryFrame_test(void) {
+    bool passed = true;
+
+    // Known CRC of "123456789"
+    passed &= telemetryCrc16((const uint8_t *) "123456789", 9) == 0x29B1;
+
+    // COBS round trips: zeros, no zeros and a run longer than a block
+    uint8_t input[300];
+    uint8_t encoded[310];
+    uint8_t decoded[310];
+    const size_t lengths[] = {1, 5, 253, 254, 255, 300};
+    for (int pattern = 0; pattern < 2; pattern++) {
+        for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+            for (size_t j = 0; j < lengths[i]; j++) {
+                input[j] = pattern == 0 ? (uint8_t) (j % 7) : (uint8_t) (j % 255 + 1);
+            }
+            const size_t encodedLength = telemetryCobsEncode(input, lengths[i], encoded);
+            passed &= memchr(encoded, 0, encodedLength) == NULL && encodedLength <= lengths[i] + lengths[i] / 254 + 1;
+            passed &= cobsDecode(encoded, encodedLength, decoded) == lengths[i] && memcmp(input, decoded, lengths[i]) == 0;
+        }
+    }
+
+    // A full frame
+    TelemetryFrame frame;
+    telemetryFrameBegin(&frame, 0x1234);
+    const SensorSample sample = {.id = SENSOR_RPM, .value = -1, .unit = UNIT_RPM, .timestampUs = 0x100000000LL + 42, .quality = 0};
+    while (telemetryFrameAdd(&frame, &sample)) {}
+    uint8_t wire[TELEMETRY_MAX_FRAME_SIZE];
+    const size_t wireLength = telemetryFrameEncode(&frame, wire);
+    passed &= frame.count == TELEMETRY_MAX_SAMPLES_PER_FRAME && wireLength <= TELEMETRY_MAX_FRAME_SIZE;
+    passed &= wire[0] == 0 && wire[wireLength - 1] == 0 && memchr(wire + 1, 0, wireLength - 2) == NULL;
+
+    // Decoded it is the payload again and the CRC over it including the CRC is 0
+    const size_t payloadLength = cobsDecode(wire + 1, wireLength - 2, decoded);
+    passed &= payloadLength == TELEMETRY_MAX_PAYLOAD_SIZE;
+    passed &= decoded[1] == 0x34 && decoded[2] == 0x12 && decoded[3] == TELEMETRY_MAX_SAMPLES_PER_FRAME;
+    passed &= decoded[4] == SENSOR_RPM && decoded[5] == UNIT_RPM && decoded[7] == 42 && decoded[10] == 0 && decoded[11] == 0xFF;
+    const uint16_t crc = telemetryCrc16(decoded, payloadLength - TELEMETRY_CRC_SIZE);
+    passed &= decoded[payloadLength - 2] == (crc & 0xFF) && decoded[payloadLength - 1] == crc >> 8;
+
+    // Logging
+    if (passed) {
+        loggerInfo("Telemetry frame tests passed");
+    } else {
+        loggerError("Telemetry frame tests FAILED");
+    }
+
+    return passed;
+}
@@ -1,29 +1,96 @@
 /* Includes */
 
 // Project
+#include "BootProfiler/BootProfiler.h"
 #include "Core/Core.h"
 #include "FileManager/FileManager.h"
 #include "GUI/GUI.h"
 #include "Logger/Logger.h"
+#include "SensorManager/AdcCalibration.h"
 #include "SensorManager/SensorManager.h"
+#include "Settings/Settings.h"
 
-void app_main(void) {
-    // Initialize FileManager
-    const bool fileManagerInitResult = fileManagerInit();
-    if (fileManagerInitResult) {
+// espidf
+#include <esp_timer.h>
+#include <nvs_flash.h>
+
+// Stacks of the boot phases, LVGL needs more to build the screens
+#define BOOT_PHASE_STACK_SIZE 4096
+#define BOOT_LVGL_STACK_SIZE 8192
+
+// The boot phases, their index in bootPhases_
+enum {
+    BOOT_SD_CARD,
+    BOOT_SPIFFS,
+    BOOT_LOGGER,
+    BOOT_NVS,
+    BOOT_SETTINGS,
+    BOOT_SETTINGS_FILE,
+    BOOT_SENSOR_MANAGER,
+    BOOT_DISPLAYS,
+    BOOT_SCREENS,
+    BOOT_GUI,
+    BOOT_CORE,
+    BOOT_PHASE_COUNT,
+};
+
+//! \brief Initializes the NVS, it is erased if it is full or from a newer version
+//! \retval Boolean indicating if it worked
+static bool initNvs(void) {
+    esp_err_t result = nvs_flash_init();
+    if (result == ESP_ERR_NVS_NO_FREE_PAGES || result == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        // Logging
+        loggerWarn("NVS is full or from a newer version, erasing it");
+
+        nvs_flash_erase();
+        result = nvs_flash_init();
+    }
+
+    if (result == ESP_OK) {
         // Logging
-        loggerInfo("FileManager initialized");
+        loggerInfo("NVS initialized");
     } else {
         // Logging
-        loggerError("Couldn't initialize FileManager");
+        loggerError("Couldn't initialize the NVS, calibrations will not be stored");
     }
 
-    // Initialize Logger
+    return result == ESP_OK;
+}
+
+//! \brief Opens the log files
+//! \retval true, the logger works without them as well
+static bool initLogger(void) {
     loggerInit();
 
-    // Initialize SensorManager
-    const bool sensorManagerInitResult = sensorManagerInit();
-    if (sensorManagerInitResult) {
+    return true;
+}
+
+//! \brief Loads the settings, everything below is initialized with them
+//! \retval true, the defaults are used if there are no stored ones
+static bool initSettings(void) {
+    settingsInit();
+    loggerSetLevel(settingsGet(SETTING_LOGGING_LEVEL));
+
+    return true;
+}
+
+//! \brief Applies the override file on the SD card. Values which are only read at the initialization
+//! take effect from the next boot on
+//! \retval true, the file is optional
+static bool initSettingsFile(void) {
+    settingsReloadOverrideFile();
+
+    return true;
+}
+
+//! \brief Initializes the SensorManager
+//! \retval Boolean indicating if it works, at least partially
+static bool initSensorManager(void) {
+    // The channels which come from the CAN bus
+    sensorManagerSetCanChannels(settingsGet(SETTING_CAN_CHANNELS));
+
+    const int result = sensorManagerInit();
+    if (result) {
         // Logging
         loggerInfo("SensorManager initialized");
     } else {
@@ -31,21 +98,47 @@ void app_main(void) {
         loggerError("Couldn't initialize SensorManager");
     }
 
-    // Initialize the GUI system
-    if (guiInit()) {
-        // Logging
-        loggerInfo("GUI system initialized");
-    } else {
+    return result != 0;
+}
+
+// The SD card, the ADC and the SPI bus don't depend on each other, so they are initialized on both cores at
+// once. The SensorManager installs its interrupts on the acquisition core, everything LVGL does stays on the GUI core.
+// The NVS and the settings don't wait for the logger on purpose: the displays need the settings, so waiting would put
+// the SD card mount in front of the dashboard. Their lines only go to the console. The SensorManager waits for the
+// SD card anyway, so it waits for the log files as well
+static const BootPhase bootPhases_[BOOT_PHASE_COUNT] = {
+        [BOOT_SD_CARD] = {"SD card", fileManagerMountSdCard, 0, 1, BOOT_PHASE_STACK_SIZE, false},
+        [BOOT_SPIFFS] = {"SPIFFS", fileManagerMountSpiffs, 0, 0, BOOT_PHASE_STACK_SIZE, false},
+        [BOOT_LOGGER] = {"Logger", initLogger, BOOT_PHASE(BOOT_SD_CARD) | BOOT_PHASE(BOOT_SPIFFS), 1, BOOT_PHASE_STACK_SIZE, false},
+        [BOOT_NVS] = {"NVS", initNvs, 0, 0, BOOT_PHASE_STACK_SIZE, false},
+        [BOOT_SETTINGS] = {"Settings", initSettings, BOOT_PHASE(BOOT_NVS), 0, BOOT_PHASE_STACK_SIZE, true},
+        [BOOT_SETTINGS_FILE] = {"Settings file", initSettingsFile, BOOT_PHASE(BOOT_SETTINGS) | BOOT_PHASE(BOOT_SD_CARD), 1, BOOT_PHASE_STACK_SIZE, false},
+        [BOOT_SENSOR_MANAGER] = {"SensorManager", initSensorManager, BOOT_PHASE(BOOT_SETTINGS_FILE) | BOOT_PHASE(BOOT_LOGGER), ACQUISITION_CORE, BOOT_PHASE_STACK_SIZE, false},
+        [BOOT_DISPLAYS] = {"Displays", guiInitDisplays, BOOT_PHASE(BOOT_SETTINGS), GUI_CORE, BOOT_PHASE_STACK_SIZE, true},
+        [BOOT_SCREENS] = {"Screens", guiInitScreens, 0, GUI_CORE, BOOT_LVGL_STACK_SIZE, true},
+        [BOOT_GUI] = {"GUI", guiStart, BOOT_PHASE(BOOT_DISPLAYS) | BOOT_PHASE(BOOT_SCREENS), GUI_CORE, BOOT_PHASE_STACK_SIZE, true},
+        [BOOT_CORE] = {"Core", coreInit, BOOT_PHASE(BOOT_CORE) - 1, 0, BOOT_PHASE_STACK_SIZE, true},
+};
+
+void app_main(void) {
+    // Initialize everything, independent phases run in parallel
+    const bool bootResult = bootProfilerRun(bootPhases_, BOOT_PHASE_COUNT);
+
+    // Logging
+    int64_t adcCalibrationUs = 0;
+    int64_t adcCalibrationSavedUs = 0;
+    adcCalibrationGetBootTime(&adcCalibrationUs, &adcCalibrationSavedUs);
+    bootProfilerDump();
+    loggerInfo("Boot time: ADC calibration %lld us, saved %lld us", adcCalibrationUs, adcCalibrationSavedUs);
+
+    if (!bootResult) {
         // Logging
-        loggerCritical("Couldn't initialize GUI system");
+        loggerCritical("Couldn't initialize the GUI system or the Core");
 
         // Return, as there is no use in continuing
         return;
     }
 
-    // Initialize the Core
-    coreInit();
-
     while (true) {
         // TESTING ONLY
         //sensorManagerUpdateFuelLevel();
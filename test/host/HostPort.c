@@ -0,0 +1,204 @@
+/* --- Includes --- */
+// C includes
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+// Project includes
+#include "Logger/Logger.h"
+
+// Shims
+#include <esp_cpu.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+/* --- Private Defines & Macros --- */
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// Taken by every critical section
+static pthread_mutex_t criticalLock_;
+static pthread_once_t criticalLockOnce_ = PTHREAD_ONCE_INIT;
+
+// What a thread runs
+typedef struct {
+    TaskFunction_t function;
+    void *parameters;
+} TaskStart;
+
+static int loggingLevel_ = LOGGING_LEVEL;
+
+//! \brief Returns the monotonic clock
+//! \retval The time [in ns]
+static int64_t getTimeNs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (int64_t) now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+//! \brief Creates the recursive critical section lock, a critical section may call a function which takes it again
+static void createCriticalLock(void) {
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&criticalLock_, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+}
+
+//! \brief Runs a task function on its thread
+static void *runTask(void *start) {
+    const TaskStart task = *(TaskStart *) start;
+    free(start);
+
+    task.function(task.parameters);
+
+    return NULL;
+}
+
+//! \brief Prints a message if its level is logged
+static void logMessage(const int level, const char *prefix, const char *message, va_list args) {
+    if (level > loggingLevel_) return;
+
+    printf("%s", prefix);
+    vprintf(message, args);
+    printf("\n");
+    fflush(stdout);
+}
+
+/* --- Function implementations --- */
+
+// FreeRTOS
+void portENTER_CRITICAL(portMUX_TYPE *mux) {
+    (void) mux;
+    pthread_once(&criticalLockOnce_, createCriticalLock);
+    pthread_mutex_lock(&criticalLock_);
+}
+
+void portEXIT_CRITICAL(portMUX_TYPE *mux) {
+    (void) mux;
+    pthread_mutex_unlock(&criticalLock_);
+}
+
+BaseType_t xTaskCreatePinnedToCore(const TaskFunction_t function, const char *name, const uint32_t stackDepth, void *parameters, const UBaseType_t priority,
+                                   TaskHandle_t *handle, const BaseType_t core) {
+    TaskStart *start = malloc(sizeof(TaskStart));
+    if (start == NULL) return pdFAIL;
+    *start = (TaskStart) {function, parameters};
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, runTask, start) != 0) {
+        free(start);
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+
+    if (handle != NULL) *handle = (TaskHandle_t) start;
+    return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(const TaskFunction_t function, const char *name, const uint32_t stackDepth, void *parameters, const UBaseType_t priority,
+                                           StackType_t *stack, StaticTask_t *buffer, const BaseType_t core) {
+    TaskHandle_t handle = NULL;
+    if (xTaskCreatePinnedToCore(function, name, stackDepth, parameters, priority, &handle, core) != pdPASS) return NULL;
+
+    return handle;
+}
+
+void vTaskDelete(const TaskHandle_t task) {
+    // Only a task deleting itself is supported
+    if (task == NULL) pthread_exit(NULL);
+}
+
+void vTaskDelay(const TickType_t ticks) {
+    usleep((useconds_t) ticks * portTICK_PERIOD_MS * 1000);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t) (getTimeNs() / 1000000LL / portTICK_PERIOD_MS);
+}
+
+UBaseType_t uxTaskPriorityGet(const TaskHandle_t task) {
+    return 1;
+}
+
+BaseType_t xPortGetCoreID(void) {
+    return 0;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer) {
+    pthread_mutex_init(&buffer->mutex, NULL);
+
+    return buffer;
+}
+
+BaseType_t xSemaphoreTake(const SemaphoreHandle_t semaphore, const TickType_t ticks) {
+    if (ticks == portMAX_DELAY) return pthread_mutex_lock(&semaphore->mutex) == 0 ? pdTRUE : pdFALSE;
+
+    // The timeout of a POSIX mutex is an absolute time on the realtime clock
+    struct timespec timeout;
+    clock_gettime(CLOCK_REALTIME, &timeout);
+    const int64_t timeoutNs = timeout.tv_nsec + (int64_t) ticks * portTICK_PERIOD_MS * 1000000LL;
+    timeout.tv_sec += timeoutNs / 1000000000LL;
+    timeout.tv_nsec = timeoutNs % 1000000000LL;
+
+    return pthread_mutex_timedlock(&semaphore->mutex, &timeout) == 0 ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(const SemaphoreHandle_t semaphore) {
+    return pthread_mutex_unlock(&semaphore->mutex) == 0 ? pdTRUE : pdFALSE;
+}
+
+// ESP-IDF
+int64_t esp_timer_get_time(void) {
+    return getTimeNs() / 1000;
+}
+
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void) {
+    return (esp_cpu_cycle_count_t) getTimeNs();
+}
+
+// Logger
+void loggerInit(void) {
+}
+
+void loggerSetLevel(const int level) {
+    loggingLevel_ = level;
+}
+
+int loggerGetLevel(void) {
+    return loggingLevel_;
+}
+
+void loggerInfo(const char *message, ...) {
+    va_list args;
+    va_start(args, message);
+    logMessage(4, "[INFO] ", message, args);
+    va_end(args);
+}
+
+void loggerWarn(const char *message, ...) {
+    va_list args;
+    va_start(args, message);
+    logMessage(3, "[WARNING] ", message, args);
+    va_end(args);
+}
+
+void loggerError(const char *message, ...) {
+    va_list args;
+    va_start(args, message);
+    logMessage(2, "[ERROR] ", message, args);
+    va_end(args);
+}
+
+void loggerCritical(const char *message, ...) {
+    va_list args;
+    va_start(args, message);
+    logMessage(1, "[CRITICAL] ", message, args);
+    va_end(args);
+}
@@ -0,0 +1,208 @@
+/* --- Includes --- */
+// C includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Project includes
+#include "Core/ThermalLevel.h"
+#include "Logger/Logger.h"
+#include "SensorManager/CanBus.h"
+#include "SensorManager/CanSignals.h"
+#include "SensorManager/SensorHal.h"
+#include "SensorManager/SensorManager.h"
+#include "Telemetry/TelemetryFrame.h"
+
+/* --- Private Defines & Macros --- */
+
+// Step of the virtual clock of the candump replay test
+#define CANDUMP_TEST_STEP_US (50 * 1000LL)
+
+// Length, step and edge periods of the sensor replay test: 100Hz speed signal (100km/h at 3600 pulses per km),
+// 92Hz rpm signal (3000rpm)
+#define REPLAY_TEST_DURATION_US (2000 * 1000LL)
+#define REPLAY_TEST_STEP_US (100 * 1000LL)
+#define REPLAY_TEST_SPEED_PERIOD_US 10000
+#define REPLAY_TEST_RPM_PERIOD_US 10870
+
+/* --- Private Variables, Typedefs etc. --- */
+
+// A test, it is run by its name
+typedef struct {
+    const char *name;
+    bool (*run)(void);
+} HostTest;
+
+//! \brief Replays a candump log through the SensorManager: the channels from the bus follow the log on the virtual clock
+//! \retval Boolean indicating if it passed
+static bool candumpReplay_test(void) {
+    // 3000 rpm, 2000 rpm 100ms later and 100.0 km/h after another 100ms, a frame of an unknown id in between
+    static const char *log = "# candump -l\n"
+                             "(1700000000.000000) can0 360#B80B\n"
+                             "(1700000000.050000) can0 123#DEADBEEF\n"
+                             "(1700000000.100000) can0 360#D007\n"
+                             "(1700000000.200000) can0 370#E803\n";
+
+    char path[] = "/tmp/candumpXXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) return false;
+    bool passed = write(fd, log, strlen(log)) == (ssize_t) strlen(log);
+    close(fd);
+
+    // The generator only provides the virtual clock, all of its inputs stay silent
+    const SensorHalGeneratorConfig config = {.seed = 1};
+    sensorHalGeneratorConfigure(&config);
+    passed &= sensorHalSelect(&sensorHalGenerator);
+    passed &= canBusCandumpOpen(path) && canBusSelect(&canBusCandump);
+    sensorManagerSetCanChannels(CAN_CHANNEL_BIT(CAN_CHANNEL_RPM) | CAN_CHANNEL_BIT(CAN_CHANNEL_SPEED));
+    passed &= sensorManagerInit() == 1 && sensorManagerUsesCan();
+
+    // Expected after every step, -1 until the first frame of a channel was received
+    static const int expectedRpm[] = {3000, 3000, 2000, 2000, 2000, 2000};
+    static const int expectedSpeed[] = {-1, -1, -1, -1, 100, 100};
+    for (int step = 0; step < (int) (sizeof(expectedRpm) / sizeof(expectedRpm[0])); step++) {
+        sensorHalAdvanceTo(step * CANDUMP_TEST_STEP_US);
+
+        // Every due frame, a receive returns false once none is due on the virtual clock
+        for (int i = 0; i < 4; i++) {
+            sensorManagerUpdateCan();
+        }
+        sensorManagerUpdateRPM();
+        sensorManagerUpdateSpeed();
+
+        passed &= sensorManagerGetRPM() == expectedRpm[step] && sensorManagerGetSpeed() == expectedSpeed[step];
+    }
+
+    canBusCandumpClose();
+    unlink(path);
+
+    // Logging
+    if (passed) {
+        loggerInfo("Candump replay tests passed");
+    } else {
+        loggerError("Candump replay tests FAILED");
+    }
+
+    return passed;
+}
+
+//! \brief Replays a recording of edges and voltages through the SensorManager on the replay backend
+//! \retval Boolean indicating if it passed
+static bool replay_test(void) {
+    char path[] = "/tmp/replayXXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) return false;
+    FILE *file = fdopen(fd, "w");
+    if (file == NULL) {
+        close(fd);
+        unlink(path);
+        return false;
+    }
+
+    // Oil pressure switch closed (150mV), 25.0 degree Celsius inside, 30.0 degree Celsius after half of the recording,
+    // the edges of both pulse inputs in between
+    fprintf(file, "# Recorded on the bench\n");
+    fprintf(file, "0 A %d 150\n", SENSOR_HAL_ADC_OIL_PRESSURE);
+    fprintf(file, "0 A %d 790\n", SENSOR_HAL_ADC_INT_TEMPERATURE);
+    int64_t speedEdgeUs = REPLAY_TEST_SPEED_PERIOD_US;
+    int64_t rpmEdgeUs = REPLAY_TEST_RPM_PERIOD_US;
+    bool temperatureChanged = false;
+    while (speedEdgeUs <= REPLAY_TEST_DURATION_US || rpmEdgeUs <= REPLAY_TEST_DURATION_US) {
+        const int64_t timeUs = speedEdgeUs < rpmEdgeUs ? speedEdgeUs : rpmEdgeUs;
+        if (!temperatureChanged && timeUs >= REPLAY_TEST_DURATION_US / 2) {
+            fprintf(file, "%lld A %d 840\n", REPLAY_TEST_DURATION_US / 2, SENSOR_HAL_ADC_INT_TEMPERATURE);
+            temperatureChanged = true;
+        }
+
+        if (speedEdgeUs == timeUs) {
+            fprintf(file, "%lld E %d\n", (long long) timeUs, SENSOR_HAL_PULSE_SPEED);
+            speedEdgeUs += REPLAY_TEST_SPEED_PERIOD_US;
+        }
+        if (rpmEdgeUs == timeUs) {
+            fprintf(file, "%lld E %d\n", (long long) timeUs, SENSOR_HAL_PULSE_RPM);
+            rpmEdgeUs += REPLAY_TEST_RPM_PERIOD_US;
+        }
+    }
+    bool passed = fclose(file) == 0;
+
+    passed &= sensorHalReplayOpen(path) && sensorHalSelect(&sensorHalReplay);
+    sensorManagerSetCanChannels(0);
+    passed &= sensorManagerInit() == 1;
+    sensorManagerSetGearEstimation(true);
+
+    // The signals follow the recording on the virtual clock, the first step only starts the measurements
+    const int expectedSpeed = fixedPointScale(100, 3600, ODOMETER_PULSES_PER_KM);
+    bool more = true;
+    for (int64_t timeUs = REPLAY_TEST_STEP_US; timeUs <= REPLAY_TEST_DURATION_US; timeUs += REPLAY_TEST_STEP_US) {
+        more = sensorHalAdvanceTo(timeUs);
+
+        sensorManagerUpdateOilPressure();
+        sensorManagerUpdateInternalTemperature();
+        sensorManagerUpdateSpeed();
+        sensorManagerUpdateRPM();
+        sensorManagerUpdateShiftLight(SHIFT_LIGHT_DEFAULT_LEAD_US);
+        if (timeUs == REPLAY_TEST_STEP_US) continue;
+
+        const int speed = sensorManagerGetSpeed();
+        const int rpm = sensorManagerGetRPM();
+        passed &= speed >= expectedSpeed - 1 && speed <= expectedSpeed + 1;
+        passed &= rpm >= 2990 && rpm <= 3010;
+        passed &= sensorManagerHasOilPressure();
+        passed &= sensorManagerGetInternalTemperature() == (timeUs < REPLAY_TEST_DURATION_US / 2 ? 250 : 300);
+    }
+
+    // The rpm edges classified the gear, 3000rpm at 100km/h matches none of them
+    passed &= sensorManagerGetGear() == GEAR_CLUTCH;
+
+    // Everything was delivered
+    passed &= !more;
+
+    sensorHalReplayClose();
+    unlink(path);
+
+    // Logging
+    if (passed) {
+        loggerInfo("Sensor replay tests passed");
+    } else {
+        loggerError("Sensor replay tests FAILED");
+    }
+
+    return passed;
+}
+
+// Every test, CMakeLists.txt has to list it as well
+static const HostTest tests_[] = {
+        {"pwl", pwl_test},
+        {"fixedPoint", fixedPoint_test},
+        {"gearEstimator", gearEstimator_test},
+        {"digitalInputs", digitalInputs_test},
+        {"edgeSnapshot", edgeSnapshot_test},
+        {"odometer", odometer_test},
+        {"shiftLight", shiftLight_test},
+        {"telemetryFrame", telemetryFrame_test},
+        {"sensorManager", sensorManager_test},
+        {"canDecoder", canDecoder_test},
+        {"candumpReplay", candumpReplay_test},
+        {"replay", replay_test},
+        {"thermalLevel", thermalLevel_test},
+};
+
+/* --- Function implementations --- */
+int main(const int argc, const char **argv) {
+    const int testCount = (int) (sizeof(tests_) / sizeof(tests_[0]));
+
+    // The modules keep their state, so every process runs one test
+    if (argc == 2) {
+        for (int i = 0; i < testCount; i++) {
+            if (strcmp(argv[1], tests_[i].name) == 0) return tests_[i].run() ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    printf("Usage: %s <test>, the tests are:\n", argv[0]);
+    for (int i = 0; i < testCount; i++) {
+        printf("  %s\n", tests_[i].name);
+    }
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,6 @@
+/* --- Host shim: the FileManager is not part of the host build --- */
+#pragma once
+
+// Like the real header, it brings the attributes and the error codes
+#include "esp_attr.h"
+#include "esp_err.h"
@@ -0,0 +1,6 @@
+/* --- Host shim: there is no IRAM or DRAM on the host --- */
+#pragma once
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define EXT_RAM_BSS_ATTR
@@ -0,0 +1,9 @@
+/* --- Host shim: esp_timer_get_time() on the monotonic clock --- */
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_attr.h"
+#include "esp_err.h"
+
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,6 @@
+/* --- Host shim: the declarations only, no module of the host build creates a queue --- */
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct QueueDefinition *QueueHandle_t;
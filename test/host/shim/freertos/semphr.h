@@ -0,0 +1,15 @@
+/* --- Host shim: only mutexes, a mutex is a POSIX mutex kept in the static buffer --- */
+#pragma once
+
+#include <pthread.h>
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct {
+    pthread_mutex_t mutex;
+} StaticSemaphore_t;
+typedef StaticSemaphore_t *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
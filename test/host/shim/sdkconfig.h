@@ -0,0 +1,5 @@
+/* --- Host build configuration, the firmware is built for the Linux target --- */
+#pragma once
+
+#define CONFIG_IDF_TARGET_LINUX 1
+#define CONFIG_FREERTOS_HZ 100
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""RAM budget report of a build, taken from the linker map file.
+
+Sums the internal DRAM (.dram0.data, .dram0.bss, .noinit) and the PSRAM (.ext_ram.bss, .ext_ram_noinit) every
+module occupies. A module is a directory of src/ (an object of the firmware component is matched to its source
+file by name) or a library outside of it, e.g. lvgl or freertos. Heap allocations don't show up in the map, so
+with CONFIG_FIRMWARE_STATIC_ALLOCATION the report covers the task stacks and the draw buffers as well.
+
+The budgets come from memory_budget.csv, one line per module: module, DRAM [bytes], PSRAM [bytes]. An empty
+field means no budget, "total" limits the sum of everything. Exceeding a budget fails the build.
+
+Usage:
+    memory_budget.py build/firmware.map [--budget memory_budget.csv] [--top 10]
+"""
+import argparse
+import csv
+import os
+import re
+import sys
+from collections import defaultdict
+
+DRAM_SECTIONS = ('.dram0.data', '.dram0.bss', '.noinit')
+PSRAM_SECTIONS = ('.ext_ram.bss', '.ext_ram_noinit')
+
+# Library of the firmware itself, its objects are split up by the directories of src/
+FIRMWARE_COMPONENT = 'src'
+
+# "<name> <address> <size> <file>", the name may be on the line before if it is long
+INPUT_SECTION = re.compile(r'^ (\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S.*))?$')
+INPUT_SECTION_NAME = re.compile(r'^ (\S+)$')
+ARCHIVE_MEMBER = re.compile(r'^(.*?)([^/\\]+)\.a\((.+)\)$')
+
+
+def source_modules(root):
+    """Maps the file names of the firmware sources to their module, e.g. "Core.c" to "Core"."""
+    modules = {}
+    for top in ('src', 'res'):
+        for directory, subdirectories, files in os.walk(os.path.join(root, top)):
+            subdirectories[:] = [d for d in subdirectories if d != 'lvgl']
+            relative = os.path.relpath(directory, os.path.join(root, top))
+            for name in files:
+                if name.endswith('.c'):
+                    modules[name] = top if top == 'res' else relative.split(os.sep)[0] if relative != '.' else name[:-2]
+    return modules
+
+
+def module_of(file, modules):
+    """The module an input file of the linker belongs to."""
+    member = ARCHIVE_MEMBER.match(file.strip())
+    if member is None:
+        return os.path.basename(file.strip())
+
+    library, object_name = member.group(2), member.group(3)
+    library = library[3:] if library.startswith('lib') else library
+    if library == FIRMWARE_COMPONENT:
+        source = object_name[:-len('.obj')] if object_name.endswith('.obj') else object_name
+        return modules.get(source, FIRMWARE_COMPONENT)
+    return library
+
+
+def parse_map(path, modules):
+    """Returns {module: [dram, psram]} of the RAM sections in the map file."""
+    usage = defaultdict(lambda: [0, 0])
+    in_memory_map = False
+    output_section = None
+    pending_name = None
+
+    with open(path, encoding='utf-8', errors='replace') as file:
+        for line in file:
+            line = line.rstrip()
+
+            # The discarded sections before the memory map look the same, they don't count
+            if not in_memory_map:
+                in_memory_map = line.startswith('Linker script and memory map')
+                continue
+
+            # An output section starts at the beginning of the line
+            if line.startswith('.'):
+                output_section = line.split()[0]
+                pending_name = None
+                continue
+
+            if output_section in DRAM_SECTIONS:
+                index = 0
+            elif output_section in PSRAM_SECTIONS:
+                index = 1
+            else:
+                continue
+
+            match = INPUT_SECTION.match(line)
+            if match is None:
+                name = INPUT_SECTION_NAME.match(line)
+                pending_name = name.group(1) if name else None
+                continue
+
+            name = match.group(1) or pending_name
+            pending_name = None
+            size = int(match.group(3), 16)
+            if name is None or size == 0:
+                continue
+
+            # Alignment gaps are listed on their own
+            if name == '*fill*':
+                module = '(alignment)'
+            elif match.group(4) is not None:
+                module = module_of(match.group(4), modules)
+            else:
+                continue
+            usage[module][index] += size
+
+    if not in_memory_map:
+        raise ValueError(f'{path} is no GNU ld map file')
+    return usage
+
+
+def read_budgets(path):
+    """Returns {module: [dram or None, psram or None]}."""
+    budgets = {}
+    with open(path, newline='') as file:
+        for row in csv.reader(line for line in file if line.strip() and not line.lstrip().startswith('#')):
+            row = [field.strip() for field in row] + ['', '']
+            budgets[row[0]] = [int(row[1], 0) if row[1] else None, int(row[2], 0) if row[2] else None]
+    return budgets
+
+
+def kib(size):
+    return f'{size / 1024:8.1f}'
+
+
+def report(usage, budgets, modules, top):
+    """Prints the table and returns the modules over budget."""
+    firmware_modules = set(modules.values()) | {FIRMWARE_COMPONENT}
+    total = [sum(dram for dram, _ in usage.values()), sum(psram for _, psram in usage.values())]
+
+    # The firmware modules, the largest others and whatever has a budget are listed, the rest is summed up
+    firmware = sorted((m for m in usage if m in firmware_modules), key=lambda m: -sum(usage[m]))
+    others = sorted((m for m in usage if m not in firmware_modules), key=lambda m: -usage[m][0])
+    listed = [m for m in others if m in budgets or others.index(m) < top]
+    rest = [sum(usage[m][i] for m in others if m not in listed) for i in (0, 1)]
+
+    over = []
+    print(f'{"Module":<24}{"DRAM KiB":>10}{"budget":>10}{"PSRAM KiB":>11}{"budget":>10}')
+    print('-' * 65)
+
+    def row(name, values, limits=(None, None)):
+        cells = []
+        for value, limit in zip(values, limits):
+            cells += [kib(value), '-' if limit is None else kib(limit)]
+            if limit is not None and value > limit:
+                over.append(name)
+        mark = '  over budget' if name in over else ''
+        print(f'{name:<24}{cells[0]:>10}{cells[1]:>10}{cells[2]:>11}{cells[3]:>10}{mark}')
+
+    for name in firmware:
+        row(name, usage[name], budgets.get(name, (None, None)))
+    print('-' * 65)
+    for name in listed:
+        row(name, usage[name], budgets.get(name, (None, None)))
+    if any(rest):
+        row(f'({len(others) - len(listed)} others)', rest)
+    print('-' * 65)
+    row('total', total, budgets.get('total', (None, None)))
+
+    for name in budgets:
+        if name != 'total' and name not in usage:
+            print(f'warning: the budget of "{name}" matches no module', file=sys.stderr)
+    return sorted(set(over))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('map', help='linker map file, build/firmware.map')
+    parser.add_argument('--budget', help='budget file, no check without it')
+    parser.add_argument('--top', type=int, default=10, help='libraries outside of the firmware listed on their own')
+    args = parser.parse_args()
+
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    modules = source_modules(root)
+    budgets = read_budgets(args.budget) if args.budget else {}
+    over = report(parse_map(args.map, modules), budgets, modules, args.top)
+
+    if over:
+        print(f'error: over the RAM budget: {", ".join(over)} (see {args.budget})', file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
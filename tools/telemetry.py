@@ -0,0 +1,316 @@
+#!/usr/bin/env python3
+"""Decoder and benchmark for the binary telemetry stream of the dashboard.
+
+The firmware sends every sensor sample over USB-Serial-JTAG in COBS encoded frames, enclosed by 0x00
+delimiters. The text log shares the port, it ends up between the frames. Layout of a frame before the
+COBS encoding, everything little endian (see include/Telemetry/TelemetryFrame.h):
+
+    version (1), sequence (2), sample count (1), samples, CRC-16/CCITT-FALSE over everything before (2)
+    sample: sensor (1), unit (1), quality (1), lower 32 bit of the timestamp [us] (4), value (4)
+
+Usage:
+    telemetry.py decode /dev/ttyACM0 -o samples.csv    Decode a port (needs pyserial) or a capture file
+    telemetry.py capture /dev/ttyACM0 -o capture.bin   Record the raw stream for later
+    telemetry.py benchmark [--capture capture.bin]     Bytes per sample, overhead and decoder speed
+    telemetry.py send /dev/ttyACM0 rpm_min_ms=200      Console command: [save ]name=value, reload, erase, trim or test
+"""
+import argparse
+import csv
+import struct
+import sys
+import time
+
+FRAME_VERSION = 1
+HEADER = struct.Struct('<BHB')
+SAMPLE = struct.Struct('<BBBIi')
+CRC_SIZE = 2
+MAX_SAMPLES_PER_FRAME = 16
+
+# SENSOR of SensorManager.h, in order
+SENSORS = [
+    'Oil pressure', 'Fuel level percent', 'Fuel level litre', 'Water temperature', 'Internal temperature', 'Speed', 'RPM',
+    'Gear', 'Left blinker', 'Right blinker', 'Blinker pattern', 'Button 1', 'Button 2', 'Button 3', 'Shift light',
+    'Odometer', 'Trip',
+]
+
+# SENSOR_UNIT of SensorManager.h, in order
+UNITS = ['', 'bool', '%', 'l', '0.1 C', 'km/h', 'rpm', 'gear', 'pattern', 'm']
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, polynomial 0x1021, initial value 0xFFFF."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    output = bytearray([0])
+    code_index = 0
+    code = 1
+    for i, byte in enumerate(data):
+        if byte != 0:
+            output.append(byte)
+            code += 1
+        if byte == 0 or code == 0xFF:
+            output[code_index] = code
+            code = 1
+            if byte != 0 and i + 1 == len(data):
+                return bytes(output)
+            code_index = len(output)
+            output.append(0)
+    output[code_index] = code
+    return bytes(output)
+
+
+def cobs_decode(data):
+    """Returns the decoded data or None if it isn't valid COBS."""
+    output = bytearray()
+    index = 0
+    while index < len(data):
+        code = data[index]
+        index += 1
+        if code == 0 or index + code - 1 > len(data):
+            return None
+        output += data[index:index + code - 1]
+        index += code - 1
+        if code < 0xFF and index < len(data):
+            output.append(0)
+    return bytes(output)
+
+
+def encode_frame(sequence, samples):
+    """Encodes a frame like the firmware, samples are (sensor, unit, quality, timestamp_us, value) tuples."""
+    payload = HEADER.pack(FRAME_VERSION, sequence & 0xFFFF, len(samples))
+    for sensor, unit, quality, timestamp_us, value in samples:
+        payload += SAMPLE.pack(sensor, unit, quality, timestamp_us & 0xFFFFFFFF, value)
+    payload += struct.pack('<H', crc16(payload))
+    return b'\x00' + cobs_encode(payload) + b'\x00'
+
+
+def parse_frame(payload):
+    """Returns (sequence, samples) or None if it isn't a valid frame."""
+    if len(payload) < HEADER.size + CRC_SIZE or crc16(payload[:-CRC_SIZE]) != struct.unpack_from('<H', payload, len(payload) - CRC_SIZE)[0]:
+        return None
+    version, sequence, count = HEADER.unpack_from(payload)
+    if version != FRAME_VERSION or len(payload) != HEADER.size + count * SAMPLE.size + CRC_SIZE:
+        return None
+    samples = [SAMPLE.unpack_from(payload, HEADER.size + i * SAMPLE.size) for i in range(count)]
+    return sequence, samples
+
+
+class Decoder:
+    """Splits the stream at the delimiters, checks the frames and unwraps the timestamps."""
+
+    def __init__(self, on_sample, on_text):
+        self.on_sample = on_sample
+        self.on_text = on_text
+        self.buffer = bytearray()
+        self.next_sequence = None
+        self.latest_timestamp = None
+        self.frames = 0
+        self.samples = 0
+        self.lost_frames = 0
+        self.corrupt_frames = 0
+        self.frame_bytes = 0
+        self.text_bytes = 0
+
+    def feed(self, data):
+        self.buffer += data
+        *chunks, self.buffer = self.buffer.split(b'\x00')
+        for chunk in chunks:
+            if chunk:
+                self._chunk(bytes(chunk))
+
+    def _chunk(self, chunk):
+        payload = cobs_decode(chunk)
+        frame = parse_frame(payload) if payload is not None else None
+        if frame is None:
+            # Text of the log, or a frame which was damaged on the way
+            try:
+                text = chunk.decode('ascii')
+                if text.strip('\r\n\t').isprintable():
+                    self.text_bytes += len(chunk)
+                    self.on_text(text)
+                    return
+            except UnicodeDecodeError:
+                pass
+            self.corrupt_frames += 1
+            return
+
+        sequence, samples = frame
+        if self.next_sequence is not None:
+            self.lost_frames += (sequence - self.next_sequence) & 0xFFFF
+        self.next_sequence = (sequence + 1) & 0xFFFF
+        self.frames += 1
+        self.frame_bytes += len(chunk) + 2
+
+        for sensor, unit, quality, timestamp, value in samples:
+            # The samples of a frame aren't strictly ordered, so the difference to the latest one is signed
+            if self.latest_timestamp is None:
+                self.latest_timestamp = timestamp
+            delta = ((timestamp - self.latest_timestamp + (1 << 31)) & 0xFFFFFFFF) - (1 << 31)
+            timestamp_us = self.latest_timestamp + delta
+            self.latest_timestamp = max(self.latest_timestamp, timestamp_us)
+            self.samples += 1
+            self.on_sample(sequence, sensor, unit, quality, timestamp_us, value)
+
+
+def open_source(path):
+    """A serial port or a capture file."""
+    if path.startswith('/dev/') or path.upper().startswith('COM'):
+        import serial
+        return serial.Serial(path, timeout=0.1)
+    return open(path, 'rb')
+
+
+def decode(args):
+    output = open(args.output, 'w', newline='') if args.output else sys.stdout
+    writer = csv.writer(output)
+    writer.writerow(['sequence', 'sensor', 'timestamp_us', 'value', 'unit', 'quality'])
+
+    def on_sample(sequence, sensor, unit, quality, timestamp_us, value):
+        name = SENSORS[sensor] if sensor < len(SENSORS) else str(sensor)
+        writer.writerow([sequence, name, timestamp_us, value, UNITS[unit] if unit < len(UNITS) else unit, f'0x{quality:02x}'])
+
+    decoder = Decoder(on_sample, lambda text: None if args.quiet else sys.stderr.write(text))
+    source = open_source(args.source)
+    try:
+        while True:
+            data = source.read(4096)
+            if not data:
+                if hasattr(source, 'port'):
+                    continue
+                break
+            decoder.feed(data)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        source.close()
+        if output is not sys.stdout:
+            output.close()
+
+    print(f'{decoder.frames} frames, {decoder.samples} samples, {decoder.lost_frames} lost, {decoder.corrupt_frames} corrupt, '
+          f'{decoder.text_bytes} bytes of text', file=sys.stderr)
+
+
+def capture(args):
+    source = open_source(args.source)
+    total = 0
+    with open(args.output, 'wb') as output:
+        try:
+            while True:
+                data = source.read(4096)
+                output.write(data)
+                total += len(data)
+        except KeyboardInterrupt:
+            pass
+    source.close()
+    print(f'{total} bytes captured', file=sys.stderr)
+
+
+def send(args):
+    """Sends a console command and prints the text log for a moment, it contains the reply."""
+    import serial
+    port = serial.Serial(args.port, timeout=0.1)
+    port.write(args.command.encode() + b'\n')
+
+    failed = False
+    lines = bytearray()
+
+    def on_text(text):
+        nonlocal failed
+        lines.extend(text.encode())
+        failed |= b'FAILED' in lines or b'[WARNING]' in lines
+        sys.stderr.write(text)
+
+    decoder = Decoder(lambda *sample: None, on_text)
+    end = time.monotonic() + args.wait
+    while time.monotonic() < end:
+        decoder.feed(port.read(4096))
+    port.close()
+
+    return 1 if failed else 0
+
+
+def text_line(sensor, unit, quality, timestamp_us, value):
+    """The line the text log writes for a sample, see logSensorSample() in Core.c."""
+    name = SENSORS[sensor].replace(' litre', '')
+    return f"[INFO] {name} changed! Value: '{value}' Unit: '{unit}' Quality: '0x{quality:02x}' Captured: '{timestamp_us} us'\n".encode()
+
+
+def benchmark(args):
+    # Samples like the car produces them: mostly rpm and speed, timestamps around an hour in
+    samples = []
+    for i in range(args.samples):
+        sensor = [6, 5, 6, 14, 7, 0, 1, 3][i % 8]
+        samples.append((sensor, [6, 5, 6, 1, 7, 1, 2, 4][i % 8], 0, 3_600_000_000 + i * 2500, (i * 37) % 7000))
+
+    text_bytes = sum(len(text_line(*sample)) for sample in samples)
+    print(f'{"samples/frame":>13} {"bytes/sample":>12} {"overhead":>9} {"vs text":>8} {"max samples/s":>14}')
+    for batch in (1, 2, 4, 8, MAX_SAMPLES_PER_FRAME):
+        wire = sum(len(encode_frame(i, samples[start:start + batch])) for i, start in enumerate(range(0, len(samples), batch)))
+        bare = len(samples) * SAMPLE.size
+        print(f'{batch:>13} {wire / len(samples):>12.2f} {(wire - bare) * 100 / bare:>8.1f}% {wire * 100 / text_bytes:>7.1f}% '
+              f'{args.link_bytes_per_s * len(samples) / wire:>14.0f}')
+    print(f'text log: {text_bytes / len(samples):.2f} bytes/sample, {args.link_bytes_per_s * len(samples) / text_bytes:.0f} samples/s')
+
+    # How fast this decoder keeps up, it has to be faster than the link
+    stream = b''.join(encode_frame(i, samples[start:start + MAX_SAMPLES_PER_FRAME])
+                      for i, start in enumerate(range(0, len(samples), MAX_SAMPLES_PER_FRAME)))
+    decoder = Decoder(lambda *sample: None, lambda text: None)
+    start = time.perf_counter()
+    decoder.feed(stream)
+    elapsed = time.perf_counter() - start
+    print(f'decoder: {decoder.samples / elapsed:.0f} samples/s, {len(stream) / elapsed / 1000:.0f} kB/s')
+
+    # A recorded stream
+    if args.capture:
+        timestamps = []
+        decoder = Decoder(lambda sequence, sensor, unit, quality, timestamp_us, value: timestamps.append(timestamp_us), lambda text: None)
+        with open(args.capture, 'rb') as source:
+            data = source.read()
+        decoder.feed(data)
+        span_s = (max(timestamps) - min(timestamps)) / 1e6 if len(timestamps) > 1 else 0
+        rate = f', {decoder.samples / span_s:.0f} samples/s, {decoder.frame_bytes / span_s:.0f} B/s' if span_s > 0 else ''
+        print(f'capture: {decoder.frames} frames, {decoder.samples} samples, {decoder.frame_bytes / max(decoder.samples, 1):.2f} bytes/sample, '
+              f'{decoder.text_bytes} bytes of text, {decoder.lost_frames} lost, {decoder.corrupt_frames} corrupt{rate}')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest='command', required=True)
+
+    command = commands.add_parser('decode', help='decode a port or a capture file to CSV')
+    command.add_argument('source')
+    command.add_argument('-o', '--output', help='CSV file, stdout by default')
+    command.add_argument('-q', '--quiet', action='store_true', help='drop the text log instead of printing it to stderr')
+    command.set_defaults(function=decode)
+
+    command = commands.add_parser('capture', help='record the raw stream of a port')
+    command.add_argument('source')
+    command.add_argument('-o', '--output', required=True)
+    command.set_defaults(function=capture)
+
+    command = commands.add_parser('benchmark', help='bytes per sample, overhead and decoder speed')
+    command.add_argument('--samples', type=int, default=16000)
+    command.add_argument('--link-bytes-per-s', type=int, default=500_000, help='usable throughput of the USB-Serial-JTAG port')
+    command.add_argument('--capture', help='also measure a recorded stream')
+    command.set_defaults(function=benchmark)
+
+    command = commands.add_parser('send', help='send a console command, e.g. to retune a setting')
+    command.add_argument('port')
+    command.add_argument('command', help='name=value, "save name=value", reload, erase, "trim <analog input> <gain> <offset mV>" or test')
+    command.add_argument('--wait', type=float, default=1.0, help='how long the reply is printed [s]')
+    command.set_defaults(function=send)
+
+    args = parser.parse_args()
+    sys.exit(args.function(args))
+
+
+if __name__ == '__main__':
+    main()